@@ -0,0 +1,43 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Source : register(t0, space0);
+SamplerState LinearSampler : register(s0, space0);
+
+RWTexture2D<float4> Destination : register(u0, space1);
+
+struct BloomBuffer
+{
+	float threshold; // unused by blur
+	float knee;      // unused by blur
+	float2 direction;
+};
+
+ConstantBuffer<BloomBuffer> ubo : register(b0, space2);
+
+// 9 tap gaussian using 5 bilinear taps
+static const float OFFSETS[3] = { 0.0f, 1.3846153846f, 3.2307692308f };
+static const float WEIGHTS[3] = { 0.2270270270f, 0.3162162162f, 0.0702702703f };
+
+// Separable blur in ubo.direction.
+// Destination can be smaller than source, which merges downsample in to the blur pass.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint dst_w, dst_h;
+	Destination.GetDimensions(dst_w, dst_h);
+	if (id.x >= dst_w || id.y >= dst_h)
+		return;
+
+	float2 dst_texel = 1.0f / float2(dst_w, dst_h);
+	float2 uv = (float2(id.xy) + 0.5f) * dst_texel;
+	float2 step = ubo.direction * dst_texel;
+
+	float3 color = Source.SampleLevel(LinearSampler, uv, 0).rgb * WEIGHTS[0];
+	[unroll]
+	for (int i = 1; i < 3; ++i)
+	{
+		color += Source.SampleLevel(LinearSampler, uv + step * OFFSETS[i], 0).rgb * WEIGHTS[i];
+		color += Source.SampleLevel(LinearSampler, uv - step * OFFSETS[i], 0).rgb * WEIGHTS[i];
+	}
+
+	Destination[id.xy] = float4(color, 1.0f);
+}
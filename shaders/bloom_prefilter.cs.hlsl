@@ -0,0 +1,49 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Source : register(t0, space0);
+SamplerState LinearSampler : register(s0, space0);
+
+RWTexture2D<float4> Destination : register(u0, space1);
+
+struct BloomBuffer
+{
+	float threshold;
+	float knee;
+	float2 direction; // unused by prefilter
+};
+
+ConstantBuffer<BloomBuffer> ubo : register(b0, space2);
+
+// Keep only what is brighter than threshold, with soft knee so there is no hard edge
+float3 prefilter(float3 color)
+{
+	float brightness = max(color.r, max(color.g, color.b));
+	float soft = clamp(brightness - ubo.threshold + ubo.knee, 0.0f, 2.0f * ubo.knee);
+	soft = (soft * soft) / (4.0f * ubo.knee + 1e-5f);
+
+	float contribution = max(soft, brightness - ubo.threshold) / max(brightness, 1e-5f);
+	return color * contribution;
+}
+
+// Threshold and downsample to half resolution in one pass.
+// 4 bilinear taps cover 4x4 source texels.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint dst_w, dst_h;
+	Destination.GetDimensions(dst_w, dst_h);
+	if (id.x >= dst_w || id.y >= dst_h)
+		return;
+
+	uint src_w, src_h;
+	Source.GetDimensions(src_w, src_h);
+
+	float2 src_texel = 1.0f / float2(src_w, src_h);
+	float2 uv = (float2(id.xy) + 0.5f) / float2(dst_w, dst_h);
+
+	float3 color = Source.SampleLevel(LinearSampler, uv + src_texel * float2(-1.0f, -1.0f), 0).rgb;
+	color += Source.SampleLevel(LinearSampler, uv + src_texel * float2(+1.0f, -1.0f), 0).rgb;
+	color += Source.SampleLevel(LinearSampler, uv + src_texel * float2(-1.0f, +1.0f), 0).rgb;
+	color += Source.SampleLevel(LinearSampler, uv + src_texel * float2(+1.0f, +1.0f), 0).rgb;
+
+	Destination[id.xy] = float4(prefilter(color * 0.25f), 1.0f);
+}
@@ -0,0 +1,33 @@
+// Fragment shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+Texture2D<float> Depth : register(t0, space2);
+SamplerState DepthSampler : register(s0, space2);
+
+struct Input
+{
+	float2 TexCoord : TEXCOORD0;
+};
+
+struct ReprojectionBuffer
+{
+	float4x4 reprojection; // this frame's clip space to last frame's, without jitter
+	float2 jitter_uv;      // this frame's sample offset, in UV units
+	float2 padding;
+};
+
+ConstantBuffer<ReprojectionBuffer> ubo : register(b0, space3);
+
+// Motion since last frame from camera alone, in UV units, last frame's position is uv - motion.
+// Exact for everything that didn't move, moving objects overwrite it afterwards.
+float4 main(Input input) : SV_Target0
+{
+	float depth = Depth.SampleLevel(DepthSampler, input.TexCoord, 0);
+
+	// Where this pixel's sample sits without jitter
+	float2 uv = input.TexCoord + ubo.jitter_uv;
+	float4 clip = float4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, depth, 1.0f);
+
+	float4 previous = mul(ubo.reprojection, clip);
+	float2 previous_uv = float2(previous.x / previous.w * 0.5f + 0.5f, 0.5f - previous.y / previous.w * 0.5f);
+
+	return float4(uv - previous_uv, 0.0f, 0.0f);
+}
@@ -0,0 +1,31 @@
+struct Input
+{
+	// Position is using TEXCOORD semantic because of rules imposed by SDL
+	// Per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+	float3 Position : TEXCOORD0;
+	float4 Color : TEXCOORD1;
+};
+
+struct Output
+{
+	float4 Color : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+struct FrameBuffer
+{
+	float4x4 projection;
+	float4x4 view;
+};
+
+ConstantBuffer<FrameBuffer> ubo : register(b0, space1);
+
+// Debug lines are already in world space
+Output main(Input input)
+{
+	Output output;
+	output.Color = input.Color;
+	output.Position = mul(ubo.projection, mul(ubo.view, float4(input.Position, 1.0f)));
+
+	return output;
+}
@@ -0,0 +1,4 @@
+// Depth prepass has no color output, only depth is written by fixed function hardware
+void main()
+{
+}
@@ -0,0 +1,32 @@
+struct Input
+{
+	// Position is using TEXCOORD semantic because of rules imposed by SDL
+	// Per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+	float3 Position : TEXCOORD0;
+	float4x4 Transform : TEXCOORD1;
+};
+
+struct Output
+{
+	float4 Position : SV_Position;
+};
+
+struct FrameBuffer
+{
+	float4x4 projection;
+	float4x4 view;
+};
+
+ConstantBuffer<FrameBuffer> ubo : register(b0, space1);
+
+Output main(Input input)
+{
+	Output output;
+
+	// Must match instanced_mesh.vs.hlsl exactly, main pass uses EQUAL depth test against this result
+	float4 pos = float4(input.Position, 1.0f);
+	precise float4 clip_pos = mul(ubo.projection, mul(ubo.view, mul(input.Transform, pos)));
+	output.Position = clip_pos;
+
+	return output;
+}
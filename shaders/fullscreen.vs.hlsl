@@ -0,0 +1,23 @@
+struct Input
+{
+	uint VertexIndex : SV_VertexID;
+};
+
+struct Output
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+// Single triangle covering whole screen, no vertex buffer needed
+// Draw with 3 vertices, 1 instance
+Output main(Input input)
+{
+	float2 uv = float2((input.VertexIndex << 1) & 2, input.VertexIndex & 2);
+
+	Output output;
+	output.TexCoord = uv;
+	output.Position = float4(uv * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+
+	return output;
+}
@@ -0,0 +1,133 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Source : register(t0, space0);
+SamplerState LinearSampler : register(s0, space0);
+
+RWTexture2D<unorm float4> Output : register(u0, space1);
+
+struct AntialiasBuffer
+{
+	float fxaa_edge_threshold;     // local contrast, relative to brightest neighbour, that counts as an edge
+	float fxaa_edge_threshold_min; // contrast below this is never an edge, keeps darks untouched
+	float fxaa_subpixel;           // 0 = off, 1 = softest
+	float smaa_threshold;          // unused by FXAA
+};
+
+ConstantBuffer<AntialiasBuffer> ubo : register(b0, space2);
+
+// Step sizes, in pixels, searching along an edge for it's ends
+static const uint SEARCH_STEPS = 12;
+static const float SEARCH_STEP_SIZE[SEARCH_STEPS] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.5f, 2.0f, 2.0f, 2.0f, 2.0f, 4.0f, 8.0f };
+
+float luma(float3 color)
+{
+	return dot(color, float3(0.299f, 0.587f, 0.114f));
+}
+
+float luma_at(float2 uv)
+{
+	return luma(Source.SampleLevel(LinearSampler, uv, 0).rgb);
+}
+
+// FXAA 3.11 quality preset, after Timothy Lottes.
+// Finds edge direction from luma, searches along it for it's ends,
+// and resamples pixel shifted across edge by how close it is to nearest end.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint w, h;
+	Output.GetDimensions(w, h);
+	if (id.x >= w || id.y >= h)
+		return;
+
+	float2 texel = 1.0f / float2(w, h);
+	float2 uv = (float2(id.xy) + 0.5f) * texel;
+
+	float3 color = Source.SampleLevel(LinearSampler, uv, 0).rgb;
+	float luma_m = luma(color);
+	float luma_n = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(0, -1)).rgb);
+	float luma_s = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(0, 1)).rgb);
+	float luma_w = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(-1, 0)).rgb);
+	float luma_e = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(1, 0)).rgb);
+
+	float range_max = max(luma_m, max(max(luma_n, luma_s), max(luma_w, luma_e)));
+	float range_min = min(luma_m, min(min(luma_n, luma_s), min(luma_w, luma_e)));
+	float range = range_max - range_min;
+
+	// Flat area, most pixels leave here
+	if (range < max(ubo.fxaa_edge_threshold_min, range_max * ubo.fxaa_edge_threshold))
+	{
+		Output[id.xy] = float4(color, 1.0f);
+		return;
+	}
+
+	float luma_nw = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(-1, -1)).rgb);
+	float luma_ne = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(1, -1)).rgb);
+	float luma_sw = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(-1, 1)).rgb);
+	float luma_se = luma(Source.SampleLevel(LinearSampler, uv, 0, int2(1, 1)).rgb);
+
+	// Sub-pixel aliasing, from how much pixel differs from it's neighbourhood
+	float luma_average = (2.0f * (luma_n + luma_s + luma_w + luma_e) + luma_nw + luma_ne + luma_sw + luma_se) / 12.0f;
+	float subpixel = smoothstep(0.0f, 1.0f, saturate(abs(luma_average - luma_m) / range));
+	subpixel = subpixel * subpixel * ubo.fxaa_subpixel;
+
+	// Edge orientation
+	float edge_h = abs(luma_nw + luma_sw - 2.0f * luma_w) + 2.0f * abs(luma_n + luma_s - 2.0f * luma_m) + abs(luma_ne + luma_se - 2.0f * luma_e);
+	float edge_v = abs(luma_nw + luma_ne - 2.0f * luma_n) + 2.0f * abs(luma_w + luma_e - 2.0f * luma_m) + abs(luma_sw + luma_se - 2.0f * luma_s);
+	bool horizontal = edge_h >= edge_v;
+
+	// Side of pixel edge is on, steepest gradient
+	float luma_1 = horizontal ? luma_n : luma_w;
+	float luma_2 = horizontal ? luma_s : luma_e;
+	float gradient_1 = abs(luma_1 - luma_m);
+	float gradient_2 = abs(luma_2 - luma_m);
+	bool side_1 = gradient_1 >= gradient_2;
+
+	float gradient_scaled = 0.25f * max(gradient_1, gradient_2);
+	float step_length = horizontal ? texel.y : texel.x;
+	float luma_local = 0.5f * ((side_1 ? luma_1 : luma_2) + luma_m);
+	if (side_1)
+		step_length = -step_length;
+
+	// Start half a pixel across, on edge itself
+	float2 edge_uv = uv + (horizontal ? float2(0.0f, 0.5f * step_length) : float2(0.5f * step_length, 0.0f));
+	float2 along = horizontal ? float2(texel.x, 0.0f) : float2(0.0f, texel.y);
+
+	float2 uv_1 = edge_uv - along;
+	float2 uv_2 = edge_uv + along;
+	float end_1 = luma_at(uv_1) - luma_local;
+	float end_2 = luma_at(uv_2) - luma_local;
+	bool done_1 = abs(end_1) >= gradient_scaled;
+	bool done_2 = abs(end_2) >= gradient_scaled;
+
+	[loop]
+	for (uint i = 1; i < SEARCH_STEPS && !(done_1 && done_2); ++i)
+	{
+		if (!done_1)
+		{
+			uv_1 -= along * SEARCH_STEP_SIZE[i];
+			end_1 = luma_at(uv_1) - luma_local;
+			done_1 = abs(end_1) >= gradient_scaled;
+		}
+		if (!done_2)
+		{
+			uv_2 += along * SEARCH_STEP_SIZE[i];
+			end_2 = luma_at(uv_2) - luma_local;
+			done_2 = abs(end_2) >= gradient_scaled;
+		}
+	}
+
+	float distance_1 = horizontal ? (uv.x - uv_1.x) : (uv.y - uv_1.y);
+	float distance_2 = horizontal ? (uv_2.x - uv.x) : (uv_2.y - uv.y);
+	bool closer_1 = distance_1 < distance_2;
+	float edge_length = distance_1 + distance_2;
+	float pixel_offset = 0.5f - min(distance_1, distance_2) / edge_length;
+
+	// Only shift if nearest end's luma varies the same way as centre, otherwise pixel is on far side of that end
+	bool center_darker = luma_m < luma_local;
+	bool shift = ((closer_1 ? end_1 : end_2) < 0.0f) != center_darker;
+
+	float offset = max(shift ? pixel_offset : 0.0f, subpixel);
+	float2 final_uv = uv + (horizontal ? float2(0.0f, offset * step_length) : float2(offset * step_length, 0.0f));
+
+	Output[id.xy] = float4(Source.SampleLevel(LinearSampler, final_uv, 0).rgb, 1.0f);
+}
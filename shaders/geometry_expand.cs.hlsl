@@ -0,0 +1,63 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+ByteAddressBuffer Packed : register(t0, space0); // quantized levels, as they're stored in archive
+
+RWByteAddressBuffer Vertices : register(u0, space1); // geometry vertex pool, float3 position and float2 uv
+RWByteAddressBuffer Indices : register(u1, space1);  // geometry index pool, 32 bit
+
+// Offsets are in bytes
+struct ExpandBuffer
+{
+	float3 pos_min;
+	uint packed_vertices;
+	float3 pos_extent;
+	uint packed_indices;
+	float2 uv_min;
+	float2 uv_extent;
+	uint vertices;
+	uint indices;
+	uint vertex_count;
+	uint index_count;
+};
+
+ConstantBuffer<ExpandBuffer> ubo : register(b0, space2);
+
+static const uint VERTEX_STRIDE = 20;
+static const uint PACKED_STRIDE = 12; // x y | z u | v, 16 bits each
+
+float2 unorm16x2(uint value)
+{
+	return float2(value & 0xFFFF, value >> 16) / 65535.0f;
+}
+
+// One level, each thread expands one vertex and one pair of indices
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint i = id.x;
+
+	if (i < ubo.vertex_count)
+	{
+		uint3 packed = Packed.Load3(ubo.packed_vertices + i * PACKED_STRIDE);
+		float2 xy = unorm16x2(packed.x);
+		float2 zu = unorm16x2(packed.y);
+		float2 v_pad = unorm16x2(packed.z);
+
+		float3 pos = ubo.pos_min + float3(xy, zu.x) * ubo.pos_extent;
+		float2 uv = ubo.uv_min + float2(zu.y, v_pad.x) * ubo.uv_extent;
+
+		uint dst = ubo.vertices + i * VERTEX_STRIDE;
+		Vertices.Store3(dst, asuint(pos));
+		Vertices.Store2(dst + 12, asuint(uv));
+	}
+
+	if (i * 2 < ubo.index_count)
+	{
+		uint pair = Packed.Load(ubo.packed_indices + i * 4);
+		uint dst = ubo.indices + i * 8;
+		Indices.Store(dst, pair & 0xFFFF);
+
+		// Odd count's last word has padding in it's high half
+		if (i * 2 + 1 < ubo.index_count)
+			Indices.Store(dst + 4, pair >> 16);
+	}
+}
@@ -1,3 +1,4 @@
+#include "precision.hlsli"
 
 struct Input
 {
@@ -19,7 +20,8 @@ struct FrameBuffer
 
 ConstantBuffer<FrameBuffer> ubo : register(b0, space3);
 
-float4 grid(float3 pos, float scale)
+// Line coverage needs world position and it's derivatives in float, only color is real
+real4 grid(float3 pos, float scale)
 {
 	float2 coord = pos.xz * scale;
 	float2 derivative = fwidth(coord);
@@ -29,7 +31,7 @@ float4 grid(float3 pos, float scale)
 	float min_z = min(derivative.y, 1);
 	float min_x = min(derivative.x, 1);
 
-	float4 color = float4(0.2, 0.2, 0.2, 1.0 - min(line_, 1.0));
+	real4 color = real4(0.2, 0.2, 0.2, real(1.0 - min(line_, 1.0)));
 
 	if (pos.x > -0.1 * min_x && pos.x < 0.1 * min_x)
 	{
@@ -56,7 +58,7 @@ Output main(Input input)
 
 	float3 pos = input.NearPoint.xyz + t * (input.FarPoint.xyz - input.NearPoint.xyz);
 
-	float4 outColor = grid(pos, 10) * float(t > 0);
+	real4 outColor = grid(pos, 10) * real(t > 0);
 	float depth = compute_depth(pos);
 
 	Output output;
@@ -26,8 +26,10 @@ Output main(Input input)
 	Output output;
 	output.TexCoord = input.TexCoord;
 
+	// Must match depth_only.vs.hlsl exactly, so EQUAL depth test passes after depth prepass
 	float4 pos = float4(input.Position, 1.0f);
-	output.Position = mul(ubo.projection, mul(ubo.view, mul(input.Transform, pos)));
+	precise float4 clip_pos = mul(ubo.projection, mul(ubo.view, mul(input.Transform, pos)));
+	output.Position = clip_pos;
 
 	return output;
 }
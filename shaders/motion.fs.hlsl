@@ -0,0 +1,17 @@
+struct Input
+{
+	float4 Current : TEXCOORD0;
+	float4 Previous : TEXCOORD1;
+};
+
+float2 to_uv(float4 clip)
+{
+	float2 ndc = clip.xy / clip.w;
+	return float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f);
+}
+
+// Motion since last frame, in UV units, last frame's position is uv - motion
+float4 main(Input input) : SV_Target0
+{
+	return float4(to_uv(input.Current) - to_uv(input.Previous), 0.0f, 0.0f);
+}
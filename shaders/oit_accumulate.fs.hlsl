@@ -0,0 +1,44 @@
+// space2 is because of reason explained in https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+Texture2D<float4> Texture : register(t0, space2);
+SamplerState Sampler : register(s0, space2);
+
+struct Input
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+struct Output
+{
+	float4 accumulation : SV_Target0; // blended with ONE, ONE
+	float revealage : SV_Target1;     // blended with ZERO, ONE_MINUS_SRC_COLOR
+};
+
+struct MaterialBuffer
+{
+	float4 tint;
+};
+
+// space3 is for fragment uniform buffers
+ConstantBuffer<MaterialBuffer> material : register(b0, space3);
+
+// Weighted Blended Order-Independent Transparency, McGuire and Bavoil 2013
+// Weight favours opaque-ish and near fragments, clamped so 16 bit float target doesn't overflow
+float weight(float depth, float alpha)
+{
+	float a = min(1.0f, alpha * 10.0f) + 0.01f;
+	float d = 1.0f - depth * 0.9f;
+	return clamp(a * a * a * 1e8f * d * d * d, 1e-2f, 3e3f);
+}
+
+Output main(Input input)
+{
+	float4 color = Texture.Sample(Sampler, input.TexCoord) * material.tint;
+	float w = weight(input.Position.z, color.a);
+
+	Output output;
+	output.accumulation = float4(color.rgb * color.a, color.a) * w;
+	output.revealage = color.a;
+
+	return output;
+}
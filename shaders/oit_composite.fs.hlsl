@@ -0,0 +1,28 @@
+// space2 is because of reason explained in https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+Texture2D<float4> Accumulation : register(t0, space2);
+Texture2D<float> Revealage : register(t1, space2);
+SamplerState AccumulationSampler : register(s0, space2);
+SamplerState RevealageSampler : register(s1, space2);
+
+struct Input
+{
+	float2 TexCoord : TEXCOORD0;
+};
+
+// Resolves weighted blended transparency on top of opaque result
+// Blended with SRC_ALPHA, ONE_MINUS_SRC_ALPHA, so revealage is how much of opaque shows through
+float4 main(Input input) : SV_Target0
+{
+	float revealage = Revealage.Sample(RevealageSampler, input.TexCoord);
+	float4 accumulation = Accumulation.Sample(AccumulationSampler, input.TexCoord);
+
+	// Keep in range of 16 bit float
+	if (isinf(accumulation.a))
+	{
+		accumulation.rgb = accumulation.aaa;
+	}
+
+	float3 average_color = accumulation.rgb / max(accumulation.a, 1e-5f);
+
+	return float4(average_color, 1.0f - revealage);
+}
@@ -0,0 +1,46 @@
+struct Input
+{
+	// Position is using TEXCOORD semantic because of rules imposed by SDL
+	// Per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+	float3 Position : TEXCOORD0;
+	float4 Color : TEXCOORD1;
+	uint draw_id : TEXCOORD2; // instance rate, read at first_instance, see sdl3::draw_ring
+};
+
+struct Output
+{
+	float4 Color : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+// Must match sdl3::draw_data
+struct DrawData
+{
+	float4x4 transform;
+	uint material;
+	uint lod;
+	uint2 padding;
+};
+
+// Vertex shader storage buffers per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+StructuredBuffer<DrawData> draws : register(t0, space0);
+
+static const uint MATERIAL_COUNT = 4;
+static const float4 MATERIAL_TINTS[MATERIAL_COUNT] = {
+	float4(1.0f, 1.0f, 1.0f, 1.0f),
+	float4(1.0f, 0.5f, 0.5f, 1.0f),
+	float4(0.5f, 1.0f, 0.5f, 1.0f),
+	float4(0.5f, 0.5f, 1.0f, 1.0f),
+};
+
+// Every shape is it's own draw, transform and material come from draw's constants
+Output main(Input input)
+{
+	DrawData draw = draws[input.draw_id];
+
+	Output output;
+	output.Color = input.Color * MATERIAL_TINTS[draw.material % MATERIAL_COUNT];
+	output.Position = mul(draw.transform, float4(input.Position, 1.0f));
+
+	return output;
+}
@@ -0,0 +1,13 @@
+// Color math types, 16 bit in shaders built with HALF_PRECISION=1 (see *_fp16 variants in CMakeLists.txt).
+// min16float is a minimum precision hint, driver runs it at 16 bits where hardware has them
+// and at 32 where it doesn't, so same binary is valid on every device.
+// Positions, UVs and depth stay float, 16 bits can't address texels or depth finely enough.
+#if HALF_PRECISION
+typedef min16float real;
+typedef min16float3 real3;
+typedef min16float4 real4;
+#else
+typedef float real;
+typedef float3 real3;
+typedef float4 real4;
+#endif
@@ -0,0 +1,40 @@
+#include "procedural_placement.hlsli"
+
+struct Input
+{
+	// Position is using TEXCOORD semantic because of rules imposed by SDL
+	// Per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+	float3 Position : TEXCOORD0;
+	float2 TexCoord : TEXCOORD1;
+	uint instance_id : SV_InstanceID;
+};
+
+struct Output
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+struct FrameBuffer
+{
+	float4x4 projection;
+	float4x4 view;
+};
+
+ConstantBuffer<FrameBuffer> ubo : register(b0, space1);
+ConstantBuffer<LayoutBuffer> params : register(b1, space1);
+
+// Placement is computed from instance id, there is no instance buffer
+Output main(Input input)
+{
+	float3 world = place_instance(params, input.instance_id, input.Position);
+
+	// precise, motion pass depth tests against this with same expression
+	precise float4 clip_pos = mul(ubo.projection, mul(ubo.view, float4(world, 1.0f)));
+
+	Output output;
+	output.TexCoord = input.TexCoord;
+	output.Position = clip_pos;
+
+	return output;
+}
@@ -0,0 +1,51 @@
+#include "procedural_placement.hlsli"
+
+struct Input
+{
+	// Position is using TEXCOORD semantic because of rules imposed by SDL
+	// Per https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+	float3 Position : TEXCOORD0;
+	float2 TexCoord : TEXCOORD1;
+	uint instance_id : SV_InstanceID;
+};
+
+struct Output
+{
+	float4 Current : TEXCOORD0;  // clip space, without jitter
+	float4 Previous : TEXCOORD1; // clip space, last frame, without jitter
+	float4 Position : SV_Position;
+};
+
+struct FrameBuffer
+{
+	float4x4 projection;
+	float4x4 view;
+};
+
+struct MotionBuffer
+{
+	float4x4 view_projection;
+	float4x4 previous_view_projection;
+};
+
+ConstantBuffer<FrameBuffer> ubo : register(b0, space1);
+ConstantBuffer<LayoutBuffer> params : register(b1, space1);
+ConstantBuffer<LayoutBuffer> previous_params : register(b2, space1);
+ConstantBuffer<MotionBuffer> motion : register(b3, space1);
+
+// Same instances as procedural_instance.vs.hlsl, placed at this and last frame's time
+Output main(Input input)
+{
+	float3 world = place_instance(params, input.instance_id, input.Position);
+	float3 previous_world = place_instance(previous_params, input.instance_id, input.Position);
+
+	// precise, depth must match procedural_instance.vs.hlsl for depth test to pass
+	precise float4 clip_pos = mul(ubo.projection, mul(ubo.view, float4(world, 1.0f)));
+
+	Output output;
+	output.Current = mul(motion.view_projection, float4(world, 1.0f));
+	output.Previous = mul(motion.previous_view_projection, float4(previous_world, 1.0f));
+	output.Position = clip_pos;
+
+	return output;
+}
@@ -0,0 +1,105 @@
+// Procedural instance placement, shared by procedural_instance.vs.hlsl and procedural_motion.vs.hlsl,
+// so motion pass places every instance exactly where it was drawn.
+
+// Must match sdl3::procedural_params
+struct LayoutBuffer
+{
+	uint layout;     // 0 grid, 1 ring, 2 scatter, 3 noise
+	uint count;
+	uint columns;    // grid and noise, instances per row
+	uint seed;
+	float3 origin;   // center of layout
+	float spacing;   // grid cell size, ring and scatter radius
+	float scale;     // instance size
+	float amplitude; // noise height
+	float time;      // seconds, animates noise
+	float padding;
+};
+
+static const float TWO_PI = 6.28318530718f;
+
+// PCG hash, https://www.jcgt.org/published/0009/03/02/
+uint pcg_hash(uint v)
+{
+	uint state = v * 747796405u + 2891336453u;
+	uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+	return (word >> 22u) ^ word;
+}
+
+// [0, 1) random number
+float random01(uint v)
+{
+	return float(pcg_hash(v) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Smooth value noise on integer lattice
+float value_noise(float2 p, uint seed)
+{
+	int2 i = int2(floor(p));
+	float2 f = frac(p);
+	float2 u = f * f * (3.0f - 2.0f * f);
+
+	float a = random01(uint(i.x) * 73856093u ^ uint(i.y) * 19349663u ^ seed);
+	float b = random01(uint(i.x + 1) * 73856093u ^ uint(i.y) * 19349663u ^ seed);
+	float c = random01(uint(i.x) * 73856093u ^ uint(i.y + 1) * 19349663u ^ seed);
+	float d = random01(uint(i.x + 1) * 73856093u ^ uint(i.y + 1) * 19349663u ^ seed);
+
+	return lerp(lerp(a, b, u.x), lerp(c, d, u.x), u.y);
+}
+
+// Centered grid cell of instance, on XZ plane
+float2 grid_position(LayoutBuffer params, uint id)
+{
+	uint columns = max(params.columns, 1u);
+	uint rows = (params.count + columns - 1) / columns;
+	float2 cell = float2(id % columns, id / columns);
+
+	return (cell - float2(columns - 1, rows - 1) * 0.5f) * params.spacing;
+}
+
+float3x3 rotate_y(float angle)
+{
+	float s, c;
+	sincos(angle, s, c);
+	return float3x3(c, 0, s,
+	                0, 1, 0,
+	                -s, 0, c);
+}
+
+// World position of mesh vertex, for instance id, there is no instance buffer
+float3 place_instance(LayoutBuffer params, uint id, float3 position)
+{
+	float scale = params.scale;
+	float yaw = 0.0f;
+	float3 offset = 0.0f;
+
+	switch (params.layout)
+	{
+	case 0: // grid
+		offset.xz = grid_position(params, id);
+		break;
+	case 1: // ring, facing center
+		yaw = float(id) / float(max(params.count, 1u)) * TWO_PI;
+		offset.xz = float2(cos(yaw), sin(yaw)) * params.spacing;
+		break;
+	case 2: // scatter, uniform over disc, random yaw and size
+	{
+		float r = sqrt(random01(id * 3u + params.seed)) * params.spacing;
+		float a = random01(id * 3u + 1u + params.seed) * TWO_PI;
+		offset.xz = float2(cos(a), sin(a)) * r;
+		yaw = random01(id * 3u + 2u + params.seed) * TWO_PI;
+		scale *= lerp(0.5f, 1.5f, random01(id ^ params.seed));
+		break;
+	}
+	default: // noise, grid displaced and scaled by animated value noise
+	{
+		offset.xz = grid_position(params, id);
+		float n = value_noise(offset.xz * 0.5f + params.time * 0.25f, params.seed);
+		offset.y = n * params.amplitude;
+		scale *= lerp(0.25f, 1.0f, n);
+		break;
+	}
+	}
+
+	return params.origin + offset + mul(rotate_y(yaw), position * scale);
+}
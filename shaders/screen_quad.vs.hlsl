@@ -0,0 +1,42 @@
+struct Input
+{
+	// Per instance quad, there is no per vertex stream
+	float4 Rect : TEXCOORD0;   // x, y, width, height in pixels, origin at top-left
+	float4 UVRect : TEXCOORD1; // u0, v0, u1, v1
+	float4 Color : TEXCOORD2;
+	uint vertex_id : SV_VertexID;
+};
+
+struct Output
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Color : TEXCOORD1;
+	float4 Position : SV_Position;
+};
+
+struct ScreenBuffer
+{
+	float2 size;
+	float2 padding;
+};
+
+ConstantBuffer<ScreenBuffer> screen : register(b0, space1);
+
+// Two triangles per quad
+static const float2 corners[6] = {
+	float2(0.0f, 0.0f), float2(1.0f, 0.0f), float2(0.0f, 1.0f),
+	float2(0.0f, 1.0f), float2(1.0f, 0.0f), float2(1.0f, 1.0f),
+};
+
+Output main(Input input)
+{
+	float2 corner = corners[input.vertex_id];
+	float2 pixel = input.Rect.xy + corner * input.Rect.zw;
+
+	Output output;
+	output.TexCoord = lerp(input.UVRect.xy, input.UVRect.zw, corner);
+	output.Color = input.Color;
+	output.Position = float4((pixel / screen.size) * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+
+	return output;
+}
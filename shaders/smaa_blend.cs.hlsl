@@ -0,0 +1,128 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Source : register(t0, space0);
+Texture2D<float4> Edges : register(t1, space0);
+SamplerState SourceSampler : register(s0, space0);
+SamplerState EdgesSampler : register(s1, space0);
+
+RWTexture2D<unorm float4> Output : register(u0, space1);
+
+// Pixels searched along an edge line, each way
+static const int MAX_SEARCH = 8;
+
+uint2 image_size()
+{
+	uint w, h;
+	Output.GetDimensions(w, h);
+	return uint2(w, h);
+}
+
+// Edge flags of pixel, none outside image
+float2 edges_at(int2 pixel)
+{
+	if (any(pixel < 0) || any(pixel >= int2(image_size())))
+		return float2(0.0f, 0.0f);
+	return Edges.Load(int3(pixel, 0)).rg;
+}
+
+float3 color_at(int2 pixel)
+{
+	float2 uv = (float2(pixel) + 0.5f) / float2(image_size());
+	return Source.SampleLevel(SourceSampler, uv, 0).rgb;
+}
+
+// Pixels edge line continues past start, in direction
+int search(int2 start, int2 direction, uint channel)
+{
+	int count = 0;
+	[loop]
+	for (int i = 1; i <= MAX_SEARCH; ++i)
+	{
+		if (edges_at(start + direction * i)[channel] < 0.5f)
+			break;
+		count = i;
+	}
+	return count;
+}
+
+// Height of antialiased silhouette at one end of edge line, from edge that crosses it there.
+// +0.5 crossing on pixel's side of line, -0.5 on far side, 0 no crossing or both.
+float end_height(int2 end, int2 across, uint cross_channel, bool near_side)
+{
+	bool crosses_near = edges_at(end)[cross_channel] > 0.5f;
+	bool crosses_far = edges_at(end - across)[cross_channel] > 0.5f;
+	if (crosses_near == crosses_far)
+		return 0.0f;
+	return (crosses_near == near_side) ? 0.5f : -0.5f;
+}
+
+// Coverage of pixel by colour on far side of edge line, edge flags stored in line_pixel.
+// Line runs along 'along', 'across' points from far side to the line_pixel side.
+// Silhouette is reconstructed MLAA style, as a ramp from each end's height to zero at middle of line,
+// so Z, L and U shapes all come out of the same expression, without SMAA's precomputed area texture.
+float edge_weight(int2 line_pixel, int2 along, int2 across, uint channel, bool near_side)
+{
+	uint cross_channel = 1 - channel;
+
+	int before = search(line_pixel, -along, channel);
+	int after = search(line_pixel, along, channel);
+
+	float height_before = end_height(line_pixel - along * before, across, cross_channel, near_side);
+	float height_after = end_height(line_pixel + along * (after + 1), across, cross_channel, near_side);
+
+	float line_length = float(before + after + 1);
+	float position = (float(before) + 0.5f) / line_length;
+
+	float height = (position < 0.5f) ? height_before * (1.0f - 2.0f * position)
+	                                 : height_after * (2.0f * position - 1.0f);
+	return max(height, 0.0f);
+}
+
+// SMAA style blend, edge search and coverage merged in to one pass.
+// Each pixel blends with it's neighbour across whichever edge covers it most.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint2 size = image_size();
+	if (id.x >= size.x || id.y >= size.y)
+		return;
+
+	int2 pixel = int2(id.xy);
+	float3 color = color_at(pixel);
+
+	float2 here = edges_at(pixel);
+	float right = edges_at(pixel + int2(1, 0)).r;
+	float bottom = edges_at(pixel + int2(0, 1)).g;
+
+	if (here.r + here.g + right + bottom == 0.0f)
+	{
+		Output[id.xy] = float4(color, 1.0f);
+		return;
+	}
+
+	// r channel holds left edges, lines run vertically; g channel holds top edges, lines run horizontally
+	float4 weights = float4(0.0f, 0.0f, 0.0f, 0.0f); // left, top, right, bottom
+	if (here.r > 0.5f)
+		weights.x = edge_weight(pixel, int2(0, 1), int2(1, 0), 0, true);
+	if (here.g > 0.5f)
+		weights.y = edge_weight(pixel, int2(1, 0), int2(0, 1), 1, true);
+	if (right > 0.5f)
+		weights.z = edge_weight(pixel + int2(1, 0), int2(0, 1), int2(1, 0), 0, false);
+	if (bottom > 0.5f)
+		weights.w = edge_weight(pixel + int2(0, 1), int2(1, 0), int2(0, 1), 1, false);
+
+	static const int2 NEIGHBOURS[4] = { int2(-1, 0), int2(0, -1), int2(1, 0), int2(0, 1) };
+
+	float weight = 0.0f;
+	int2 neighbour = int2(0, 0);
+	[unroll]
+	for (int i = 0; i < 4; ++i)
+	{
+		if (weights[i] > weight)
+		{
+			weight = weights[i];
+			neighbour = NEIGHBOURS[i];
+		}
+	}
+
+	Output[id.xy] = float4(lerp(color, color_at(pixel + neighbour), weight), 1.0f);
+}
@@ -0,0 +1,69 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Source : register(t0, space0);
+SamplerState LinearSampler : register(s0, space0);
+
+RWTexture2D<unorm float4> Edges : register(u0, space1);
+
+struct AntialiasBuffer
+{
+	float fxaa_edge_threshold;     // unused by SMAA
+	float fxaa_edge_threshold_min; // unused by SMAA
+	float fxaa_subpixel;           // unused by SMAA
+	float smaa_threshold;          // luma step that counts as an edge
+};
+
+ConstantBuffer<AntialiasBuffer> ubo : register(b0, space2);
+
+// Edge is dropped when a neighbouring step is this much stronger, it's a texture detail next to a real edge
+static const float LOCAL_CONTRAST_FACTOR = 2.0f;
+
+float luma_at(int2 pixel, int2 offset)
+{
+	uint w, h;
+	Edges.GetDimensions(w, h);
+	float2 uv = (float2(pixel + offset) + 0.5f) / float2(w, h);
+	return dot(Source.SampleLevel(LinearSampler, uv, 0).rgb, float3(0.299f, 0.587f, 0.114f));
+}
+
+// SMAA luma edge detection, after Jimenez et al.
+// r = edge on left side of pixel, g = edge on top side.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint w, h;
+	Edges.GetDimensions(w, h);
+	if (id.x >= w || id.y >= h)
+		return;
+
+	int2 pixel = int2(id.xy);
+
+	float luma_m = luma_at(pixel, int2(0, 0));
+	float luma_left = luma_at(pixel, int2(-1, 0));
+	float luma_top = luma_at(pixel, int2(0, -1));
+
+	float2 delta = abs(luma_m - float2(luma_left, luma_top));
+	float2 edges = step(ubo.smaa_threshold, delta);
+
+	// No image border edges, clamped sampling repeats border pixel
+	edges *= float2(pixel.x > 0 ? 1.0f : 0.0f, pixel.y > 0 ? 1.0f : 0.0f);
+
+	if (dot(edges, float2(1.0f, 1.0f)) == 0.0f)
+	{
+		Edges[id.xy] = float4(0.0f, 0.0f, 0.0f, 0.0f);
+		return;
+	}
+
+	// Local contrast adaptation
+	float luma_right = luma_at(pixel, int2(1, 0));
+	float luma_bottom = luma_at(pixel, int2(0, 1));
+	float luma_left_left = luma_at(pixel, int2(-2, 0));
+	float luma_top_top = luma_at(pixel, int2(0, -2));
+
+	float max_delta = max(max(delta.x, delta.y),
+	                      max(abs(luma_m - luma_right), abs(luma_m - luma_bottom)));
+	max_delta = max(max_delta, max(abs(luma_left - luma_left_left), abs(luma_top - luma_top_top)));
+
+	edges *= step(max_delta, LOCAL_CONTRAST_FACTOR * delta);
+
+	Edges[id.xy] = float4(edges, 0.0f, 0.0f);
+}
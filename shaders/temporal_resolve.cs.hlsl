@@ -0,0 +1,166 @@
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Scene : register(t0, space0);   // scene size, jittered
+Texture2D<float4> Motion : register(t1, space0);  // scene size, UV units
+Texture2D<float4> History : register(t2, space0); // output size, last frame's result
+SamplerState SceneSampler : register(s0, space0);
+SamplerState MotionSampler : register(s1, space0);
+SamplerState HistorySampler : register(s2, space0);
+
+RWTexture2D<float4> Output : register(u0, space1);
+
+struct TemporalBuffer
+{
+	float2 jitter;        // this frame's sample offset from pixel centre, in scene pixels
+	float current_weight; // share of new frame in result, where a sample lands on output pixel
+	uint history_valid;   // 0 on first frame and after camera cuts
+};
+
+ConstantBuffer<TemporalBuffer> ubo : register(b0, space2);
+
+// Neighbourhood box is this many standard deviations each way
+static const float CLIP_GAMMA = 1.25f;
+
+// Accumulate in tonemapped space so single bright samples don't flicker, after Karis
+float3 compress(float3 color)
+{
+	return color / (1.0f + max(color.r, max(color.g, color.b)));
+}
+
+float3 uncompress(float3 color)
+{
+	return color / max(1.0f - max(color.r, max(color.g, color.b)), 1.0e-4f);
+}
+
+float3 to_ycocg(float3 c)
+{
+	return float3(0.25f * c.r + 0.5f * c.g + 0.25f * c.b,
+	              0.5f * c.r - 0.5f * c.b,
+	              -0.25f * c.r + 0.5f * c.g - 0.25f * c.b);
+}
+
+float3 from_ycocg(float3 c)
+{
+	return float3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Catmull-Rom filtered history, 5 bilinear taps with corners dropped, after Jimenez
+float3 sample_history(float2 uv, float2 size)
+{
+	float2 sample_pos = uv * size;
+	float2 center = floor(sample_pos - 0.5f) + 0.5f;
+	float2 f = sample_pos - center;
+
+	float2 w0 = f * (-0.5f + f * (1.0f - 0.5f * f));
+	float2 w1 = 1.0f + f * f * (-2.5f + 1.5f * f);
+	float2 w2 = f * (0.5f + f * (2.0f - 1.5f * f));
+	float2 w3 = f * f * (-0.5f + 0.5f * f);
+
+	float2 w12 = w1 + w2;
+	float2 uv0 = (center - 1.0f) / size;
+	float2 uv3 = (center + 2.0f) / size;
+	float2 uv12 = (center + w2 / w12) / size;
+
+	float3 result = 0.0f;
+	result += History.SampleLevel(HistorySampler, float2(uv12.x, uv0.y), 0).rgb * (w12.x * w0.y);
+	result += History.SampleLevel(HistorySampler, float2(uv0.x, uv12.y), 0).rgb * (w0.x * w12.y);
+	result += History.SampleLevel(HistorySampler, uv12, 0).rgb * (w12.x * w12.y);
+	result += History.SampleLevel(HistorySampler, float2(uv3.x, uv12.y), 0).rgb * (w3.x * w12.y);
+	result += History.SampleLevel(HistorySampler, float2(uv12.x, uv3.y), 0).rgb * (w12.x * w3.y);
+
+	float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+	return max(result / weight, 0.0f);
+}
+
+// Pull history towards centre of box until it's inside, keeps it's hue better than clamping each channel
+float3 clip_to_box(float3 history, float3 box_min, float3 box_max)
+{
+	float3 center = 0.5f * (box_max + box_min);
+	float3 extent = max(0.5f * (box_max - box_min), 1.0e-4f);
+
+	float3 offset = history - center;
+	float3 units = abs(offset / extent);
+	float furthest = max(units.x, max(units.y, units.z));
+
+	return (furthest > 1.0f) ? center + offset / furthest : history;
+}
+
+// Temporal upscaler.
+// Rebuilds this frame at output size from jittered scene samples around each output pixel,
+// then blends it with reprojected history, clipped to the colour range of those samples.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint out_w, out_h, in_w, in_h;
+	Output.GetDimensions(out_w, out_h);
+	Scene.GetDimensions(in_w, in_h);
+	if (id.x >= out_w || id.y >= out_h)
+		return;
+
+	float2 out_size = float2(out_w, out_h);
+	float2 in_size = float2(in_w, in_h);
+	float2 uv = (float2(id.xy) + 0.5f) / out_size;
+
+	// Output pixel in scene pixel units, where sample of scene pixel i lands on i
+	float2 in_pos = uv * in_size - 0.5f - ubo.jitter;
+	int2 nearest = int2(floor(in_pos + 0.5f));
+
+	float3 sum = 0.0f;
+	float weight_sum = 0.0f;
+	float weight_max = 0.0f;
+	float3 moment_1 = 0.0f;
+	float3 moment_2 = 0.0f;
+	float2 motion = 0.0f;
+
+	[unroll]
+	for (int y = -1; y <= 1; ++y)
+	{
+		[unroll]
+		for (int x = -1; x <= 1; ++x)
+		{
+			int2 pixel = clamp(nearest + int2(x, y), int2(0, 0), int2(in_size) - 1);
+			float3 color = to_ycocg(compress(Scene.Load(int3(pixel, 0)).rgb));
+
+			// Gaussian fit of Blackman-Harris window, by distance from sample to output pixel
+			float2 d = float2(pixel) - in_pos;
+			float weight = exp(-2.29f * dot(d, d));
+
+			sum += color * weight;
+			weight_sum += weight;
+			weight_max = max(weight_max, weight);
+
+			moment_1 += color;
+			moment_2 += color * color;
+
+			// Longest motion around pixel, so edges of moving objects don't drag old background with them
+			float2 m = Motion.Load(int3(pixel, 0)).rg;
+			if (dot(m, m) > dot(motion, motion))
+				motion = m;
+		}
+	}
+
+	float3 current = sum / max(weight_sum, 1.0e-4f);
+
+	float3 mean = moment_1 / 9.0f;
+	float3 deviation = sqrt(abs(moment_2 / 9.0f - mean * mean));
+	float3 box_min = mean - CLIP_GAMMA * deviation;
+	float3 box_max = mean + CLIP_GAMMA * deviation;
+
+	float2 history_uv = uv - motion;
+	bool on_screen = all(history_uv >= 0.0f) && all(history_uv <= 1.0f);
+
+	float3 result = current;
+	if (ubo.history_valid != 0 && on_screen)
+	{
+		float3 history = to_ycocg(compress(sample_history(history_uv, out_size)));
+		history = clip_to_box(history, box_min, box_max);
+
+		// Less of new frame where no sample is close to this output pixel,
+		// and less flicker where luma changes a lot between frames
+		float alpha = ubo.current_weight * weight_max;
+		float luma_weight_current = alpha / (1.0f + current.x);
+		float luma_weight_history = (1.0f - alpha) / (1.0f + history.x);
+		result = (current * luma_weight_current + history * luma_weight_history) / (luma_weight_current + luma_weight_history);
+	}
+
+	Output[id.xy] = float4(uncompress(from_ycocg(result)), 1.0f);
+}
@@ -0,0 +1,17 @@
+#include "precision.hlsli"
+
+// space2 is because of reason explained in https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+Texture2D<float4> Texture : register(t0, space2);
+SamplerState Sampler : register(s0, space2);
+
+struct Input
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Color : TEXCOORD1;
+};
+
+// Same as textured_quad, with per quad tint
+real4 main(Input input) : SV_Target0
+{
+	return real4(Texture.Sample(Sampler, input.TexCoord)) * real4(input.Color);
+}
@@ -0,0 +1,74 @@
+#include "precision.hlsli"
+
+// Compute shader resources per https://wiki.libsdl.org/SDL3/SDL_CreateGPUComputePipeline#remarks
+Texture2D<float4> Scene : register(t0, space0);
+Texture2D<float4> Bloom : register(t1, space0);
+SamplerState SceneSampler : register(s0, space0);
+SamplerState BloomSampler : register(s1, space0);
+
+RWTexture2D<unorm float4> Output : register(u0, space1);
+
+struct ToneBuffer
+{
+	float exposure;
+	float bloom_intensity;
+	float saturation;
+	float contrast;
+	uint tonemap; // 0 = clamp, 1 = ACES fitted
+	uint grade;   // 0 = off, 1 = on
+	float2 padding;
+};
+
+ConstantBuffer<ToneBuffer> ubo : register(b0, space2);
+
+// Curve is flat at 1 well before this, and x * x stays inside half's range
+static const float ACES_INPUT_MAX = 64.0f;
+
+// Narkowicz 2015, ACES filmic tone mapping curve fit
+real3 aces_fitted(real3 x)
+{
+	const real a = 2.51f;
+	const real b = 0.03f;
+	const real c = 2.43f;
+	const real d = 0.59f;
+	const real e = 0.14f;
+	return saturate((x * (a * x + b)) / (x * (c * x + d) + e));
+}
+
+real3 color_grade(real3 color)
+{
+	color = (color - real(0.5f)) * real(ubo.contrast) + real(0.5f);
+
+	real luma = dot(color, real3(0.2126f, 0.7152f, 0.0722f));
+	color = lerp(luma.xxx, color, real(ubo.saturation));
+
+	return saturate(color);
+}
+
+// Bloom composite, exposure, tone mapping and color grading merged in one pass,
+// so full resolution image is read and written once.
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	uint w, h;
+	Output.GetDimensions(w, h);
+	if (id.x >= w || id.y >= h)
+		return;
+
+	float2 uv = (float2(id.xy) + 0.5f) / float2(w, h);
+
+	// HDR sum in float, tone mapped range fits in real
+	float4 scene = Scene.SampleLevel(SceneSampler, uv, 0);
+	float3 hdr = scene.rgb + Bloom.SampleLevel(BloomSampler, uv, 0).rgb * ubo.bloom_intensity;
+	hdr *= ubo.exposure;
+
+	// Scene colors are already display encoded, like rest of this example, so no gamma step here
+	real3 color = (ubo.tonemap != 0) ? aces_fitted(real3(min(hdr, ACES_INPUT_MAX))) : real3(saturate(hdr));
+
+	if (ubo.grade != 0)
+	{
+		color = color_grade(color);
+	}
+
+	Output[id.xy] = float4(color, 1.0f);
+}
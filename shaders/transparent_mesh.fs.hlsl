@@ -0,0 +1,23 @@
+#include "precision.hlsli"
+
+// space2 is because of reason explained in https://wiki.libsdl.org/SDL3/SDL_CreateGPUShader#remarks
+Texture2D<float4> Texture : register(t0, space2);
+SamplerState Sampler : register(s0, space2);
+
+struct Input
+{
+	float2 TexCoord : TEXCOORD0;
+};
+
+struct MaterialBuffer
+{
+	float4 tint;
+};
+
+// space3 is for fragment uniform buffers
+ConstantBuffer<MaterialBuffer> material : register(b0, space3);
+
+real4 main(Input input) : SV_Target0
+{
+	return real4(Texture.Sample(Sampler, input.TexCoord)) * real4(material.tint);
+}
@@ -0,0 +1,611 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module basic_scenarios;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import scenario;
+import draw_instancing;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Scenarios for the early tutorial shaders, each isolating one cost:
+ * fixed function, vertex fetch, instancing, and texturing. Stress variants scale that one cost up.
+ */
+export namespace basic
+{
+	constexpr auto CLEAR_COLOR = SDL_FColor{ 0.2f, 0.2f, 0.2f, 1.0f };
+
+	// Stress variant sizes
+	constexpr auto STRESS_DRAW_COUNT      = 10'000u;    // raw_triangle and per_draw_shapes, draw calls per frame
+	constexpr auto STRESS_GRID_SIZE       = 256u;       // vertex_buffer_triangle, cells per side, 2 triangles each
+	constexpr auto STRESS_INSTANCE_COUNT  = 1'000'000u; // instanced_shapes
+	constexpr auto STRESS_OVERDRAW_LAYERS = 64u;        // textured_quad, full screen layers
+
+	struct color_vertex
+	{
+		std::array<float, 3> pos;
+		std::array<float, 4> color;
+	};
+
+	struct uv_vertex
+	{
+		std::array<float, 3> pos;
+		std::array<float, 2> uv;
+	};
+
+	// Resources a basic scenario draws with, owned by it's hooks
+	struct geometry
+	{
+		sdl3::gpu_buffer_ptr vertex_buffer;
+		sdl3::gpu_buffer_ptr index_buffer;
+		sdl3::gpu_texture_ptr texture;
+		sdl3::gpu_sampler_ptr sampler;
+
+		uint32_t vertex_count = 0;
+		uint32_t index_count  = 0;
+	};
+
+	// Buffer filled through upload ring, copied at start of first frame
+	auto make_static_buffer(const sdl3::context &ctx, sdl3::scene &scn, SDL_GPUBufferUsageFlags usage, io::byte_span data, std::string_view name) -> sdl3::gpu_buffer_ptr
+	{
+		auto gpu    = ctx.gpu.get();
+		auto buffer = sdl3::make_buffer(gpu, usage, static_cast<uint32_t>(data.size()), name);
+		sdl3::stage_upload(gpu, scn.uploads, data, buffer.get(), 0, false);
+		return buffer;
+	}
+
+	// Clear scene color, no depth
+	auto begin_color_pass(sdl3::frame_context &frm, sdl3::scene &scn) -> SDL_GPURenderPass *
+	{
+		auto color_target = sdl3::scene_color_target(scn, SDL_GPU_LOADOP_CLEAR);
+
+		return SDL_BeginGPURenderPass(frm.cmd_buf, &color_target, 1, nullptr);
+	}
+
+	auto color_vertex_layout() -> std::pair<std::span<const SDL_GPUVertexAttribute>, std::span<const SDL_GPUVertexBufferDescription>>
+	{
+		using VA                                = SDL_GPUVertexAttribute;
+		constexpr static auto VERTEX_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = sizeof(std::array<float, 3>),
+			},
+		};
+
+		using VBD                                 = SDL_GPUVertexBufferDescription;
+		constexpr static auto VERTEX_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot       = 0,
+			  .pitch      = sizeof(color_vertex),
+			  .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+			},
+		};
+
+		return { VERTEX_ATTRIBUTES, VERTEX_BUFFER_DESCS };
+	}
+
+	// Triangle from SV_VertexID, no vertex buffer
+	auto raw_triangle(const sdl3::context &ctx, uint32_t draw_count) -> scenario::running
+	{
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.vs_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.ps_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			},
+			.depth_test = false,
+			.cull_mode  = sdl3::cull_mode_t::none,
+		};
+
+		auto scn        = sdl3::init_scene(ctx, std::span{ &desc, 1 });
+		scn.clear_color = CLEAR_COLOR;
+
+		auto draw = [=](sdl3::frame_context &frm, sdl3::scene &scn) {
+			auto render_pass = begin_color_pass(frm, scn);
+			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.front().get());
+			for (auto i = 0u; i < draw_count; ++i)
+			{
+				SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+			}
+			frm.draw_calls += draw_count;
+			SDL_EndGPURenderPass(render_pass);
+		};
+
+		return { std::move(scn), { .draw = draw } };
+	}
+
+	// Colored triangles from vertex buffer, grid_size of 0 is the single tutorial triangle
+	auto vertex_buffer_triangle(const sdl3::context &ctx, uint32_t grid_size) -> scenario::running
+	{
+		auto [attributes, buffer_descs] = color_vertex_layout();
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/vertex_buffer_triangle.vs_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.ps_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			},
+			.vertex_attributes          = attributes,
+			.vertex_buffer_descriptions = buffer_descs,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+		};
+
+		auto scn        = sdl3::init_scene(ctx, std::span{ &desc, 1 });
+		scn.clear_color = CLEAR_COLOR;
+
+		auto vertices = std::vector<color_vertex>{};
+		if (grid_size == 0)
+		{
+			vertices = {
+				{ { -1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+				{ { +1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+				{ { +0.0f, +1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+			};
+		}
+		else
+		{
+			// Two triangles per cell, not indexed, so every vertex is fetched
+			auto cell = 2.0f / grid_size;
+			vertices.reserve(grid_size * grid_size * 6);
+			for (auto y : std::views::iota(0u, grid_size))
+			{
+				for (auto x : std::views::iota(0u, grid_size))
+				{
+					auto x0 = -1.0f + x * cell, x1 = x0 + cell;
+					auto y0 = -1.0f + y * cell, y1 = y0 + cell;
+					auto c  = std::array{ float(x) / grid_size, float(y) / grid_size, 0.5f, 1.0f };
+
+					vertices.push_back({ { x0, y0, 0.0f }, c });
+					vertices.push_back({ { x1, y0, 0.0f }, c });
+					vertices.push_back({ { x0, y1, 0.0f }, c });
+					vertices.push_back({ { x0, y1, 0.0f }, c });
+					vertices.push_back({ { x1, y0, 0.0f }, c });
+					vertices.push_back({ { x1, y1, 0.0f }, c });
+				}
+			}
+		}
+
+		auto geo           = std::make_shared<geometry>();
+		geo->vertex_buffer = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_VERTEX, io::as_byte_span(vertices), "Triangle Vertex Buffer"sv);
+		geo->vertex_count  = static_cast<uint32_t>(vertices.size());
+
+		auto draw = [geo](sdl3::frame_context &frm, sdl3::scene &scn) {
+			auto render_pass = begin_color_pass(frm, scn);
+
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = geo->vertex_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
+			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.front().get());
+			SDL_DrawGPUPrimitives(render_pass, geo->vertex_count, 1, 0, 0);
+			++frm.draw_calls;
+
+			SDL_EndGPURenderPass(render_pass);
+		};
+
+		return { std::move(scn), { .draw = draw } };
+	}
+
+	// Indexed quad, placed by instance id in vertex shader
+	auto instanced_shapes(const sdl3::context &ctx, uint32_t instance_count) -> scenario::running
+	{
+		auto [attributes, buffer_descs] = color_vertex_layout();
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/instanced_shapes.vs_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.ps_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			},
+			.vertex_attributes          = attributes,
+			.vertex_buffer_descriptions = buffer_descs,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+		};
+
+		auto scn        = sdl3::init_scene(ctx, std::span{ &desc, 1 });
+		scn.clear_color = CLEAR_COLOR;
+
+		auto vertices = std::array{
+			color_vertex{ { -0.5f, -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			color_vertex{ { +0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			color_vertex{ { +0.5f, +0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+			color_vertex{ { -0.5f, +0.5f, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f } },
+		};
+		auto indices = std::array{ 0u, 1u, 2u, 2u, 3u, 0u };
+
+		auto geo           = std::make_shared<geometry>();
+		geo->vertex_buffer = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_VERTEX, io::as_byte_span(vertices), "Shape Vertex Buffer"sv);
+		geo->index_buffer  = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_INDEX, io::as_byte_span(indices), "Shape Index Buffer"sv);
+		geo->index_count   = static_cast<uint32_t>(indices.size());
+
+		auto draw = [geo, instance_count](sdl3::frame_context &frm, sdl3::scene &scn) {
+			auto render_pass = begin_color_pass(frm, scn);
+
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = geo->vertex_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
+
+			auto index_binding = SDL_GPUBufferBinding{
+				.buffer = geo->index_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.front().get());
+			SDL_DrawGPUIndexedPrimitives(render_pass, geo->index_count, instance_count, 0, 0, 0);
+			++frm.draw_calls;
+
+			SDL_EndGPURenderPass(render_pass);
+		};
+
+		return { std::move(scn), { .draw = draw } };
+	}
+
+	// Shapes as separate draws, each with it's own transform and material
+	struct per_draw_state
+	{
+		geometry geo;
+		sdl3::draw_ring ring;
+		uint32_t draw_count = 0;
+		uint32_t first_draw = 0; // this frame's, from reserve_draws
+		uint32_t reserved   = 0; // draws reserve_draws had room for this frame, only these are drawn
+		float time          = 0.0f;
+
+		// Shapes submitted as objects, and merged in to instanced draws
+		bool auto_instanced = false;
+		instancing::draw_list objects;
+	};
+
+	// Rotated and scaled in XY, then moved, column major
+	auto shape_transform(float x, float y, float scale, float angle) -> std::array<float, 16>
+	{
+		auto c = std::cos(angle) * scale;
+		auto s = std::sin(angle) * scale;
+		return {
+			c, s, 0.0f, 0.0f,
+			-s, c, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			x, y, 0.0f, 1.0f
+		};
+	}
+
+	// Indexed quad drawn once per shape, no uniform pushes.
+	// Constants of every draw are rewritten each frame in to draw ring, and found by draw id in vertex shader.
+	// Auto instanced shapes are submitted one by one all the same, and drawn as instanced draws of same mesh.
+	auto per_draw_shapes(const sdl3::context &ctx, uint32_t draw_count, bool auto_instanced) -> scenario::running
+	{
+		auto [attributes, buffer_descs] = color_vertex_layout();
+
+		// Color vertex layout, plus draw id from instance rate buffer in slot 1
+		auto per_draw_attributes = std::vector(attributes.begin(), attributes.end());
+		per_draw_attributes.push_back({
+		  .location    = 2,
+		  .buffer_slot = 1,
+		  .format      = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
+		  .offset      = 0,
+		});
+
+		auto per_draw_buffers = std::vector(buffer_descs.begin(), buffer_descs.end());
+		per_draw_buffers.push_back({
+		  .slot               = 1,
+		  .pitch              = sizeof(uint32_t),
+		  .input_rate         = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+		  .instance_step_rate = 1,
+		});
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary        = io::read_file("shaders/per_draw_shapes.vs_6_4.cso"),
+			  .stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+			  .storage_buffer_count = 1,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.ps_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			},
+			.vertex_attributes          = per_draw_attributes,
+			.vertex_buffer_descriptions = per_draw_buffers,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+		};
+
+		auto scn        = sdl3::init_scene(ctx, std::span{ &desc, 1 });
+		scn.clear_color = CLEAR_COLOR;
+
+		auto vertices = std::array{
+			color_vertex{ { -0.5f, -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			color_vertex{ { +0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			color_vertex{ { +0.5f, +0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+			color_vertex{ { -0.5f, +0.5f, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f } },
+		};
+		auto indices = std::array{ 0u, 1u, 2u, 2u, 3u, 0u };
+
+		auto st               = std::make_shared<per_draw_state>();
+		st->geo.vertex_buffer = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_VERTEX, io::as_byte_span(vertices), "Shape Vertex Buffer"sv);
+		st->geo.index_buffer  = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_INDEX, io::as_byte_span(indices), "Shape Index Buffer"sv);
+		st->geo.index_count   = static_cast<uint32_t>(indices.size());
+		st->ring              = sdl3::make_draw_ring(ctx.gpu.get(), scn.uploads);
+		st->draw_count        = draw_count;
+		st->auto_instanced    = auto_instanced;
+
+		// Square grid of shapes over whole screen, each spinning at it's own rate
+		auto update = [st](const sdl3::context &ctx, sdl3::scene &scn, float dt) {
+			st->time += dt;
+
+			auto side      = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(st->draw_count))));
+			auto cell      = 2.0f / static_cast<float>(side);
+			auto constants = [&](uint32_t id) {
+				auto x = -1.0f + (static_cast<float>(id % side) + 0.5f) * cell;
+				auto y = -1.0f + (static_cast<float>(id / side) + 0.5f) * cell;
+				return sdl3::draw_data{
+					.transform = shape_transform(x, y, cell * 0.8f, st->time * (1.0f + static_cast<float>(id % 7) * 0.25f)),
+					.material  = id % 4,
+					.lod       = 0,
+				};
+			};
+
+			if (st->auto_instanced)
+			{
+				auto mesh = instancing::mesh_ref{
+					.vertices      = st->geo.vertex_buffer.get(),
+					.indices       = st->geo.index_buffer.get(),
+					.index_count   = st->geo.index_count,
+					.first_index   = 0,
+					.vertex_offset = 0,
+				};
+				for (auto id : std::views::iota(0u, st->draw_count))
+				{
+					instancing::submit(st->objects, scn.pipelines.front().get(), mesh, constants(id));
+				}
+				instancing::merge_draws(ctx.gpu.get(), scn.uploads, st->ring, st->objects);
+				return;
+			}
+
+			auto batch     = sdl3::reserve_draws(ctx.gpu.get(), scn.uploads, st->ring, st->draw_count);
+			st->first_draw = batch.first_draw;
+			st->reserved   = static_cast<uint32_t>(batch.draws.size());
+			for (auto &&[i, draw] : batch.draws | std::views::enumerate)
+			{
+				draw = constants(static_cast<uint32_t>(i));
+			}
+		};
+
+		auto draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+			auto render_pass = begin_color_pass(frm, scn);
+
+			if (st->auto_instanced)
+			{
+				frm.draw_calls += instancing::draw_merged(render_pass, st->ring, st->objects, 1);
+				SDL_EndGPURenderPass(render_pass);
+				return;
+			}
+
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = st->geo.vertex_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
+			sdl3::bind_draw_ring(render_pass, st->ring, 1);
+
+			auto index_binding = SDL_GPUBufferBinding{
+				.buffer = st->geo.index_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.front().get());
+
+			// One instance per draw, first_instance picks it's constants
+			for (auto i : std::views::iota(0u, st->reserved))
+			{
+				SDL_DrawGPUIndexedPrimitives(render_pass, st->geo.index_count, 1, 0, 0, st->first_draw + i);
+			}
+			frm.draw_calls += st->reserved;
+
+			SDL_EndGPURenderPass(render_pass);
+		};
+
+		return { std::move(scn), { .update = update, .draw = draw } };
+	}
+
+	// 4x4 grid of textured quads, layers > 1 redraws whole grid that many times on top of itself
+	auto textured_quad(const sdl3::context &ctx, uint32_t layers) -> scenario::running
+	{
+		constexpr auto GRID_INSTANCES = 16u;
+
+		using VA                                = SDL_GPUVertexAttribute;
+		constexpr static auto VERTEX_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+			  .offset      = sizeof(std::array<float, 3>),
+			},
+		};
+
+		using VBD                                 = SDL_GPUVertexBufferDescription;
+		constexpr static auto VERTEX_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot       = 0,
+			  .pitch      = sizeof(uv_vertex),
+			  .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+			},
+		};
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/textured_quad.vs_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file(sdl3::shader_file(ctx, "textured_quad"sv, "ps_6_4"sv)),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			  .sampler_count = 1,
+			},
+			.vertex_attributes          = VERTEX_ATTRIBUTES,
+			.vertex_buffer_descriptions = VERTEX_BUFFER_DESCS,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+		};
+
+		auto scn        = sdl3::init_scene(ctx, std::span{ &desc, 1 });
+		scn.clear_color = CLEAR_COLOR;
+
+		auto vertices = std::array{
+			uv_vertex{ { -1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f } },
+			uv_vertex{ { +1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f } },
+			uv_vertex{ { +1.0f, +1.0f, 0.0f }, { 1.0f, 0.0f } },
+			uv_vertex{ { -1.0f, +1.0f, 0.0f }, { 0.0f, 0.0f } },
+		};
+		auto indices = std::array{ 0u, 1u, 2u, 2u, 3u, 0u };
+
+		auto image = io::read_image_file("data/uv_grid.dds");
+
+		auto gpu           = ctx.gpu.get();
+		auto geo           = std::make_shared<geometry>();
+		geo->vertex_buffer = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_VERTEX, io::as_byte_span(vertices), "Quad Vertex Buffer"sv);
+		geo->index_buffer  = make_static_buffer(ctx, scn, SDL_GPU_BUFFERUSAGE_INDEX, io::as_byte_span(indices), "Quad Index Buffer"sv);
+		geo->index_count   = static_cast<uint32_t>(indices.size());
+
+		auto td = sdl3::texture_desc{
+			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+			.format     = image.header.format,
+			.width      = image.header.width,
+			.height     = image.header.height,
+			.depth      = image.header.layer_count,
+			.mip_levels = image.header.mipmap_count,
+		};
+		geo->texture = sdl3::make_texture(gpu, td, "Quad Texture"sv);
+		geo->sampler = sdl3::make_sampler(gpu, sdl3::sampler_type::anisotropic_clamp);
+		sdl3::upload_image(gpu, geo->texture.get(), image);
+
+		auto draw = [geo, layers](sdl3::frame_context &frm, sdl3::scene &scn) {
+			auto render_pass = begin_color_pass(frm, scn);
+
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = geo->vertex_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
+
+			auto index_binding = SDL_GPUBufferBinding{
+				.buffer = geo->index_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+			auto sampler_binding = SDL_GPUTextureSamplerBinding{
+				.texture = geo->texture.get(),
+				.sampler = geo->sampler.get(),
+			};
+			SDL_BindGPUFragmentSamplers(render_pass, 0, &sampler_binding, 1);
+
+			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.front().get());
+			for (auto i = 0u; i < layers; ++i)
+			{
+				SDL_DrawGPUIndexedPrimitives(render_pass, geo->index_count, GRID_INSTANCES, 0, 0, 0);
+			}
+			frm.draw_calls += layers;
+
+			SDL_EndGPURenderPass(render_pass);
+		};
+
+		return { std::move(scn), { .draw = draw } };
+	}
+
+	void add_scenarios(scenario::registry &reg)
+	{
+		reg.push_back({
+		  .name        = "raw_triangle"sv,
+		  .description = "One triangle from SV_VertexID, fixed function cost only."sv,
+		  .setup       = [](const sdl3::context &ctx) { return raw_triangle(ctx, 1); },
+		});
+		reg.push_back({
+		  .name        = "raw_triangle_stress"sv,
+		  .description = "Same triangle, 10K draw calls, per-draw overhead."sv,
+		  .setup       = [](const sdl3::context &ctx) { return raw_triangle(ctx, STRESS_DRAW_COUNT); },
+		});
+		reg.push_back({
+		  .name        = "vertex_buffer_triangle"sv,
+		  .description = "One triangle from vertex buffer."sv,
+		  .setup       = [](const sdl3::context &ctx) { return vertex_buffer_triangle(ctx, 0); },
+		});
+		reg.push_back({
+		  .name        = "vertex_buffer_triangle_stress"sv,
+		  .description = "128K unindexed triangles covering screen, vertex fetch."sv,
+		  .setup       = [](const sdl3::context &ctx) { return vertex_buffer_triangle(ctx, STRESS_GRID_SIZE); },
+		});
+		reg.push_back({
+		  .name        = "instanced_shapes"sv,
+		  .description = "Indexed quad, 16 instances placed by instance id."sv,
+		  .setup       = [](const sdl3::context &ctx) { return instanced_shapes(ctx, 16); },
+		});
+		reg.push_back({
+		  .name        = "instanced_shapes_stress"sv,
+		  .description = "Indexed quad, 1M instances, instancing throughput."sv,
+		  .setup       = [](const sdl3::context &ctx) { return instanced_shapes(ctx, STRESS_INSTANCE_COUNT); },
+		});
+		reg.push_back({
+		  .name        = "per_draw_shapes"sv,
+		  .description = "Indexed quad, 16 separate draws with constants from draw ring."sv,
+		  .setup       = [](const sdl3::context &ctx) { return per_draw_shapes(ctx, 16, false); },
+		});
+		reg.push_back({
+		  .name        = "per_draw_shapes_stress"sv,
+		  .description = "Same quad, 10K draws, each reading it's own constants by draw id."sv,
+		  .setup       = [](const sdl3::context &ctx) { return per_draw_shapes(ctx, STRESS_DRAW_COUNT, false); },
+		});
+		reg.push_back({
+		  .name        = "auto_instanced_shapes_stress"sv,
+		  .description = "Same 10K shapes submitted one by one, merged in to instanced draws automatically."sv,
+		  .setup       = [](const sdl3::context &ctx) { return per_draw_shapes(ctx, STRESS_DRAW_COUNT, true); },
+		});
+		reg.push_back({
+		  .name        = "textured_quad"sv,
+		  .description = "4x4 textured quads, anisotropic sampling."sv,
+		  .setup       = [](const sdl3::context &ctx) { return textured_quad(ctx, 1); },
+		});
+		reg.push_back({
+		  .name        = "textured_quad_stress"sv,
+		  .description = "Textured quads redrawn 64 times, texturing and fill rate."sv,
+		  .setup       = [](const sdl3::context &ctx) { return textured_quad(ctx, STRESS_OVERDRAW_LAYERS); },
+		});
+	}
+}
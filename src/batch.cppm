@@ -0,0 +1,275 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module batch;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import sdl3_postfx;
+import scenario;
+import image_encode;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Offscreen batch rendering, for thumbnails and previews in bulk.
+ * GPU renders ahead while earlier frames are read back, and worker threads encode and write finished images,
+ * so rendering, readback and encoding all overlap.
+ */
+export namespace batch
+{
+	// Frames submitted ahead of oldest readback that hasn't arrived yet
+	constexpr auto MAX_FRAMES_IN_FLIGHT = 3u;
+	static_assert(MAX_FRAMES_IN_FLIGHT <= sdl3::DOWNLOAD_RING_SLOTS);
+
+	// Images waiting for an encoder, per worker, before render loop waits for them to catch up
+	constexpr auto MAX_QUEUED_PER_WORKER = 2u;
+
+	struct job
+	{
+		scenario::camera cam;
+		std::filesystem::path output;
+	};
+
+	// Views evenly spaced around scene, written as frame_00000.png, frame_00001.png, ...
+	auto orbit_jobs(uint32_t count, const std::filesystem::path &directory, encode::format_t format) -> std::vector<job>
+	{
+		return std::views::iota(0u, count)
+		     | std::views::transform([&](uint32_t i) {
+				   return job{
+					   .cam = {
+						 .angle = 360.0f * i / count,
+						 .cam_y = 0.0f,
+					   },
+					   .output = directory / std::format("frame_{:05}{}", i, encode::extension(format)),
+				   };
+			   })
+		     | std::ranges::to<std::vector>();
+	}
+
+	// Fixed set of threads, taking tasks from a shared queue in order
+	struct worker_pool
+	{
+		std::mutex lock;
+		std::condition_variable_any wake; // task queued, or stop requested
+		std::condition_variable_any done; // task finished
+		std::deque<std::move_only_function<void()>> tasks;
+		uint32_t active = 0;
+		std::vector<std::jthread> workers;
+	};
+
+	void start_workers(worker_pool &pool, uint32_t count)
+	{
+		for (auto i = 0u; i < count; ++i)
+		{
+			pool.workers.emplace_back([&pool](std::stop_token stop) {
+				while (true)
+				{
+					auto task = std::move_only_function<void()>{};
+					{
+						auto lk = std::unique_lock{ pool.lock };
+						// Keeps draining queue after stop is requested, returns only once it's empty
+						if (not pool.wake.wait(lk, stop, [&] { return not pool.tasks.empty(); }))
+							return;
+
+						task = std::move(pool.tasks.front());
+						pool.tasks.pop_front();
+						++pool.active;
+					}
+
+					task();
+
+					{
+						auto lk = std::scoped_lock{ pool.lock };
+						--pool.active;
+					}
+					pool.done.notify_all();
+				}
+			});
+		}
+	}
+
+	// Queue task, waits while queue already holds max_queued tasks
+	void submit(worker_pool &pool, std::move_only_function<void()> task, uint32_t max_queued)
+	{
+		{
+			auto lk = std::unique_lock{ pool.lock };
+			pool.done.wait(lk, [&] { return pool.tasks.size() < max_queued; });
+			pool.tasks.push_back(std::move(task));
+		}
+		pool.wake.notify_one();
+	}
+
+	// Queue task ahead of everything waiting, for work that's needed sooner than what's already queued.
+	// Doesn't wait for queue space.
+	void submit_first(worker_pool &pool, std::move_only_function<void()> task)
+	{
+		{
+			auto lk = std::scoped_lock{ pool.lock };
+			pool.tasks.push_front(std::move(task));
+		}
+		pool.wake.notify_one();
+	}
+
+	// Wait for queue to empty and every task to finish
+	void wait_idle(worker_pool &pool)
+	{
+		auto lk = std::unique_lock{ pool.lock };
+		pool.done.wait(lk, [&] { return pool.tasks.empty() and pool.active == 0; });
+	}
+
+	void stop_workers(worker_pool &pool)
+	{
+		// jthread requests stop and joins, stop request wakes waiting workers
+		pool.workers.clear();
+	}
+
+	struct stats
+	{
+		uint32_t images;
+		uint32_t failed;
+		double seconds;
+	};
+
+	// Render count frames offscreen with running scenario, at context's render size.
+	// setup(i) runs before frame i's update, deliver(i, image) runs on this thread as each readback arrives, in order.
+	// Returns number of frames whose readback couldn't be queued.
+	auto render_offscreen(const sdl3::context &ctx, scenario::running &run, postfx::chain &fx, size_t count,
+	                      const std::function<void(size_t)> &setup,
+	                      const std::function<void(size_t, sdl3::readback &&)> &deliver) -> uint32_t
+	{
+		auto gpu = ctx.gpu.get();
+
+		auto [width, height] = sdl3::render_size(ctx);
+
+		// Post processing resolves in to this, in place of swapchain
+		auto target_desc = sdl3::texture_desc{
+			.usage        = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+			.format       = sdl3::OFFSCREEN_FORMAT,
+			.width        = width,
+			.height       = height,
+			.depth        = 1,
+			.mip_levels   = 1,
+			.sample_count = SDL_GPU_SAMPLECOUNT_1,
+		};
+		auto target = sdl3::make_texture(gpu, target_desc, "Offscreen Target"sv);
+
+		struct pending
+		{
+			uint64_t frame_index;
+			size_t index;
+			std::future<sdl3::readback> image;
+		};
+		auto in_flight = std::deque<pending>{};
+		auto failed    = 0u;
+
+		// Hand arrived readbacks on, oldest first
+		auto deliver_ready = [&] {
+			while (not in_flight.empty() and in_flight.front().image.wait_for(0s) == std::future_status::ready)
+			{
+				auto &front = in_flight.front();
+				deliver(front.index, front.image.get());
+				in_flight.pop_front();
+			}
+		};
+
+		for (auto i : std::views::iota(size_t{ 0 }, count))
+		{
+			// Oldest frame has to finish before another one starts
+			if (in_flight.size() >= MAX_FRAMES_IN_FLIGHT)
+			{
+				sdl3::wait_for_frame(run.scn, in_flight.front().frame_index);
+			}
+			deliver_ready();
+
+			setup(i);
+			if (run.fn.update)
+				run.fn.update(ctx, run.scn, 0.0f);
+
+			auto frm = sdl3::begin_frame(ctx, run.scn, target.get());
+			run.fn.draw(frm, run.scn);
+			postfx::apply(frm, fx, run.scn);
+			if (run.fn.draw_overlay)
+				run.fn.draw_overlay(frm, run.scn);
+
+			auto region = SDL_GPUTextureRegion{
+				.texture = target.get(),
+				.w       = width,
+				.h       = height,
+				.d       = 1,
+			};
+			auto image = sdl3::readback_texture(gpu, run.scn.downloads, region, sdl3::OFFSCREEN_FORMAT);
+			if (image.valid())
+			{
+				in_flight.push_back({ frm.frame_index, i, std::move(image) });
+			}
+			else
+			{
+				++failed;
+			}
+
+			sdl3::end_frame(frm, run.scn);
+		}
+
+		while (not in_flight.empty())
+		{
+			sdl3::wait_for_frame(run.scn, in_flight.front().frame_index);
+			deliver_ready();
+		}
+
+		return failed;
+	}
+
+	// Render every job with running scenario, and write each through post processing in to it's output file
+	auto render_jobs(const sdl3::context &ctx, scenario::running &run, postfx::chain &fx, std::span<const job> jobs, encode::format_t format) -> stats
+	{
+		auto [width, height] = sdl3::render_size(ctx);
+
+		msg::info(std::format("Batch: {} jobs, {}x{}.", jobs.size(), width, height));
+
+		auto worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		auto max_queued   = worker_count * MAX_QUEUED_PER_WORKER;
+
+		auto pool = worker_pool{};
+		start_workers(pool, worker_count);
+
+		auto failed = std::atomic<uint32_t>{ 0 };
+
+		auto setup = [&](size_t i) {
+			if (run.fn.set_camera)
+				run.fn.set_camera(jobs[i].cam);
+		};
+
+		auto deliver = [&](size_t i, sdl3::readback &&image) {
+			auto encode_task = [image = std::move(image), output = jobs[i].output, format, &failed] {
+				auto file = encode::encode(format, image.data, image.width, image.height);
+				if (not io::write_file(output, file))
+					++failed;
+			};
+			submit(pool, std::move(encode_task), max_queued);
+		};
+
+		auto start_ns = SDL_GetTicksNS();
+
+		failed += render_offscreen(ctx, run, fx, jobs.size(), setup, deliver);
+
+		wait_idle(pool);
+		stop_workers(pool);
+
+		auto result = stats{
+			.images  = static_cast<uint32_t>(jobs.size()) - failed.load(),
+			.failed  = failed.load(),
+			.seconds = static_cast<double>(SDL_GetTicksNS() - start_ns) / 1'000'000'000.0,
+		};
+
+		msg::info(std::format("Batch: {} images in {:.2f} s, {:.1f} images/s, {} failed.",
+		                      result.images, result.seconds, result.images / std::max(result.seconds, 1e-9), result.failed));
+		return result;
+	}
+}
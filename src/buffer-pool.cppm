@@ -0,0 +1,152 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module buffer_pool;
+
+import std;
+import logs;
+import io;
+import sdl3_scene;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Shared GPU buffers handed out in ranges, so data that comes and goes at runtime
+ * lives in one buffer that's bound once, instead of a buffer per item.
+ * Free ranges are kept by offset, and merge with their neighbours when given back.
+ */
+export namespace pool
+{
+	struct range
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct range_allocator
+	{
+		uint32_t capacity = 0;
+		uint32_t used     = 0;
+		std::map<uint32_t, uint32_t> free; // offset -> size
+	};
+
+	auto make_allocator(uint32_t capacity) -> range_allocator
+	{
+		return {
+			.capacity = capacity,
+			.used     = 0,
+			.free     = { { 0u, capacity } },
+		};
+	}
+
+	// First free range that fits, offset is a multiple of alignment.
+	// Nothing if no free range is large enough, caller decides whether to wait or evict.
+	auto allocate(range_allocator &alloc, uint32_t size, uint32_t alignment) -> std::optional<range>
+	{
+		for (auto it = alloc.free.begin(); it != alloc.free.end(); ++it)
+		{
+			auto [start, free_size] = *it;
+			auto offset             = (start + alignment - 1) / alignment * alignment;
+			auto padding            = offset - start;
+			if (size == 0 or padding + size > free_size)
+				continue;
+
+			alloc.free.erase(it);
+			if (padding > 0)
+				alloc.free.emplace(start, padding);
+			if (padding + size < free_size)
+				alloc.free.emplace(offset + size, free_size - padding - size);
+
+			alloc.used += size;
+			return range{ offset, size };
+		}
+
+		return std::nullopt;
+	}
+
+	void release(range_allocator &alloc, range rng)
+	{
+		auto [it, inserted] = alloc.free.emplace(rng.offset, rng.size);
+		msg::error(inserted, "Range was released twice.");
+		alloc.used -= rng.size;
+
+		auto next = std::next(it);
+		if (next != alloc.free.end() and it->first + it->second == next->first)
+		{
+			it->second += next->second;
+			alloc.free.erase(next);
+		}
+
+		if (it != alloc.free.begin())
+		{
+			auto prev = std::prev(it);
+			if (prev->first + prev->second == it->first)
+			{
+				prev->second += it->second;
+				alloc.free.erase(it);
+			}
+		}
+	}
+
+	// Largest range allocate can still return, less than free bytes when pool is fragmented
+	auto largest_free(const range_allocator &alloc) -> uint32_t
+	{
+		auto sizes = alloc.free | std::views::values;
+		return sizes.empty() ? 0u : std::ranges::max(sizes);
+	}
+
+	// GPU buffer with an allocator over it.
+	// Released ranges are retired first, as frames still in flight may read them.
+	struct buffer_pool
+	{
+		struct retired_range
+		{
+			range rng;
+			uint64_t frame_index; // free once every frame before this one has finished
+		};
+
+		sdl3::gpu_buffer_ptr buffer;
+		range_allocator allocator;
+		std::deque<retired_range> retired;
+	};
+
+	auto make_buffer_pool(SDL_GPUDevice *gpu, SDL_GPUBufferUsageFlags usage, uint32_t capacity, std::string_view name) -> buffer_pool
+	{
+		return {
+			.buffer    = sdl3::make_buffer(gpu, usage, capacity, name),
+			.allocator = make_allocator(capacity),
+		};
+	}
+
+	// Give range back once GPU is done with frames before frame_index, the first frame that doesn't read it
+	void retire(buffer_pool &pl, range rng, uint64_t frame_index)
+	{
+		pl.retired.push_back({ rng, frame_index });
+	}
+
+	// Release retired ranges whose last readers have finished, call once per frame
+	void reclaim(buffer_pool &pl, uint64_t completed_count)
+	{
+		while (not pl.retired.empty() and pl.retired.front().frame_index <= completed_count)
+		{
+			release(pl.allocator, pl.retired.front().rng);
+			pl.retired.pop_front();
+		}
+	}
+
+	// Copy data in to range with this frame's uploads
+	auto upload(SDL_GPUDevice *gpu, sdl3::upload_ring &uploads, const buffer_pool &pl, range rng, io::byte_span data) -> bool
+	{
+		msg::error(data.size() <= rng.size, "Upload is larger than pool range.");
+		return sdl3::stage_upload(gpu, uploads, data, pl.buffer.get(), rng.offset, false);
+	}
+
+	// Upload memory for whole range, for callers that write data in place, e.g. decoders
+	auto reserve(SDL_GPUDevice *gpu, sdl3::upload_ring &uploads, const buffer_pool &pl, range rng) -> std::span<std::byte>
+	{
+		return sdl3::reserve_upload(gpu, uploads, rng.size, pl.buffer.get(), rng.offset, false);
+	}
+}
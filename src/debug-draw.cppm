@@ -0,0 +1,418 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+// GLM configuration and headers, must match main.cpp
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE // GLM clip space should be in Z-axis to 0 to 1
+#define GLM_FORCE_LEFT_HANDED       // GLM should use left-handed coordinates, +z goes into screen
+#define GLM_FORCE_RADIANS           // GLM should always use radians not degrees.
+#include <glm/glm.hpp>              // Required for glm::vec3/4/mat4/etc
+#include <glm/ext.hpp>              // Required for glm::inverse function
+
+// Same condition as sdl3::IS_DEBUG, release builds get empty functions instead
+#ifdef _DEBUG
+#define DEBUG_DRAW_ENABLED 1
+#else
+#define DEBUG_DRAW_ENABLED 0
+#endif
+
+export module debug_draw;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Immediate mode debug lines and shapes.
+ * Any thread can add shapes, they are batched and drawn with at most two draw calls per frame.
+ * In release builds every function is an empty inline one, there are no arenas or locks, and calls compile to nothing.
+ */
+export namespace dbg
+{
+	constexpr auto ENABLED = sdl3::IS_DEBUG;
+
+	// Max line vertices per frame, across all threads
+	constexpr auto MAX_VERTICES = uint32_t{ 256 * 1024 };
+
+	enum class depth_t : uint8_t
+	{
+		tested,  // hidden behind scene geometry
+		overlay, // always visible
+	};
+	constexpr auto DEPTH_MODES = 2u;
+
+	struct line_vertex
+	{
+		glm::vec3 pos;
+		uint32_t color; // RGBA8, see rgba
+	};
+
+	constexpr auto rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) -> uint32_t
+	{
+		return uint32_t{ r } | (uint32_t{ g } << 8) | (uint32_t{ b } << 16) | (uint32_t{ a } << 24);
+	}
+
+	namespace color
+	{
+		constexpr auto RED     = rgba(255, 0, 0);
+		constexpr auto GREEN   = rgba(0, 255, 0);
+		constexpr auto BLUE    = rgba(0, 0, 255);
+		constexpr auto YELLOW  = rgba(255, 255, 0);
+		constexpr auto CYAN    = rgba(0, 255, 255);
+		constexpr auto MAGENTA = rgba(255, 0, 255);
+		constexpr auto WHITE   = rgba(255, 255, 255);
+	}
+}
+
+#if DEBUG_DRAW_ENABLED
+namespace dbg
+{
+	// Each thread appends in to it's own arena, lock is only contended while arenas are gathered
+	struct thread_arena
+	{
+		std::mutex lock;
+		std::array<std::vector<line_vertex>, DEPTH_MODES> lines;
+	};
+
+	struct arena_registry
+	{
+		std::mutex lock;
+		std::vector<std::unique_ptr<thread_arena>> arenas;
+	};
+
+	auto registry = arena_registry{};
+
+	thread_local auto local_arena = (thread_arena *)nullptr;
+
+	// Arenas live until program exit, so a thread's pointer never dangles
+	auto get_arena() -> thread_arena &
+	{
+		if (local_arena == nullptr)
+		{
+			auto lock = std::scoped_lock(registry.lock);
+			registry.arenas.push_back(std::make_unique<thread_arena>());
+			local_arena = registry.arenas.back().get();
+		}
+		return *local_arena;
+	}
+
+	// Append line segments as pairs of points
+	void add_lines(std::span<const glm::vec3> points, uint32_t color, depth_t depth)
+	{
+		auto &arena = get_arena();
+		auto lock   = std::scoped_lock(arena.lock);
+
+		auto &lines = arena.lines[std::to_underlying(depth)];
+		for (auto &&p : points)
+		{
+			lines.push_back({ p, color });
+		}
+	}
+
+	// 12 edges between 8 corners ordered as bit pattern x | y << 1 | z << 2
+	void add_box_edges(const std::array<glm::vec3, 8> &corners, uint32_t color, depth_t depth)
+	{
+		constexpr auto EDGES = std::array<std::pair<uint8_t, uint8_t>, 12>{ {
+		  { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, // along x
+		  { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, // along y
+		  { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }, // along z
+		} };
+
+		auto points = std::array<glm::vec3, EDGES.size() * 2>{};
+		for (auto &&[i, edge] : EDGES | std::views::enumerate)
+		{
+			points[i * 2]     = corners[edge.first];
+			points[i * 2 + 1] = corners[edge.second];
+		}
+		add_lines(points, color, depth);
+	}
+}
+
+export namespace dbg
+{
+	void line(const glm::vec3 &from, const glm::vec3 &to, uint32_t color, depth_t depth = depth_t::tested)
+	{
+		add_lines(std::array{ from, to }, color, depth);
+	}
+
+	// Axis aligned box
+	void box(const glm::vec3 &min, const glm::vec3 &max, uint32_t color, depth_t depth = depth_t::tested)
+	{
+		auto corners = std::array<glm::vec3, 8>{};
+		for (auto i : std::views::iota(0u, 8u))
+		{
+			corners[i] = {
+				(i & 1) ? max.x : min.x,
+				(i & 2) ? max.y : min.y,
+				(i & 4) ? max.z : min.z,
+			};
+		}
+		add_box_edges(corners, color, depth);
+	}
+
+	// Unit cube, centered on origin, moved by transform
+	void box(const glm::mat4 &transform, uint32_t color, depth_t depth = depth_t::tested)
+	{
+		auto corners = std::array<glm::vec3, 8>{};
+		for (auto i : std::views::iota(0u, 8u))
+		{
+			auto corner = glm::vec4{
+				(i & 1) ? 0.5f : -0.5f,
+				(i & 2) ? 0.5f : -0.5f,
+				(i & 4) ? 0.5f : -0.5f,
+				1.0f,
+			};
+			corners[i] = glm::vec3(transform * corner);
+		}
+		add_box_edges(corners, color, depth);
+	}
+
+	// Three great circles, one per axis plane
+	void sphere(const glm::vec3 &center, float radius, uint32_t color, depth_t depth = depth_t::tested, uint32_t segments = 24)
+	{
+		auto points = std::vector<glm::vec3>{};
+		points.reserve(segments * 3 * 2);
+
+		auto step = glm::two_pi<float>() / static_cast<float>(segments);
+		for (auto i : std::views::iota(0u, segments))
+		{
+			auto a0 = step * static_cast<float>(i);
+			auto a1 = step * static_cast<float>(i + 1);
+			auto c0 = std::cos(a0) * radius, s0 = std::sin(a0) * radius;
+			auto c1 = std::cos(a1) * radius, s1 = std::sin(a1) * radius;
+
+			points.push_back(center + glm::vec3{ c0, s0, 0.f }); // XY
+			points.push_back(center + glm::vec3{ c1, s1, 0.f });
+			points.push_back(center + glm::vec3{ c0, 0.f, s0 }); // XZ
+			points.push_back(center + glm::vec3{ c1, 0.f, s1 });
+			points.push_back(center + glm::vec3{ 0.f, c0, s0 }); // YZ
+			points.push_back(center + glm::vec3{ 0.f, c1, s1 });
+		}
+		add_lines(points, color, depth);
+	}
+
+	// Frustum of a projection * view matrix, clip space depth is 0 to 1
+	void frustum(const glm::mat4 &view_proj, uint32_t color, depth_t depth = depth_t::tested)
+	{
+		auto inv_view_proj = glm::inverse(view_proj);
+
+		auto corners = std::array<glm::vec3, 8>{};
+		for (auto i : std::views::iota(0u, 8u))
+		{
+			auto ndc = glm::vec4{
+				(i & 1) ? 1.0f : -1.0f,
+				(i & 2) ? 1.0f : -1.0f,
+				(i & 4) ? 1.0f : 0.0f,
+				1.0f,
+			};
+			auto world = inv_view_proj * ndc;
+			corners[i] = glm::vec3(world) / world.w;
+		}
+		add_box_edges(corners, color, depth);
+	}
+
+	// Drawing side of debug lines
+	struct renderer
+	{
+		sdl3::gfx_pipeline_ptr tested_pipeline;
+		sdl3::gfx_pipeline_ptr overlay_pipeline;
+		sdl3::gpu_buffer_ptr vertex_buffer;
+
+		std::array<uint32_t, DEPTH_MODES> vertex_counts;
+	};
+
+	auto init_renderer(const sdl3::context &ctx) -> renderer
+	{
+		msg::info("Create Debug Draw Renderer.");
+
+		using VA                                = SDL_GPUVertexAttribute;
+		constexpr static auto VERTEX_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+			  .offset      = sizeof(glm::vec3),
+			},
+		};
+
+		using VBD                                 = SDL_GPUVertexBufferDescription;
+		constexpr static auto VERTEX_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot       = 0,
+			  .pitch      = sizeof(line_vertex),
+			  .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+			},
+		};
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary        = io::read_file("shaders/debug_line.vs_6_4.cso"),
+			  .stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+			  .uniform_buffer_count = 1,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file("shaders/raw_triangle.ps_6_4.cso"),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			},
+			.vertex_attributes          = VERTEX_ATTRIBUTES,
+			.vertex_buffer_descriptions = VERTEX_BUFFER_DESCS,
+			.depth_test                 = true,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+			.depth_write                = false,
+			.blend_mode                 = sdl3::blend_mode_t::alpha,
+			.queue                      = sdl3::render_queue_t::transparent,
+			.primitive_type             = SDL_GPU_PRIMITIVETYPE_LINELIST,
+		};
+
+		auto rndr             = renderer{};
+		rndr.tested_pipeline  = sdl3::make_gfx_pipeline(ctx, desc);
+		desc.depth_compare    = SDL_GPU_COMPAREOP_ALWAYS; // keeps depth target, so it's compatible with scene pass
+		rndr.overlay_pipeline = sdl3::make_gfx_pipeline(ctx, desc);
+
+		rndr.vertex_buffer = sdl3::make_buffer(ctx.gpu.get(), SDL_GPU_BUFFERUSAGE_VERTEX, MAX_VERTICES * sizeof(line_vertex), "Debug Line Buffer"sv);
+
+		return rndr;
+	}
+
+	void destroy_renderer(renderer &rndr)
+	{
+		msg::info("Destroy Debug Draw Renderer.");
+
+		rndr = {};
+	}
+
+	// Gather all thread arenas in to upload ring, and clear them for next frame.
+	// Must be called before sdl3::begin_frame.
+	void prepare(const sdl3::context &ctx, renderer &rndr, sdl3::scene &scn)
+	{
+		auto arenas = std::scoped_lock(registry.lock);
+
+		// Counted once, lines other threads add after this are left for next frame
+		auto counts        = std::vector<std::array<uint32_t, DEPTH_MODES>>(registry.arenas.size());
+		auto vertex_count  = uint32_t{ 0 };
+		rndr.vertex_counts = {};
+		for (auto &&[arena, arena_counts] : std::views::zip(registry.arenas, counts))
+		{
+			auto lock = std::scoped_lock(arena->lock);
+			for (auto depth : std::views::iota(0u, DEPTH_MODES))
+			{
+				arena_counts[depth] = static_cast<uint32_t>(arena->lines[depth].size());
+				rndr.vertex_counts[depth] += arena_counts[depth];
+				vertex_count += arena_counts[depth];
+			}
+		}
+
+		if (vertex_count > MAX_VERTICES)
+		{
+			msg::error(false, "Too many debug line vertices this frame.");
+			rndr.vertex_counts = {};
+		}
+
+		auto dst = std::span<std::byte>{};
+		if (vertex_count > 0 and vertex_count <= MAX_VERTICES)
+		{
+			dst = sdl3::reserve_upload(ctx.gpu.get(), scn.uploads, vertex_count * sizeof(line_vertex), rndr.vertex_buffer.get(), 0, true);
+		}
+		if (dst.empty())
+		{
+			rndr.vertex_counts = {};
+		}
+
+		// Tested lines first, then overlay lines, only as many as were counted
+		auto offset = size_t{ 0 };
+		for (auto depth : std::views::iota(0u, DEPTH_MODES))
+		{
+			for (auto &&[arena, arena_counts] : std::views::zip(registry.arenas, counts))
+			{
+				auto lock   = std::scoped_lock(arena->lock);
+				auto &lines = arena->lines[depth];
+				auto count  = arena_counts[depth];
+
+				if (not dst.empty())
+				{
+					auto bytes = io::as_byte_span(std::span{ lines.data(), count });
+					std::memcpy(dst.data() + offset, bytes.data(), bytes.size());
+					offset += bytes.size();
+				}
+				lines.erase(lines.begin(), lines.begin() + count);
+			}
+		}
+	}
+
+	// Draw this frame's lines on top of scene color, using scene depth
+	void draw(sdl3::frame_context &frm, const renderer &rndr, const sdl3::scene &scn, const io::byte_span view_proj)
+	{
+		if (rndr.vertex_counts[0] + rndr.vertex_counts[1] == 0)
+			return;
+
+		SDL_PushGPUVertexUniformData(frm.cmd_buf, 0, view_proj.data(), static_cast<uint32_t>(view_proj.size()));
+
+		auto color_target = sdl3::scene_color_target(scn, SDL_GPU_LOADOP_LOAD);
+
+		auto depth_target = SDL_GPUDepthStencilTargetInfo{
+			.texture          = scn.depth_texture.get(),
+			.load_op          = SDL_GPU_LOADOP_LOAD,
+			.store_op         = SDL_GPU_STOREOP_STORE,
+			.stencil_load_op  = SDL_GPU_LOADOP_LOAD,
+			.stencil_store_op = SDL_GPU_STOREOP_STORE,
+		};
+
+		auto render_pass = SDL_BeginGPURenderPass(frm.cmd_buf, &color_target, 1, &depth_target);
+		{
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = rndr.vertex_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
+
+			auto [tested_count, overlay_count] = rndr.vertex_counts;
+			if (tested_count > 0)
+			{
+				SDL_BindGPUGraphicsPipeline(render_pass, rndr.tested_pipeline.get());
+				SDL_DrawGPUPrimitives(render_pass, tested_count, 1, 0, 0);
+				++frm.draw_calls;
+			}
+			if (overlay_count > 0)
+			{
+				SDL_BindGPUGraphicsPipeline(render_pass, rndr.overlay_pipeline.get());
+				SDL_DrawGPUPrimitives(render_pass, overlay_count, 1, tested_count, 0);
+				++frm.draw_calls;
+			}
+		}
+		SDL_EndGPURenderPass(render_pass);
+	}
+}
+#else
+export namespace dbg
+{
+	inline void line(const glm::vec3 &, const glm::vec3 &, uint32_t, depth_t = depth_t::tested) {}
+	inline void box(const glm::vec3 &, const glm::vec3 &, uint32_t, depth_t = depth_t::tested) {}
+	inline void box(const glm::mat4 &, uint32_t, depth_t = depth_t::tested) {}
+	inline void sphere(const glm::vec3 &, float, uint32_t, depth_t = depth_t::tested, uint32_t = 24) {}
+	inline void frustum(const glm::mat4 &, uint32_t, depth_t = depth_t::tested) {}
+
+	struct renderer
+	{
+	};
+
+	inline auto init_renderer(const sdl3::context &) -> renderer
+	{
+		return {};
+	}
+	inline void destroy_renderer(renderer &) {}
+	inline void prepare(const sdl3::context &, renderer &, sdl3::scene &) {}
+	inline void draw(sdl3::frame_context &, const renderer &, const sdl3::scene &, const io::byte_span) {}
+}
+#endif
@@ -0,0 +1,160 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module draw_instancing;
+
+import std;
+import logs;
+import io;
+import sdl3_scene;
+
+/*
+ * Automatic instancing of draws submitted one object at a time.
+ * Draws of same mesh with same pipeline are sorted next to each other, their constants are copied
+ * in to draw ring in that order, and each run becomes one instanced draw. Draw ring's id buffer
+ * already hands every instance it's own draw id from first_instance, so shaders are unchanged.
+ * Order between different meshes isn't kept, so it's for draws that don't depend on order, e.g. opaque ones.
+ */
+export namespace instancing
+{
+	// Indexed mesh in vertex and index buffers, offsets are in indices and vertices
+	struct mesh_ref
+	{
+		SDL_GPUBuffer *vertices;
+		SDL_GPUBuffer *indices;
+		uint32_t index_count;
+		uint32_t first_index;
+		int32_t vertex_offset;
+
+		auto operator==(const mesh_ref &) const -> bool = default;
+	};
+
+	struct object_draw
+	{
+		SDL_GPUGraphicsPipeline *pipeline;
+		mesh_ref mesh;
+		sdl3::draw_data constants; // material is per object data, so it doesn't split runs
+	};
+
+	// Run of objects drawn as instances first_draw to first_draw + count of draw ring
+	struct merged_draw
+	{
+		SDL_GPUGraphicsPipeline *pipeline;
+		mesh_ref mesh;
+		uint32_t first_draw;
+		uint32_t count;
+	};
+
+	struct draw_list
+	{
+		std::vector<object_draw> objects; // submitted this frame
+		std::vector<uint32_t> order;      // objects sorted by pipeline and mesh
+		std::vector<merged_draw> merged;  // from merge_draws, drawn by draw_merged
+	};
+
+	void submit(draw_list &list, SDL_GPUGraphicsPipeline *pipeline, const mesh_ref &mesh, const sdl3::draw_data &constants)
+	{
+		list.objects.push_back({ pipeline, mesh, constants });
+	}
+
+	// Pipeline first, as it's the most expensive to change, then buffers, then range in them
+	auto sort_key(const object_draw &obj)
+	{
+		auto address = [](const void *ptr) { return reinterpret_cast<std::uintptr_t>(ptr); };
+		return std::tuple{ address(obj.pipeline), address(obj.mesh.vertices), address(obj.mesh.indices),
+			               obj.mesh.first_index, obj.mesh.index_count, obj.mesh.vertex_offset };
+	}
+
+	// Sort this frame's objects, write their constants in to draw ring in that order, and merge runs.
+	// Objects are cleared for next frame's submits. Call once per frame, before begin_frame.
+	void merge_draws(SDL_GPUDevice *gpu, sdl3::upload_ring &uploads, sdl3::draw_ring &ring, draw_list &list)
+	{
+		list.merged.clear();
+		if (list.objects.empty())
+			return;
+
+		// Stable, so objects of a run keep submit order
+		list.order.resize(list.objects.size());
+		std::ranges::iota(list.order, 0u);
+		std::ranges::stable_sort(list.order, {}, [&](uint32_t i) { return sort_key(list.objects[i]); });
+
+		auto batch = sdl3::reserve_draws(gpu, uploads, ring, static_cast<uint32_t>(list.objects.size()));
+		msg::error(batch.draws.size() == list.objects.size(), "Upload ring is out of space for draw constants.");
+		if (batch.draws.size() != list.objects.size())
+		{
+			// Nothing is drawn this frame, rather than writing past reserved constants
+			list.objects.clear();
+			return;
+		}
+
+		for (auto &&[slot, i] : list.order | std::views::enumerate)
+		{
+			auto &obj         = list.objects[i];
+			batch.draws[slot] = obj.constants;
+
+			auto draw_id = batch.first_draw + static_cast<uint32_t>(slot);
+			if (not list.merged.empty() and list.merged.back().pipeline == obj.pipeline and list.merged.back().mesh == obj.mesh)
+			{
+				++list.merged.back().count;
+				continue;
+			}
+			list.merged.push_back({
+			  .pipeline   = obj.pipeline,
+			  .mesh       = obj.mesh,
+			  .first_draw = draw_id,
+			  .count      = 1,
+			});
+		}
+
+		list.objects.clear();
+	}
+
+	// Record merged draws, pipeline and buffers are bound only when they change.
+	// Pipelines read draw ids from vertex buffer id_slot, see sdl3::bind_draw_ring. Returns number of draw calls.
+	auto draw_merged(SDL_GPURenderPass *render_pass, const sdl3::draw_ring &ring, const draw_list &list, uint32_t id_slot) -> uint32_t
+	{
+		if (list.merged.empty())
+			return 0;
+
+		sdl3::bind_draw_ring(render_pass, ring, id_slot);
+
+		auto pipeline = static_cast<SDL_GPUGraphicsPipeline *>(nullptr);
+		auto vertices = static_cast<SDL_GPUBuffer *>(nullptr);
+		auto indices  = static_cast<SDL_GPUBuffer *>(nullptr);
+		for (auto &&draw : list.merged)
+		{
+			if (draw.pipeline != pipeline)
+			{
+				pipeline = draw.pipeline;
+				SDL_BindGPUGraphicsPipeline(render_pass, pipeline);
+			}
+
+			if (draw.mesh.vertices != vertices)
+			{
+				vertices     = draw.mesh.vertices;
+				auto binding = SDL_GPUBufferBinding{
+					.buffer = vertices,
+					.offset = 0,
+				};
+				SDL_BindGPUVertexBuffers(render_pass, 0, &binding, 1);
+			}
+
+			if (draw.mesh.indices != indices)
+			{
+				indices      = draw.mesh.indices;
+				auto binding = SDL_GPUBufferBinding{
+					.buffer = indices,
+					.offset = 0,
+				};
+				SDL_BindGPUIndexBuffer(render_pass, &binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+			}
+
+			SDL_DrawGPUIndexedPrimitives(render_pass, draw.mesh.index_count, draw.count,
+			                             draw.mesh.first_index, draw.mesh.vertex_offset, draw.first_draw);
+		}
+
+		return static_cast<uint32_t>(list.merged.size());
+	}
+}
@@ -0,0 +1,394 @@
+module;
+
+// SSE2 is baseline on x64, other targets decode one value at a time
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CODEC_SSE2 1
+#else
+#define CODEC_SSE2 0
+#endif
+
+export module geometry_codec;
+
+import std;
+import io;
+
+/*
+ * Lossless codec for vertex and index streams, for smaller asset files and disk reads.
+ * Vertices: each 32 bit word is stored as zigzag delta from same word of previous vertex,
+ * in blocks of 16 vertices, split in to byte planes with all zero planes left out.
+ * Indices: triangles that share an edge with a recent one store only their third vertex,
+ * and vertices are mostly next unused one, or one seen recently, so most triangles take one byte.
+ * Decoders write straight in to caller's memory, usually upload staging memory.
+ */
+export namespace codec
+{
+	constexpr auto BLOCK_SIZE = 16u; // vertices per block, one SSE register per byte plane
+
+	auto zigzag(uint32_t v) -> uint32_t
+	{
+		return (v << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(v) >> 31);
+	}
+
+	auto unzigzag(uint32_t v) -> uint32_t
+	{
+		return (v >> 1) ^ (0u - (v & 1u));
+	}
+
+	// Per block and word: one byte with a bit per present byte plane, then present planes, 16 bytes each
+	auto encode_vertices(io::byte_span vertices, uint32_t stride) -> io::byte_array
+	{
+		auto words = stride / 4;
+		auto count = static_cast<uint32_t>(vertices.size() / stride);
+
+		auto word_at = [&](uint32_t vertex, uint32_t word) {
+			auto value = uint32_t{ 0 };
+			std::memcpy(&value, vertices.data() + uint64_t{ vertex } * stride + word * 4, sizeof(value));
+			return value;
+		};
+
+		auto out = io::byte_array{};
+		out.reserve(vertices.size());
+
+		for (auto first = 0u; first < count; first += BLOCK_SIZE)
+		{
+			for (auto word = 0u; word < words; ++word)
+			{
+				auto deltas = std::array<uint32_t, BLOCK_SIZE>{};
+				for (auto i = 0u; i < BLOCK_SIZE and first + i < count; ++i)
+				{
+					auto previous = (first + i == 0) ? 0u : word_at(first + i - 1, word);
+					deltas[i]     = zigzag(word_at(first + i, word) - previous);
+				}
+
+				auto planes = std::array<std::array<std::byte, BLOCK_SIZE>, 4>{};
+				auto mask   = uint8_t{ 0 };
+				for (auto plane = 0u; plane < 4; ++plane)
+				{
+					for (auto i = 0u; i < BLOCK_SIZE; ++i)
+						planes[plane][i] = static_cast<std::byte>(deltas[i] >> (plane * 8));
+
+					if (std::ranges::any_of(planes[plane], [](std::byte b) { return b != std::byte{ 0 }; }))
+						mask |= static_cast<uint8_t>(1u << plane);
+				}
+
+				out.push_back(static_cast<std::byte>(mask));
+				for (auto plane = 0u; plane < 4; ++plane)
+				{
+					if (mask & (1u << plane))
+						out.insert(out.end(), planes[plane].begin(), planes[plane].end());
+				}
+			}
+		}
+
+		return out;
+	}
+
+	// Block's deltas of one word, back to values, previous is value of word in vertex before block
+	void decode_word_scalar(const std::array<const std::byte *, 4> &planes, uint32_t &previous, std::span<uint32_t, BLOCK_SIZE> values)
+	{
+		for (auto i = 0u; i < BLOCK_SIZE; ++i)
+		{
+			auto delta = uint32_t{ 0 };
+			for (auto plane = 0u; plane < 4; ++plane)
+			{
+				if (planes[plane] != nullptr)
+					delta |= std::to_integer<uint32_t>(planes[plane][i]) << (plane * 8);
+			}
+			previous += unzigzag(delta);
+			values[i] = previous;
+		}
+	}
+
+#if CODEC_SSE2
+	// Byte planes are interleaved back in to 32 bit values, unzigzagged, and prefix summed 4 lanes at a time
+	void decode_word_sse2(const std::array<const std::byte *, 4> &planes, uint32_t &previous, std::span<uint32_t, BLOCK_SIZE> values)
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto one  = _mm_set1_epi32(1);
+
+		auto load = [&](uint32_t plane) {
+			return planes[plane] == nullptr ? zero : _mm_loadu_si128(reinterpret_cast<const __m128i *>(planes[plane]));
+		};
+		auto p0 = load(0), p1 = load(1), p2 = load(2), p3 = load(3);
+
+		auto lo01 = _mm_unpacklo_epi8(p0, p1);
+		auto hi01 = _mm_unpackhi_epi8(p0, p1);
+		auto lo23 = _mm_unpacklo_epi8(p2, p3);
+		auto hi23 = _mm_unpackhi_epi8(p2, p3);
+
+		auto deltas = std::array{
+			_mm_unpacklo_epi16(lo01, lo23),
+			_mm_unpackhi_epi16(lo01, lo23),
+			_mm_unpacklo_epi16(hi01, hi23),
+			_mm_unpackhi_epi16(hi01, hi23),
+		};
+
+		auto carry = _mm_set1_epi32(static_cast<int32_t>(previous));
+		for (auto &&[i, v] : deltas | std::views::enumerate)
+		{
+			v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(zero, _mm_and_si128(v, one)));
+			v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+			v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+			v = _mm_add_epi32(v, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(values.data() + i * 4), v);
+			carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+		}
+		previous = values.back();
+	}
+#endif
+
+	// Decode count vertices of stride bytes in to out, false if encoded data is short or malformed
+	auto decode_vertices(io::byte_span encoded, uint32_t count, uint32_t stride, std::span<std::byte> out) -> bool
+	{
+		auto words = stride / 4;
+		if (stride % 4 != 0 or out.size() < uint64_t{ count } * stride)
+			return false;
+
+		auto previous = std::vector<uint32_t>(words, 0u);
+		auto values   = std::array<uint32_t, BLOCK_SIZE>{};
+		auto pos      = size_t{ 0 };
+
+		for (auto first = 0u; first < count; first += BLOCK_SIZE)
+		{
+			auto block = std::min(BLOCK_SIZE, count - first);
+			for (auto word = 0u; word < words; ++word)
+			{
+				if (pos >= encoded.size())
+					return false;
+
+				auto mask = std::to_integer<uint32_t>(encoded[pos++]);
+				if (mask > 0xF)
+					return false;
+
+				auto planes = std::array<const std::byte *, 4>{};
+				for (auto plane = 0u; plane < 4; ++plane)
+				{
+					if (not(mask & (1u << plane)))
+						continue;
+					if (encoded.size() - pos < BLOCK_SIZE)
+						return false;
+
+					planes[plane] = encoded.data() + pos;
+					pos += BLOCK_SIZE;
+				}
+#if CODEC_SSE2
+				decode_word_sse2(planes, previous[word], values);
+#else
+				decode_word_scalar(planes, previous[word], values);
+#endif
+				// Padding past last vertex decodes to zero deltas, next block starts from last real vertex
+				previous[word] = values[block - 1];
+
+				auto dst = out.data() + uint64_t{ first } * stride + word * 4;
+				for (auto i = 0u; i < block; ++i)
+					std::memcpy(dst + uint64_t{ i } * stride, &values[i], sizeof(uint32_t));
+			}
+		}
+
+		return pos == encoded.size();
+	}
+
+	// Edge and vertex FIFOs, encoder and decoder update them the same way
+	constexpr auto EDGE_FIFO_CODES   = 15u; // low nibble 0-14 is an edge, 15 is none
+	constexpr auto VERTEX_FIFO_CODES = 14u; // high nibble 0 is next vertex, 1-14 a recent one, 15 explicit
+	constexpr auto CODE_NEXT         = 0u;
+	constexpr auto CODE_EXPLICIT     = 15u;
+	constexpr auto NO_EDGE           = 15u;
+
+	struct index_state
+	{
+		std::array<std::array<uint32_t, 2>, 16> edges{};
+		std::array<uint32_t, 16> vertices{};
+		uint32_t edge_head   = 0;
+		uint32_t vertex_head = 0;
+		uint32_t next        = 0; // vertex that CODE_NEXT stands for
+		uint32_t last        = 0; // explicit vertices are deltas from last one
+	};
+
+	auto recent_edge(const index_state &st, uint32_t i) -> const std::array<uint32_t, 2> &
+	{
+		return st.edges[(st.edge_head - 1 - i) & 15];
+	}
+
+	auto recent_vertex(const index_state &st, uint32_t i) -> uint32_t
+	{
+		return st.vertices[(st.vertex_head - 1 - i) & 15];
+	}
+
+	void push_vertex(index_state &st, uint32_t v)
+	{
+		st.vertices[st.vertex_head++ & 15] = v;
+	}
+
+	// Reversed edges, as neighbouring triangle walks shared edge the other way
+	void push_triangle(index_state &st, uint32_t a, uint32_t b, uint32_t c)
+	{
+		st.edges[st.edge_head++ & 15] = { b, a };
+		st.edges[st.edge_head++ & 15] = { c, b };
+		st.edges[st.edge_head++ & 15] = { a, c };
+	}
+
+	void write_varint(io::byte_array &out, uint32_t v)
+	{
+		while (v >= 0x80)
+		{
+			out.push_back(static_cast<std::byte>((v & 0x7F) | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<std::byte>(v));
+	}
+
+	auto read_varint(io::byte_span in, size_t &pos) -> std::optional<uint32_t>
+	{
+		auto v = uint32_t{ 0 };
+		for (auto shift = 0u; shift < 35; shift += 7)
+		{
+			if (pos >= in.size())
+				return std::nullopt;
+
+			auto b = std::to_integer<uint32_t>(in[pos++]);
+			v |= (b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				return v;
+		}
+		return std::nullopt;
+	}
+
+	// Nibble code for vertex, explicit ones are queued for writing after triangle's code bytes
+	auto encode_vertex(index_state &st, uint32_t v, std::vector<uint32_t> &explicit_values) -> uint32_t
+	{
+		if (v == st.next)
+		{
+			++st.next;
+			push_vertex(st, v);
+			return CODE_NEXT;
+		}
+
+		for (auto i = 0u; i < VERTEX_FIFO_CODES; ++i)
+		{
+			if (recent_vertex(st, i) == v)
+				return i + 1;
+		}
+
+		explicit_values.push_back(zigzag(v - st.last));
+		st.last = v;
+		push_vertex(st, v);
+		return CODE_EXPLICIT;
+	}
+
+	// Triangles may come out rotated, winding and so facing are kept
+	auto encode_indices(std::span<const uint32_t> indices) -> io::byte_array
+	{
+		auto st  = index_state{};
+		auto out = io::byte_array{};
+		out.reserve(indices.size());
+
+		auto explicit_values = std::vector<uint32_t>{};
+		for (auto t = size_t{ 0 }; t + 3 <= indices.size(); t += 3)
+		{
+			auto tri = std::array{ indices[t], indices[t + 1], indices[t + 2] };
+			explicit_values.clear();
+
+			auto edge = NO_EDGE;
+			for (auto rotation = 0u; rotation < 3 and edge == NO_EDGE; ++rotation)
+			{
+				for (auto i = 0u; i < EDGE_FIFO_CODES; ++i)
+				{
+					if (recent_edge(st, i) == std::array{ tri[0], tri[1] })
+					{
+						edge = i;
+						break;
+					}
+				}
+				if (edge == NO_EDGE)
+					std::ranges::rotate(tri, tri.begin() + 1);
+			}
+
+			if (edge != NO_EDGE)
+			{
+				auto code = encode_vertex(st, tri[2], explicit_values);
+				out.push_back(static_cast<std::byte>((code << 4) | edge));
+			}
+			else
+			{
+				tri = { indices[t], indices[t + 1], indices[t + 2] };
+
+				auto code_a = encode_vertex(st, tri[0], explicit_values);
+				auto code_b = encode_vertex(st, tri[1], explicit_values);
+				auto code_c = encode_vertex(st, tri[2], explicit_values);
+				out.push_back(static_cast<std::byte>((code_c << 4) | NO_EDGE));
+				out.push_back(static_cast<std::byte>((code_a << 4) | code_b));
+			}
+
+			for (auto v : explicit_values)
+				write_varint(out, v);
+			push_triangle(st, tri[0], tri[1], tri[2]);
+		}
+
+		return out;
+	}
+
+	auto decode_vertex(index_state &st, uint32_t code, io::byte_span in, size_t &pos) -> std::optional<uint32_t>
+	{
+		if (code == CODE_NEXT)
+		{
+			push_vertex(st, st.next);
+			return st.next++;
+		}
+		if (code != CODE_EXPLICIT)
+			return recent_vertex(st, code - 1);
+
+		auto delta = read_varint(in, pos);
+		if (not delta)
+			return std::nullopt;
+
+		st.last += unzigzag(*delta);
+		push_vertex(st, st.last);
+		return st.last;
+	}
+
+	// Decode index_count indices in to out, false if data is malformed or an index isn't below vertex_count
+	auto decode_indices(io::byte_span encoded, uint32_t index_count, uint32_t vertex_count, std::span<std::byte> out) -> bool
+	{
+		if (index_count % 3 != 0 or out.size() < uint64_t{ index_count } * sizeof(uint32_t))
+			return false;
+
+		auto st  = index_state{};
+		auto pos = size_t{ 0 };
+		for (auto t = 0u; t < index_count; t += 3)
+		{
+			if (pos >= encoded.size())
+				return false;
+
+			auto code = std::to_integer<uint32_t>(encoded[pos++]);
+			auto edge = code & 0xF;
+			auto tri  = std::array<std::optional<uint32_t>, 3>{};
+
+			if (edge != NO_EDGE)
+			{
+				auto [a, b] = recent_edge(st, edge);
+				tri         = { a, b, decode_vertex(st, code >> 4, encoded, pos) };
+			}
+			else
+			{
+				if (pos >= encoded.size())
+					return false;
+
+				auto codes = std::to_integer<uint32_t>(encoded[pos++]);
+				tri[0]     = decode_vertex(st, codes >> 4, encoded, pos);
+				tri[1]     = tri[0] ? decode_vertex(st, codes & 0xF, encoded, pos) : std::nullopt;
+				tri[2]     = tri[1] ? decode_vertex(st, code >> 4, encoded, pos) : std::nullopt;
+			}
+
+			if (not std::ranges::all_of(tri, [&](const std::optional<uint32_t> &v) { return v and *v < vertex_count; }))
+				return false;
+
+			auto values = std::array{ *tri[0], *tri[1], *tri[2] };
+			std::memcpy(out.data() + uint64_t{ t } * sizeof(uint32_t), values.data(), sizeof(values));
+			push_triangle(st, values[0], values[1], values[2]);
+		}
+
+		return pos == encoded.size();
+	}
+}
@@ -0,0 +1,845 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module geometry_residency;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import batch;
+import buffer_pool;
+import geometry_codec;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Mesh levels of detail streamed from a packed archive in to shared vertex and index pools.
+ * Every mesh's coarsest level is loaded up front and never leaves, finer ones are read on demand,
+ * and least recently drawn ones are evicted to keep streamed geometry under a budget.
+ * A mesh whose wanted level isn't in yet draws with nearest one that is.
+ * Levels are stored encoded, workers read only encoded bytes, and they're decoded straight in to upload memory.
+ * Quantized archives are uploaded as they're stored instead, and expanded in to pools by a compute pass.
+ */
+export namespace geo
+{
+	// "GEOA", little endian
+	constexpr auto ARCHIVE_MAGIC   = uint32_t{ 0x414F4547 };
+	constexpr auto ARCHIVE_VERSION = uint32_t{ 3 }; // 2: levels are encoded with geometry_codec, 3: or quantized
+
+	constexpr auto LOD_COUNT  = 3u;
+	constexpr auto PINNED_LOD = LOD_COUNT - 1; // coarsest, always resident
+
+	// Same layout as textured mesh pipeline's vertex stream
+	struct vertex
+	{
+		std::array<float, 3> pos;
+		std::array<float, 2> uv;
+	};
+
+	struct mesh_data
+	{
+		std::vector<vertex> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	enum class encoding_t : uint32_t
+	{
+		codec,     // lossless, decoded on CPU
+		quantized, // 16 bit positions and uvs, 16 bit indices, expanded on GPU
+	};
+
+	// Archive starts with header, then mesh_count * LOD_COUNT entries, then each level's encoded vertices followed by it's encoded indices
+	struct archive_header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t mesh_count;
+		uint32_t lod_count;
+		encoding_t encoding;
+	};
+
+	// Quantized values are 0 to 65535 across level's bounds
+	struct quantization
+	{
+		std::array<float, 3> pos_min;
+		std::array<float, 3> pos_extent;
+		std::array<float, 2> uv_min;
+		std::array<float, 2> uv_extent;
+	};
+
+	// Quantized vertex, x y | z u | v, padded to 3 words as GPU reads whole words
+	struct packed_vertex
+	{
+		std::array<uint16_t, 6> values;
+	};
+
+	struct lod_entry
+	{
+		uint64_t offset; // from start of file
+		uint32_t vertex_count;
+		uint32_t index_count;
+		uint32_t vertex_bytes; // encoded sizes in file
+		uint32_t index_bytes;
+		quantization quant;    // quantized archives only
+	};
+
+	// Size once decoded in to pools
+	auto byte_size(const lod_entry &entry) -> uint32_t
+	{
+		return entry.vertex_count * static_cast<uint32_t>(sizeof(vertex)) + entry.index_count * static_cast<uint32_t>(sizeof(uint32_t));
+	}
+
+	// Level as it's stored, decoded when it's placed in pools
+	struct encoded_lod
+	{
+		uint32_t vertex_count;
+		uint32_t index_count;
+		io::byte_array vertices;
+		io::byte_array indices;
+		quantization quant;
+	};
+
+	// Positions and uvs to 16 bits across level's bounds, indices to 16 bits, two per word
+	auto quantize_lod(const mesh_data &data) -> encoded_lod
+	{
+		msg::error(data.vertices.size() <= 0x10000, "Quantized level has too many vertices for 16 bit indices.");
+
+		auto quant  = quantization{};
+		auto bounds = [&](auto member, uint32_t axis) {
+			auto values = data.vertices | std::views::transform([&](const vertex &v) { return std::invoke(member, v)[axis]; });
+			return std::ranges::minmax(values);
+		};
+		for (auto axis : std::views::iota(0u, 3u))
+		{
+			auto [lo, hi]          = bounds(&vertex::pos, axis);
+			quant.pos_min[axis]    = lo;
+			quant.pos_extent[axis] = hi - lo;
+		}
+		for (auto axis : std::views::iota(0u, 2u))
+		{
+			auto [lo, hi]         = bounds(&vertex::uv, axis);
+			quant.uv_min[axis]    = lo;
+			quant.uv_extent[axis] = hi - lo;
+		}
+
+		auto to_unorm16 = [](float value, float min, float extent) {
+			auto t = (extent > 0.0f) ? (value - min) / extent : 0.0f;
+			return static_cast<uint16_t>(std::lround(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+		};
+
+		auto vertices = data.vertices
+		              | std::views::transform([&](const vertex &v) {
+				            return packed_vertex{ {
+								to_unorm16(v.pos[0], quant.pos_min[0], quant.pos_extent[0]),
+								to_unorm16(v.pos[1], quant.pos_min[1], quant.pos_extent[1]),
+								to_unorm16(v.pos[2], quant.pos_min[2], quant.pos_extent[2]),
+								to_unorm16(v.uv[0], quant.uv_min[0], quant.uv_extent[0]),
+								to_unorm16(v.uv[1], quant.uv_min[1], quant.uv_extent[1]),
+								0,
+							} };
+			            })
+		              | std::ranges::to<std::vector>();
+
+		// Odd count is padded with a zero, so indices fill whole words
+		auto indices = data.indices
+		             | std::views::transform([](uint32_t index) { return static_cast<uint16_t>(index); })
+		             | std::ranges::to<std::vector>();
+		indices.resize((indices.size() + 1) / 2 * 2, 0);
+
+		auto vertex_bytes = io::as_byte_span(vertices);
+		auto index_bytes  = io::as_byte_span(indices);
+		return {
+			.vertex_count = static_cast<uint32_t>(data.vertices.size()),
+			.index_count  = static_cast<uint32_t>(data.indices.size()),
+			.vertices     = { vertex_bytes.begin(), vertex_bytes.end() },
+			.indices      = { index_bytes.begin(), index_bytes.end() },
+			.quant        = quant,
+		};
+	}
+
+	auto encode_lod(const mesh_data &data, encoding_t encoding) -> encoded_lod
+	{
+		if (encoding == encoding_t::quantized)
+			return quantize_lod(data);
+
+		return {
+			.vertex_count = static_cast<uint32_t>(data.vertices.size()),
+			.index_count  = static_cast<uint32_t>(data.indices.size()),
+			.vertices     = codec::encode_vertices(io::as_byte_span(data.vertices), sizeof(vertex)),
+			.indices      = codec::encode_indices(data.indices),
+			.quant        = {},
+		};
+	}
+
+	// Table of contents, level data is read on demand
+	struct archive
+	{
+		std::filesystem::path filename;
+		uint32_t mesh_count;
+		encoding_t encoding;
+		std::vector<lod_entry> entries; // mesh * LOD_COUNT + lod
+	};
+
+	auto entry_of(const archive &arc, uint32_t mesh, uint32_t lod) -> const lod_entry &
+	{
+		return arc.entries.at(mesh * LOD_COUNT + lod);
+	}
+
+	auto write_archive(const std::filesystem::path &filename, std::span<const std::array<encoded_lod, LOD_COUNT>> meshes, encoding_t encoding) -> bool
+	{
+		auto header = archive_header{
+			.magic      = ARCHIVE_MAGIC,
+			.version    = ARCHIVE_VERSION,
+			.mesh_count = static_cast<uint32_t>(meshes.size()),
+			.lod_count  = LOD_COUNT,
+			.encoding   = encoding,
+		};
+
+		auto entries = std::vector<lod_entry>{};
+		auto offset  = sizeof(archive_header) + meshes.size() * LOD_COUNT * sizeof(lod_entry);
+		for (auto &&lod : meshes | std::views::join)
+		{
+			auto entry = lod_entry{
+				.offset       = offset,
+				.vertex_count = lod.vertex_count,
+				.index_count  = lod.index_count,
+				.vertex_bytes = static_cast<uint32_t>(lod.vertices.size()),
+				.index_bytes  = static_cast<uint32_t>(lod.indices.size()),
+				.quant        = lod.quant,
+			};
+			entries.push_back(entry);
+			offset += entry.vertex_bytes + entry.index_bytes;
+		}
+
+		auto file = std::ofstream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (not file.good())
+			return false;
+
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(lod_entry)));
+		for (auto &&lod : meshes | std::views::join)
+		{
+			file.write(reinterpret_cast<const char *>(lod.vertices.data()), static_cast<std::streamsize>(lod.vertices.size()));
+			file.write(reinterpret_cast<const char *>(lod.indices.data()), static_cast<std::streamsize>(lod.indices.size()));
+		}
+
+		return file.good();
+	}
+
+	// Header and table of contents only
+	auto open_archive(const std::filesystem::path &filename) -> std::optional<archive>
+	{
+		auto file = std::ifstream(filename, std::ios::in | std::ios::binary);
+		if (not file.good())
+			return std::nullopt;
+
+		auto header = archive_header{};
+		file.read(reinterpret_cast<char *>(&header), sizeof(header));
+		if (not file.good() or header.magic != ARCHIVE_MAGIC or header.version != ARCHIVE_VERSION or header.lod_count != LOD_COUNT)
+			return std::nullopt;
+
+		auto arc = archive{
+			.filename   = filename,
+			.mesh_count = header.mesh_count,
+			.encoding   = header.encoding,
+			.entries    = std::vector<lod_entry>(header.mesh_count * LOD_COUNT),
+		};
+		file.read(reinterpret_cast<char *>(arc.entries.data()), static_cast<std::streamsize>(arc.entries.size() * sizeof(lod_entry)));
+		if (not file.good())
+			return std::nullopt;
+
+		return arc;
+	}
+
+	// One level's encoded vertices and indices. Doesn't log, it's called from worker threads.
+	auto read_lod(const archive &arc, uint32_t mesh, uint32_t lod) -> std::optional<encoded_lod>
+	{
+		auto &entry = entry_of(arc, mesh, lod);
+
+		auto file = std::ifstream(arc.filename, std::ios::in | std::ios::binary);
+		file.seekg(static_cast<std::streamoff>(entry.offset));
+
+		auto data = encoded_lod{
+			.vertex_count = entry.vertex_count,
+			.index_count  = entry.index_count,
+			.vertices     = io::byte_array(entry.vertex_bytes),
+			.indices      = io::byte_array(entry.index_bytes),
+			.quant        = entry.quant,
+		};
+		file.read(reinterpret_cast<char *>(data.vertices.data()), static_cast<std::streamsize>(data.vertices.size()));
+		file.read(reinterpret_cast<char *>(data.indices.data()), static_cast<std::streamsize>(data.indices.size()));
+		if (not file.good())
+			return std::nullopt;
+
+		return data;
+	}
+
+	// Tower with superellipse cross-section, tapered and twisted, capped on top.
+	// segments around and rings up set level of detail, shape comes from seed alone.
+	auto make_tower(uint32_t seed, uint32_t segments, uint32_t rings) -> mesh_data
+	{
+		auto rng  = std::mt19937{ seed };
+		auto unit = std::uniform_real_distribution<float>{ 0.0f, 1.0f };
+
+		auto radius   = 1.5f + 2.0f * unit(rng);
+		auto height   = 6.0f + 16.0f * unit(rng) * unit(rng);
+		auto exponent = 0.5f + 3.5f * unit(rng); // 2 is a circle, lower is star like, higher is boxy
+		auto taper    = 0.3f + 0.7f * unit(rng); // top radius relative to bottom
+		auto twist    = (unit(rng) - 0.5f) * std::numbers::pi_v<float>;
+
+		auto outline = [&](float angle, float v) {
+			auto c = std::cosf(angle);
+			auto s = std::sinf(angle);
+			auto r = radius * (1.0f + (taper - 1.0f) * v)
+			       * std::powf(std::powf(std::abs(c), exponent) + std::powf(std::abs(s), exponent), -1.0f / exponent);
+			return std::array{ r * std::cosf(angle + twist * v), v * height, r * std::sinf(angle + twist * v) };
+		};
+
+		auto msh = mesh_data{};
+
+		// Walls, seam column is duplicated so uv wraps
+		for (auto [ring, segment] : std::views::cartesian_product(std::views::iota(0u, rings + 1), std::views::iota(0u, segments + 1)))
+		{
+			auto u     = static_cast<float>(segment) / segments;
+			auto v     = static_cast<float>(ring) / rings;
+			auto angle = 2.0f * std::numbers::pi_v<float> * u;
+			msh.vertices.push_back({ outline(angle, v), { u * 4.0f, (1.0f - v) * height * 0.25f } });
+		}
+
+		// Wound like app::make_cube, back faces are culled counter clockwise
+		auto columns = segments + 1;
+		for (auto [ring, segment] : std::views::cartesian_product(std::views::iota(0u, rings), std::views::iota(0u, segments)))
+		{
+			auto a = ring * columns + segment;
+			auto b = a + columns;
+			auto c = b + 1;
+			auto d = a + 1;
+			msh.indices.insert(msh.indices.end(), { a, c, b, a, d, c });
+		}
+
+		// Cap, fan around centre
+		auto centre = static_cast<uint32_t>(msh.vertices.size());
+		msh.vertices.push_back({ { 0.0f, height, 0.0f }, { 0.5f, 0.5f } });
+		for (auto segment : std::views::iota(0u, segments + 1))
+		{
+			auto angle = 2.0f * std::numbers::pi_v<float> * segment / segments;
+			msh.vertices.push_back({ outline(angle, 1.0f), { 0.5f + 0.5f * std::cosf(angle), 0.5f + 0.5f * std::sinf(angle) } });
+		}
+		for (auto segment : std::views::iota(0u, segments))
+		{
+			msh.indices.insert(msh.indices.end(), { centre, centre + 1 + segment, centre + 2 + segment });
+		}
+
+		return msh;
+	}
+
+	// Segments around and rings up of each level, finest first
+	constexpr auto TOWER_DETAIL = std::array{
+		std::array{ 48u, 24u },
+		std::array{ 16u, 6u },
+		std::array{ 6u, 1u },
+	};
+	static_assert(TOWER_DETAIL.size() == LOD_COUNT);
+
+	// Write archive of mesh_count towers if file isn't there yet, stands in for an offline asset build
+	void bake_archive(const std::filesystem::path &filename, uint32_t mesh_count, uint32_t seed, encoding_t encoding)
+	{
+		if (auto arc = open_archive(filename); arc and arc->mesh_count == mesh_count and arc->encoding == encoding)
+			return;
+
+		auto meshes = std::vector<std::array<encoded_lod, LOD_COUNT>>(mesh_count);
+		auto bakers = batch::worker_pool{};
+		batch::start_workers(bakers, std::max(std::thread::hardware_concurrency(), 1u));
+
+		for (auto mesh : std::views::iota(0u, mesh_count))
+		{
+			batch::submit(bakers, [&, mesh] {
+				for (auto lod : std::views::iota(0u, LOD_COUNT))
+				{
+					auto [segments, rings] = TOWER_DETAIL.at(lod);
+					meshes[mesh][lod]      = encode_lod(make_tower(seed + mesh, segments, rings), encoding);
+				}
+			}, 64);
+		}
+
+		batch::wait_idle(bakers);
+		batch::stop_workers(bakers);
+
+		auto raw_bytes     = uint64_t{ 0 };
+		auto encoded_bytes = uint64_t{ 0 };
+		for (auto &&lod : meshes | std::views::join)
+		{
+			raw_bytes += lod.vertex_count * sizeof(vertex) + lod.index_count * sizeof(uint32_t);
+			encoded_bytes += lod.vertices.size() + lod.indices.size();
+		}
+
+		msg::error(write_archive(filename, meshes, encoding), "Failed to write geometry archive.");
+		msg::info(std::format("Geometry: baked {} meshes in to {}, {} KiB encoded from {} KiB.",
+		                      mesh_count, filename.string(), encoded_bytes / 1024, raw_bytes / 1024));
+	}
+
+	enum class residency_t : uint8_t
+	{
+		absent,
+		loading, // read on a worker, or waiting for it's turn to upload
+		resident,
+	};
+
+	// Result of placing a level, no_room is worth retrying next frame, corrupt needs another read
+	enum class placement_t : uint8_t
+	{
+		placed,
+		no_room, // pools or upload ring are full
+		corrupt, // level doesn't decode
+	};
+
+	struct lod_slot
+	{
+		residency_t state = residency_t::absent;
+		pool::range vertices;
+		pool::range indices;
+		uint64_t last_visible = 0; // frame that last drew, or asked for, this level
+	};
+
+	struct residency_desc
+	{
+		std::filesystem::path archive;
+		uint32_t budget_bytes          = 8 * 1024 * 1024; // streamed levels, pinned ones aren't counted
+		uint32_t loader_threads        = 2;
+		uint32_t max_loads_in_flight   = 16;
+		uint32_t max_uploads_per_frame = 8;
+	};
+
+	struct stats
+	{
+		uint32_t loads;
+		uint32_t evictions;
+		uint32_t failed;
+		uint32_t deferred;       // placements retried next frame, as pools or upload ring had no room though budget allowed it
+		uint64_t fallbacks;      // draws that used another level than wanted one, as it wasn't resident
+		uint64_t uploaded_bytes; // staged for upload, decoded size for codec levels, stored size for quantized ones
+	};
+
+	constexpr auto EXPAND_GROUP_SIZE = 64u; // threads per group in geometry_expand.cs.hlsl
+
+	// Uniforms of one level's expansion, layout matches geometry_expand.cs.hlsl, offsets are in bytes
+	struct expand_params
+	{
+		std::array<float, 3> pos_min;
+		uint32_t packed_vertices;
+		std::array<float, 3> pos_extent;
+		uint32_t packed_indices;
+		std::array<float, 2> uv_min;
+		std::array<float, 2> uv_extent;
+		uint32_t vertices;
+		uint32_t indices;
+		uint32_t vertex_count;
+		uint32_t index_count;
+	};
+
+	struct expand_job
+	{
+		expand_params params;
+		pool::range packed;
+	};
+
+	struct residency
+	{
+		struct loaded_lod
+		{
+			uint32_t mesh;
+			uint32_t lod;
+			std::optional<encoded_lod> data;
+		};
+
+		residency_desc desc;
+		archive arc;
+		pool::buffer_pool vertices;
+		pool::buffer_pool indices;
+		std::vector<std::array<lod_slot, LOD_COUNT>> slots; // per mesh
+
+		// Quantized archives only, levels as uploaded, waiting for expand to write them in to pools
+		pool::buffer_pool packed;
+		sdl3::cmp_pipeline_ptr expand_pipeline;
+		std::vector<expand_job> expansions;
+
+		std::vector<std::array<uint32_t, 2>> requests;       // mesh and level asked for this frame, not resident
+		std::deque<loaded_lod> arrived;                      // read, waiting for upload
+		uint32_t streamed_bytes  = 0;
+		uint32_t loads_in_flight = 0;
+		stats counters           = {};
+
+		// Workers push finished reads here, update takes them every frame
+		batch::worker_pool loaders;
+		std::mutex finished_lock;
+		std::vector<loaded_lod> finished;
+	};
+
+	auto is_resident(const residency &res, uint32_t mesh, uint32_t lod) -> bool
+	{
+		return res.slots[mesh][lod].state == residency_t::resident;
+	}
+
+	// Stage quantized level as it's stored, and queue it's expansion in to pool ranges
+	auto stage_packed(SDL_GPUDevice *gpu, sdl3::upload_ring &uploads, residency &res, const encoded_lod &data, pool::range vertices, pool::range indices) -> bool
+	{
+		auto vertex_bytes = static_cast<uint32_t>(data.vertices.size());
+		auto index_bytes  = static_cast<uint32_t>(data.indices.size());
+
+		auto packed = pool::allocate(res.packed.allocator, vertex_bytes + index_bytes, sizeof(uint32_t));
+		if (not packed)
+			return false;
+
+		// Nothing was read from packed range yet, so it's free straight away. Caller releases expanded ranges.
+		auto ok = pool::upload(gpu, uploads, res.packed, { packed->offset, vertex_bytes }, data.vertices)
+		      and pool::upload(gpu, uploads, res.packed, { packed->offset + vertex_bytes, index_bytes }, data.indices);
+		if (not ok)
+		{
+			pool::release(res.packed.allocator, *packed);
+			return false;
+		}
+
+		auto &q = data.quant;
+		res.expansions.push_back({
+		  .params = {
+		    .pos_min         = q.pos_min,
+		    .packed_vertices = packed->offset,
+		    .pos_extent      = q.pos_extent,
+		    .packed_indices  = packed->offset + vertex_bytes,
+		    .uv_min          = q.uv_min,
+		    .uv_extent       = q.uv_extent,
+		    .vertices        = vertices.offset,
+		    .indices         = indices.offset,
+		    .vertex_count    = data.vertex_count,
+		    .index_count     = data.index_count,
+		  },
+		  .packed = *packed,
+		});
+		res.counters.uploaded_bytes += vertex_bytes + index_bytes;
+		return true;
+	}
+
+	// Decode level in to pools' upload memory, or stage it for expand if it's quantized.
+	// Level stays non-resident, with it's ranges given back, unless it's placed.
+	auto place_lod(SDL_GPUDevice *gpu, sdl3::upload_ring &uploads, residency &res, uint32_t mesh, uint32_t lod, const encoded_lod &data) -> placement_t
+	{
+		auto vertex_bytes = data.vertex_count * static_cast<uint32_t>(sizeof(vertex));
+		auto index_bytes  = data.index_count * static_cast<uint32_t>(sizeof(uint32_t));
+
+		auto vertices = pool::allocate(res.vertices.allocator, vertex_bytes, sizeof(vertex));
+		auto indices  = pool::allocate(res.indices.allocator, index_bytes, sizeof(uint32_t));
+		auto release = [&](placement_t result) {
+			if (vertices)
+				pool::release(res.vertices.allocator, *vertices);
+			if (indices)
+				pool::release(res.indices.allocator, *indices);
+			return result;
+		};
+		if (not vertices or not indices)
+			return release(placement_t::no_room);
+
+		if (res.arc.encoding == encoding_t::quantized)
+		{
+			if (not stage_packed(gpu, uploads, res, data, *vertices, *indices))
+				return release(placement_t::no_room);
+
+			auto &slot    = res.slots[mesh][lod];
+			slot.state    = residency_t::resident; // expand runs before any draw this frame
+			slot.vertices = *vertices;
+			slot.indices  = *indices;
+			return placement_t::placed;
+		}
+
+		// Copies staged in to ranges released here are followed by whatever reuses them, so they're never read
+		auto vertex_dst = pool::reserve(gpu, uploads, res.vertices, *vertices);
+		auto index_dst  = pool::reserve(gpu, uploads, res.indices, *indices);
+		if (vertex_dst.empty() or index_dst.empty())
+			return release(placement_t::no_room);
+
+		// Archive was written by bake_archive, so a level that doesn't decode is a corrupt file
+		auto ok = codec::decode_vertices(data.vertices, data.vertex_count, sizeof(vertex), vertex_dst)
+		      and codec::decode_indices(data.indices, data.index_count, data.vertex_count, index_dst);
+		if (not ok)
+			return release(placement_t::corrupt);
+		res.counters.uploaded_bytes += vertex_bytes + index_bytes;
+
+		auto &slot    = res.slots[mesh][lod];
+		slot.state    = residency_t::resident;
+		slot.vertices = *vertices;
+		slot.indices  = *indices;
+		return placement_t::placed;
+	}
+
+	// Opens archive and loads every mesh's pinned level.
+	// Pools hold pinned levels, budget, and half a budget more for ranges waiting on frames in flight.
+	auto make_residency(const sdl3::context &ctx, sdl3::scene &scn, const residency_desc &desc) -> std::unique_ptr<residency>
+	{
+		auto gpu = ctx.gpu.get();
+		auto arc = open_archive(desc.archive);
+		msg::error(arc.has_value(), "Failed to open geometry archive.");
+
+		auto pinned = std::views::iota(0u, arc->mesh_count)
+		            | std::views::transform([&](uint32_t mesh) { return entry_of(*arc, mesh, PINNED_LOD); });
+		auto pinned_vertex_bytes = 0u;
+		auto pinned_index_bytes  = 0u;
+		auto pinned_stored_bytes = 0u;
+		for (auto &&entry : pinned)
+		{
+			pinned_vertex_bytes += entry.vertex_count * static_cast<uint32_t>(sizeof(vertex));
+			pinned_index_bytes += entry.index_count * static_cast<uint32_t>(sizeof(uint32_t));
+			pinned_stored_bytes += entry.vertex_bytes + entry.index_bytes;
+		}
+		auto streamed_capacity = desc.budget_bytes + desc.budget_bytes / 2;
+
+		// Quantized levels are written in to pools by expand's compute pass
+		auto quantized    = (arc->encoding == encoding_t::quantized);
+		auto expand_usage = quantized ? SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE : SDL_GPUBufferUsageFlags{ 0 };
+		auto vertex_usage = SDL_GPU_BUFFERUSAGE_VERTEX | expand_usage;
+		auto index_usage  = SDL_GPU_BUFFERUSAGE_INDEX | expand_usage;
+
+		auto res      = std::make_unique<residency>();
+		res->desc     = desc;
+		res->arc      = std::move(*arc);
+		res->vertices = pool::make_buffer_pool(gpu, vertex_usage, pinned_vertex_bytes + streamed_capacity, "Geometry Vertex Pool"sv);
+		res->indices  = pool::make_buffer_pool(gpu, index_usage, pinned_index_bytes + streamed_capacity, "Geometry Index Pool"sv);
+		res->slots.resize(res->arc.mesh_count);
+
+		// Every pinned level is staged before first frame, streamed ones wait at most a few frames to be expanded
+		if (quantized)
+		{
+			res->packed = pool::make_buffer_pool(gpu, SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ, pinned_stored_bytes + desc.budget_bytes / 2, "Geometry Packed Pool"sv);
+
+			auto expand_desc = sdl3::compute_desc{
+				.shader_binary                  = io::read_file("shaders/geometry_expand.cs_6_4.cso"),
+				.readonly_storage_buffer_count  = 1,
+				.readwrite_storage_buffer_count = 2,
+				.uniform_buffer_count           = 1,
+				.threadcount_x                  = EXPAND_GROUP_SIZE,
+				.threadcount_y                  = 1,
+			};
+			res->expand_pipeline = sdl3::make_cmp_pipeline(gpu, expand_desc);
+		}
+
+		for (auto mesh : std::views::iota(0u, res->arc.mesh_count))
+		{
+			auto data = read_lod(res->arc, mesh, PINNED_LOD);
+			msg::error(data.has_value(), "Failed to read pinned geometry.");
+			msg::error(place_lod(gpu, scn.uploads, *res, mesh, PINNED_LOD, *data) == placement_t::placed,
+			           "Geometry pool has no room for pinned levels.");
+		}
+
+		batch::start_workers(res->loaders, desc.loader_threads);
+		msg::info(std::format("Geometry: {} meshes, {} KiB pinned, {} KiB budget, {} levels.",
+		                      res->arc.mesh_count, (pinned_vertex_bytes + pinned_index_bytes) / 1024, desc.budget_bytes / 1024,
+		                      quantized ? "quantized"sv : "encoded"sv));
+
+		return res;
+	}
+
+	// Mesh is drawn this frame and wants level lod, returns level to draw it with.
+	// Wanted level if resident, otherwise it's requested, and nearest resident level stands in;
+	// finer ones first, as they're already paid for, then coarser ones down to pinned level.
+	auto use(residency &res, uint32_t mesh, uint32_t lod, uint64_t frame_index) -> uint32_t
+	{
+		auto &mesh_slots = res.slots[mesh];
+		mesh_slots[lod].last_visible = frame_index;
+
+		if (mesh_slots[lod].state == residency_t::resident)
+			return lod;
+
+		if (mesh_slots[lod].state == residency_t::absent)
+			res.requests.push_back({ mesh, lod });
+
+		auto resident = [&](uint32_t l) { return mesh_slots[l].state == residency_t::resident; };
+		auto finer    = std::views::iota(0u, lod) | std::views::reverse | std::views::filter(resident);
+		auto coarser  = std::views::iota(lod + 1, LOD_COUNT) | std::views::filter(resident);
+		auto stand_in = finer.empty() ? coarser.front() : finer.front();
+
+		mesh_slots[stand_in].last_visible = frame_index;
+		++res.counters.fallbacks;
+		return stand_in;
+	}
+
+	// Draw of a resident level, instances are filled in by caller
+	auto draw_of(const residency &res, uint32_t mesh, uint32_t lod) -> sdl3::pooled_draw
+	{
+		auto &slot = res.slots[mesh][lod];
+		return {
+			.index_count   = slot.indices.size / static_cast<uint32_t>(sizeof(uint32_t)),
+			.first_index   = slot.indices.offset / static_cast<uint32_t>(sizeof(uint32_t)),
+			.vertex_offset = static_cast<int32_t>(slot.vertices.offset / sizeof(vertex)),
+			.instances     = {},
+		};
+	}
+
+	// Evict least recently drawn streamed level that wasn't used this frame.
+	// Ranges are given back once frames that may draw them have finished. False if there's nothing to evict.
+	auto evict_one(residency &res, uint64_t frame_index) -> bool
+	{
+		auto oldest      = std::optional<std::array<uint32_t, 2>>{};
+		auto oldest_used = frame_index;
+		for (auto mesh : std::views::iota(0u, res.arc.mesh_count))
+		{
+			for (auto lod : std::views::iota(0u, PINNED_LOD))
+			{
+				auto &slot = res.slots[mesh][lod];
+				if (slot.state == residency_t::resident and slot.last_visible < oldest_used)
+				{
+					oldest      = { mesh, lod };
+					oldest_used = slot.last_visible;
+				}
+			}
+		}
+
+		if (not oldest)
+			return false;
+
+		auto [mesh, lod] = *oldest;
+		auto &slot       = res.slots[mesh][lod];
+		pool::retire(res.vertices, slot.vertices, frame_index);
+		pool::retire(res.indices, slot.indices, frame_index);
+		res.streamed_bytes -= slot.vertices.size + slot.indices.size;
+		slot.state = residency_t::absent;
+		++res.counters.evictions;
+		return true;
+	}
+
+	void start_loads(residency &res)
+	{
+		for (auto [mesh, lod] : res.requests)
+		{
+			if (res.loads_in_flight >= res.desc.max_loads_in_flight)
+				break;
+
+			auto &slot = res.slots[mesh][lod];
+			if (slot.state != residency_t::absent)
+				continue;
+
+			slot.state = residency_t::loading;
+			++res.loads_in_flight;
+
+			batch::submit(res.loaders, [&res, mesh, lod] {
+				auto data = read_lod(res.arc, mesh, lod);
+
+				auto lk = std::scoped_lock{ res.finished_lock };
+				res.finished.push_back({ mesh, lod, std::move(data) });
+			}, res.desc.max_loads_in_flight);
+		}
+		res.requests.clear();
+	}
+
+	// Take finished reads, upload a few of them evicting to stay under budget, and start reads for this frame's requests.
+	// Call once per frame, after every use and before begin_frame.
+	void update(const sdl3::context &ctx, sdl3::scene &scn, residency &res)
+	{
+		auto frame_index = scn.timeline.frame_index;
+		pool::reclaim(res.vertices, scn.timeline.completed_count);
+		pool::reclaim(res.indices, scn.timeline.completed_count);
+		if (res.arc.encoding == encoding_t::quantized)
+			pool::reclaim(res.packed, scn.timeline.completed_count);
+
+		{
+			auto lk = std::scoped_lock{ res.finished_lock };
+			std::ranges::move(res.finished, std::back_inserter(res.arrived));
+			res.finished.clear();
+		}
+
+		for (auto i = 0u; i < res.desc.max_uploads_per_frame and not res.arrived.empty(); ++i)
+		{
+			auto &next = res.arrived.front();
+			auto &slot = res.slots[next.mesh][next.lod];
+
+			// Level that couldn't be read, or doesn't decode, is read again if it's still wanted
+			auto drop_failed = [&] {
+				slot.state = residency_t::absent;
+				++res.counters.failed;
+				--res.loads_in_flight;
+				res.arrived.pop_front();
+			};
+
+			if (not next.data)
+			{
+				drop_failed();
+				continue;
+			}
+
+			auto size = byte_size(entry_of(res.arc, next.mesh, next.lod));
+			while (res.streamed_bytes + size > res.desc.budget_bytes and evict_one(res, frame_index))
+			{
+			}
+
+			// Everything resident was drawn this frame, try again next frame
+			if (res.streamed_bytes + size > res.desc.budget_bytes)
+				break;
+
+			// Within budget but no range fits, pools are fragmented or waiting on frames in flight,
+			// or upload ring is full. Evicting wouldn't make room that's usable now, so retry next frame.
+			auto placed = place_lod(ctx.gpu.get(), scn.uploads, res, next.mesh, next.lod, *next.data);
+			if (placed == placement_t::no_room)
+			{
+				++res.counters.deferred;
+				break;
+			}
+			if (placed == placement_t::corrupt)
+			{
+				drop_failed();
+				continue;
+			}
+
+			res.streamed_bytes += slot.vertices.size + slot.indices.size;
+			++res.counters.loads;
+			--res.loads_in_flight;
+			res.arrived.pop_front();
+		}
+
+		start_loads(res);
+	}
+
+	// Record expansion of quantized levels placed since last call, call every frame before any draw from pools.
+	// Packed ranges are given back once this frame has finished.
+	void expand(sdl3::frame_context &frm, residency &res)
+	{
+		if (res.expansions.empty())
+			return;
+
+		auto bindings = std::array{
+			SDL_GPUStorageBufferReadWriteBinding{ .buffer = res.vertices.buffer.get(), .cycle = false },
+			SDL_GPUStorageBufferReadWriteBinding{ .buffer = res.indices.buffer.get(), .cycle = false },
+		};
+
+		auto compute_pass = SDL_BeginGPUComputePass(frm.cmd_buf, nullptr, 0, bindings.data(), static_cast<uint32_t>(bindings.size()));
+		{
+			auto packed = res.packed.buffer.get();
+			SDL_BindGPUComputePipeline(compute_pass, res.expand_pipeline.get());
+			SDL_BindGPUComputeStorageBuffers(compute_pass, 0, &packed, 1);
+
+			// Each thread expands one vertex and one pair of indices
+			for (auto &&job : res.expansions)
+			{
+				auto threads = std::max(job.params.vertex_count, (job.params.index_count + 1) / 2);
+				SDL_PushGPUComputeUniformData(frm.cmd_buf, 0, &job.params, sizeof(expand_params));
+				SDL_DispatchGPUCompute(compute_pass, (threads + EXPAND_GROUP_SIZE - 1) / EXPAND_GROUP_SIZE, 1, 1);
+				pool::retire(res.packed, job.packed, frm.frame_index + 1);
+			}
+		}
+		SDL_EndGPUComputePass(compute_pass);
+
+		res.expansions.clear();
+	}
+
+	// Wait for reads in flight, scene must no longer reference pools
+	void destroy_residency(residency &res)
+	{
+		batch::wait_idle(res.loaders);
+		batch::stop_workers(res.loaders);
+
+		msg::info(std::format("Geometry: {} levels loaded, {} evicted, {} failed, {} deferred, {} fallback draws, {} KiB uploaded.",
+		                      res.counters.loads, res.counters.evictions, res.counters.failed, res.counters.deferred,
+		                      res.counters.fallbacks, res.counters.uploaded_bytes / 1024));
+	}
+}
@@ -0,0 +1,1130 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+// GLM headers
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE // GLM clip space should be in Z-axis to 0 to 1
+#define GLM_FORCE_LEFT_HANDED       // GLM should use left-handed coordinates, +z goes into screen
+#define GLM_FORCE_RADIANS           // GLM should always use radians not degrees.
+#include <glm/glm.hpp>              // Required for glm::vec3/4/mat4/etc
+#include <glm/ext.hpp>              // Required for glm::quat and glm::make_mat4
+
+// SSE2 is baseline on x64, other targets convert one element at a time
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GLTF_SSE2 1
+#else
+#define GLTF_SSE2 0
+#endif
+
+export module gltf_import;
+
+import std;
+import logs;
+import io;
+import batch;
+import scene_file;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * glTF 2.0 importer, for .gltf with external or embedded buffers, and .glb.
+ * Files are memory mapped, and JSON is parsed once in to a flat array of values.
+ * Meshes, skins and images are converted on worker threads, in to app's vertex layout and 32 bit indices,
+ * welded and reordered for vertex fetch, ready to upload.
+ * glTF is right handed, positions and transforms are mirrored along z in to app's left handed space.
+ */
+export namespace gltf
+{
+	constexpr auto NONE = uint32_t{ 0xFFFF'FFFF }; // missing index, node, material, etc
+
+	// Nesting deeper than this is refused, glTF itself needs about 6
+	constexpr auto MAX_JSON_DEPTH = 64u;
+
+	enum class json_t : uint8_t
+	{
+		null,
+		boolean,
+		number,
+		string,
+		array,
+		object,
+	};
+
+	// Values in document order, children follow their parent and are linked as siblings.
+	// Strings are views in to source text, escapes are left in place.
+	struct json_node
+	{
+		json_t type = json_t::null;
+		std::string_view key;  // member name, when parent is an object
+		std::string_view text; // string value
+		double number         = 0.0; // number value, 1 or 0 for booleans
+		uint32_t first_child  = NONE;
+		uint32_t next_sibling = NONE;
+		uint32_t count        = 0; // children
+	};
+
+	struct json_parser
+	{
+		std::string_view src;
+		size_t pos = 0;
+		std::vector<json_node> nodes;
+	};
+
+	void skip_space(json_parser &p)
+	{
+		while (p.pos < p.src.size() and " \t\r\n"sv.contains(p.src[p.pos]))
+			++p.pos;
+	}
+
+	// At opening quote, returns text up to closing quote
+	auto parse_string(json_parser &p) -> std::optional<std::string_view>
+	{
+		auto start = ++p.pos;
+		while (p.pos < p.src.size() and p.src[p.pos] != '"')
+			p.pos += (p.src[p.pos] == '\\') ? 2 : 1;
+
+		if (p.pos >= p.src.size())
+			return std::nullopt;
+		return p.src.substr(start, p.pos++ - start);
+	}
+
+	// Appends value and it's children to nodes, returns it's index
+	auto parse_value(json_parser &p, uint32_t depth) -> std::optional<uint32_t>
+	{
+		skip_space(p);
+		if (p.pos >= p.src.size() or depth > MAX_JSON_DEPTH)
+			return std::nullopt;
+
+		auto index = static_cast<uint32_t>(p.nodes.size());
+		p.nodes.push_back({});
+
+		auto c = p.src[p.pos];
+		if (c == '{' or c == '[')
+		{
+			auto object = (c == '{');
+			auto close  = object ? '}' : ']';
+
+			p.nodes[index].type = object ? json_t::object : json_t::array;
+			++p.pos;
+
+			skip_space(p);
+			if (p.pos < p.src.size() and p.src[p.pos] == close)
+			{
+				++p.pos;
+				return index;
+			}
+
+			auto previous = NONE;
+			while (true)
+			{
+				auto key = std::string_view{};
+				if (object)
+				{
+					skip_space(p);
+					if (p.pos >= p.src.size() or p.src[p.pos] != '"')
+						return std::nullopt;
+
+					auto name = parse_string(p);
+					skip_space(p);
+					if (not name or p.pos >= p.src.size() or p.src[p.pos] != ':')
+						return std::nullopt;
+
+					key = *name;
+					++p.pos;
+				}
+
+				auto child = parse_value(p, depth + 1);
+				if (not child)
+					return std::nullopt;
+
+				p.nodes[*child].key = key;
+				if (previous == NONE)
+					p.nodes[index].first_child = *child;
+				else
+					p.nodes[previous].next_sibling = *child;
+				previous = *child;
+				++p.nodes[index].count;
+
+				skip_space(p);
+				if (p.pos >= p.src.size())
+					return std::nullopt;
+
+				auto separator = p.src[p.pos++];
+				if (separator == close)
+					return index;
+				if (separator != ',')
+					return std::nullopt;
+			}
+		}
+
+		if (c == '"')
+		{
+			auto text = parse_string(p);
+			if (not text)
+				return std::nullopt;
+
+			p.nodes[index].type = json_t::string;
+			p.nodes[index].text = *text;
+			return index;
+		}
+
+		auto rest = p.src.substr(p.pos);
+		for (auto &&[word, type, value] : { std::tuple{ "true"sv, json_t::boolean, 1.0 },
+		                                    std::tuple{ "false"sv, json_t::boolean, 0.0 },
+		                                    std::tuple{ "null"sv, json_t::null, 0.0 } })
+		{
+			if (rest.starts_with(word))
+			{
+				p.nodes[index].type   = type;
+				p.nodes[index].number = value;
+				p.pos += word.size();
+				return index;
+			}
+		}
+
+		auto first          = p.src.data() + p.pos;
+		auto number         = 0.0;
+		auto [last, result] = std::from_chars(first, p.src.data() + p.src.size(), number);
+		if (result != std::errc{})
+			return std::nullopt;
+
+		p.nodes[index].type   = json_t::number;
+		p.nodes[index].number = number;
+		p.pos += static_cast<size_t>(last - first);
+		return index;
+	}
+
+	// Whole document in one pass, root is node 0
+	auto parse_json(std::string_view text) -> std::optional<std::vector<json_node>>
+	{
+		auto p = json_parser{ .src = text };
+		p.nodes.reserve(1024); // grows with document, embedded buffers are one node each
+
+		auto root = parse_value(p, 0);
+		skip_space(p);
+		if (not root or p.pos != text.size())
+			return std::nullopt;
+		return std::move(p.nodes);
+	}
+
+	// glTF document, JSON plus tables of top level arrays, so i-th accessor, mesh, etc is one lookup
+	struct document
+	{
+		std::vector<json_node> json;
+
+		std::vector<uint32_t> buffers;
+		std::vector<uint32_t> buffer_views;
+		std::vector<uint32_t> accessors;
+		std::vector<uint32_t> meshes;
+		std::vector<uint32_t> nodes;
+		std::vector<uint32_t> scenes;
+		std::vector<uint32_t> skins;
+		std::vector<uint32_t> materials;
+		std::vector<uint32_t> textures;
+		std::vector<uint32_t> images;
+	};
+
+	auto children(const document &doc, uint32_t node) -> std::vector<uint32_t>
+	{
+		auto result = std::vector<uint32_t>{};
+		if (node == NONE)
+			return result;
+
+		result.reserve(doc.json[node].count);
+		for (auto child = doc.json[node].first_child; child != NONE; child = doc.json[child].next_sibling)
+			result.push_back(child);
+		return result;
+	}
+
+	auto member(const document &doc, uint32_t node, std::string_view key) -> uint32_t
+	{
+		if (node == NONE or doc.json[node].type != json_t::object)
+			return NONE;
+
+		for (auto child = doc.json[node].first_child; child != NONE; child = doc.json[child].next_sibling)
+		{
+			if (doc.json[child].key == key)
+				return child;
+		}
+		return NONE;
+	}
+
+	auto as_number(const document &doc, uint32_t node, double fallback) -> double
+	{
+		return (node == NONE or doc.json[node].type != json_t::number) ? fallback : doc.json[node].number;
+	}
+
+	auto as_index(const document &doc, uint32_t node) -> uint32_t
+	{
+		auto value = as_number(doc, node, -1.0);
+		return (value < 0.0 or value >= NONE) ? NONE : static_cast<uint32_t>(value);
+	}
+
+	auto as_string(const document &doc, uint32_t node) -> std::string_view
+	{
+		return (node == NONE or doc.json[node].type != json_t::string) ? ""sv : doc.json[node].text;
+	}
+
+	// Array of exactly out.size() numbers, out is left alone otherwise
+	auto read_floats(const document &doc, uint32_t node, std::span<float> out) -> bool
+	{
+		auto values = children(doc, node);
+		if (values.size() != out.size())
+			return false;
+
+		std::ranges::transform(values, out.begin(), [&](uint32_t v) { return static_cast<float>(as_number(doc, v, 0.0)); });
+		return true;
+	}
+
+	// URIs are percent encoded, and may carry JSON escapes
+	auto decode_uri(std::string_view uri) -> std::string
+	{
+		auto hex = [](char c) -> int {
+			if (c >= '0' and c <= '9')
+				return c - '0';
+			if (c >= 'a' and c <= 'f')
+				return c - 'a' + 10;
+			if (c >= 'A' and c <= 'F')
+				return c - 'A' + 10;
+			return -1;
+		};
+
+		auto result = std::string{};
+		for (auto i = size_t{ 0 }; i < uri.size(); ++i)
+		{
+			if (uri[i] == '\\' and i + 1 < uri.size())
+			{
+				result += uri[++i];
+			}
+			else if (uri[i] == '%' and i + 2 < uri.size() and hex(uri[i + 1]) >= 0 and hex(uri[i + 2]) >= 0)
+			{
+				result += static_cast<char>(hex(uri[i + 1]) * 16 + hex(uri[i + 2]));
+				i += 2;
+			}
+			else
+			{
+				result += uri[i];
+			}
+		}
+		return result;
+	}
+
+	auto decode_base64(std::string_view text) -> std::optional<io::byte_array>
+	{
+		auto value = [](char c) -> int {
+			if (c >= 'A' and c <= 'Z')
+				return c - 'A';
+			if (c >= 'a' and c <= 'z')
+				return c - 'a' + 26;
+			if (c >= '0' and c <= '9')
+				return c - '0' + 52;
+			if (c == '+')
+				return 62;
+			if (c == '/')
+				return 63;
+			return -1;
+		};
+
+		auto bytes = io::byte_array{};
+		bytes.reserve(text.size() / 4 * 3);
+
+		auto bits  = uint32_t{ 0 };
+		auto count = 0;
+		for (auto c : text)
+		{
+			if (c == '=')
+				break;
+
+			auto v = value(c);
+			if (v < 0)
+				return std::nullopt;
+
+			bits = (bits << 6) | static_cast<uint32_t>(v);
+			count += 6;
+			if (count >= 8)
+			{
+				count -= 8;
+				bytes.push_back(static_cast<std::byte>((bits >> count) & 0xFF));
+			}
+		}
+		return bytes;
+	}
+
+	auto mapped_bytes(const sfile::mapped_ptr &file) -> io::byte_span
+	{
+		return { file.get(), file ? file.get_deleter().size : 0 };
+	}
+
+	// Opened file, and every buffer it's accessors can read from
+	struct source
+	{
+		std::filesystem::path directory; // relative URIs are resolved against this
+		sfile::mapped_ptr file;
+		std::vector<sfile::mapped_ptr> external; // .bin files
+		std::vector<io::byte_array> embedded;    // data: URIs
+		std::vector<io::byte_span> buffers;
+		document doc;
+	};
+
+	constexpr auto GLB_MAGIC      = uint32_t{ 0x4654'6C67 }; // "glTF"
+	constexpr auto GLB_CHUNK_JSON = uint32_t{ 0x4E4F'534A };
+	constexpr auto GLB_CHUNK_BIN  = uint32_t{ 0x004E'4942 };
+
+	struct glb_header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t length;
+	};
+
+	struct chunk_header
+	{
+		uint32_t length;
+		uint32_t type;
+	};
+
+	// JSON chunk, and BIN chunk if there is one
+	auto split_glb(io::byte_span bytes) -> std::optional<std::pair<std::string_view, io::byte_span>>
+	{
+		auto header = glb_header{};
+		if (bytes.size() < sizeof(header))
+			return std::nullopt;
+
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != GLB_MAGIC or header.version != 2 or header.length > bytes.size())
+			return std::nullopt;
+
+		auto json   = std::string_view{};
+		auto bin    = io::byte_span{};
+		auto offset = sizeof(header);
+		while (offset + sizeof(chunk_header) <= header.length)
+		{
+			auto chunk = chunk_header{};
+			std::memcpy(&chunk, bytes.data() + offset, sizeof(chunk));
+			offset += sizeof(chunk);
+			if (chunk.length > header.length - offset)
+				return std::nullopt;
+
+			auto data = bytes.subspan(offset, chunk.length);
+			if (chunk.type == GLB_CHUNK_JSON and json.empty())
+				json = { reinterpret_cast<const char *>(data.data()), data.size() };
+			else if (chunk.type == GLB_CHUNK_BIN and bin.empty())
+				bin = data;
+
+			offset += (chunk.length + 3) & ~3u;
+		}
+
+		if (json.empty())
+			return std::nullopt;
+		return std::pair{ json, bin };
+	}
+
+	auto make_table(const document &doc, std::string_view key) -> std::vector<uint32_t>
+	{
+		return children(doc, member(doc, 0, key));
+	}
+
+	auto open_source(const std::filesystem::path &filename) -> std::optional<source>
+	{
+		auto src = source{
+			.directory = filename.parent_path(),
+			.file      = sfile::map_file(filename),
+		};
+		if (not src.file)
+		{
+			msg::info(std::format("glTF: couldn't open {}.", filename.string()));
+			return std::nullopt;
+		}
+
+		auto bytes = mapped_bytes(src.file);
+		auto text  = std::string_view{ reinterpret_cast<const char *>(bytes.data()), bytes.size() };
+		auto bin   = io::byte_span{};
+		if (auto glb = split_glb(bytes); glb)
+			std::tie(text, bin) = *glb;
+
+		auto json = parse_json(text);
+		if (not json or json->front().type != json_t::object)
+		{
+			msg::info(std::format("glTF: {} isn't valid JSON.", filename.string()));
+			return std::nullopt;
+		}
+
+		auto &doc        = src.doc;
+		doc.json         = std::move(*json);
+		doc.buffers      = make_table(doc, "buffers"sv);
+		doc.buffer_views = make_table(doc, "bufferViews"sv);
+		doc.accessors    = make_table(doc, "accessors"sv);
+		doc.meshes       = make_table(doc, "meshes"sv);
+		doc.nodes        = make_table(doc, "nodes"sv);
+		doc.scenes       = make_table(doc, "scenes"sv);
+		doc.skins        = make_table(doc, "skins"sv);
+		doc.materials    = make_table(doc, "materials"sv);
+		doc.textures     = make_table(doc, "textures"sv);
+		doc.images       = make_table(doc, "images"sv);
+
+		// Buffer without URI is GLB's BIN chunk, others are files next to document, or base64 data
+		src.embedded.reserve(doc.buffers.size());
+		for (auto &&buffer : doc.buffers)
+		{
+			auto uri = decode_uri(as_string(doc, member(doc, buffer, "uri"sv)));
+			if (uri.empty())
+			{
+				src.buffers.push_back(bin);
+			}
+			else if (uri.starts_with("data:"sv))
+			{
+				auto comma = uri.find(',');
+				auto data  = (comma == uri.npos) ? std::nullopt : decode_base64(std::string_view{ uri }.substr(comma + 1));
+				src.embedded.push_back(data.value_or(io::byte_array{}));
+				src.buffers.push_back(src.embedded.back());
+			}
+			else
+			{
+				src.external.push_back(sfile::map_file(src.directory / std::filesystem::path{ uri }));
+				src.buffers.push_back(mapped_bytes(src.external.back()));
+			}
+
+			auto expected = static_cast<uint64_t>(as_number(doc, member(doc, buffer, "byteLength"sv), 0.0));
+			if (src.buffers.back().size() < expected)
+			{
+				msg::info(std::format("glTF: buffer {} is missing or short.", src.buffers.size() - 1));
+				src.buffers.back() = {};
+			}
+		}
+
+		return src;
+	}
+
+	enum class component_t : uint32_t
+	{
+		i8  = 5120,
+		u8  = 5121,
+		i16 = 5122,
+		u16 = 5123,
+		u32 = 5125,
+		f32 = 5126,
+	};
+
+	auto component_size(component_t component) -> uint32_t
+	{
+		switch (component)
+		{
+		case component_t::i8:
+		case component_t::u8:
+			return 1;
+		case component_t::i16:
+		case component_t::u16:
+			return 2;
+		case component_t::u32:
+		case component_t::f32:
+			return 4;
+		}
+		return 0;
+	}
+
+	auto component_count(std::string_view type) -> uint32_t
+	{
+		constexpr auto TYPES = std::array{
+			std::pair{ "SCALAR"sv, 1u },
+			std::pair{ "VEC2"sv, 2u },
+			std::pair{ "VEC3"sv, 3u },
+			std::pair{ "VEC4"sv, 4u },
+			std::pair{ "MAT2"sv, 4u },
+			std::pair{ "MAT3"sv, 9u },
+			std::pair{ "MAT4"sv, 16u },
+		};
+		auto it = std::ranges::find(TYPES, type, &std::pair<std::string_view, uint32_t>::first);
+		return (it == TYPES.end()) ? 0u : it->second;
+	}
+
+	// Typed view of buffer bytes, data starts at first element
+	struct accessor
+	{
+		io::byte_span data;
+		uint32_t count;
+		uint32_t stride;
+		component_t component;
+		uint32_t components;
+		bool normalized;
+	};
+
+	// Nothing if accessor is sparse, or it's elements don't lie inside it's buffer view
+	auto read_accessor(const source &src, uint32_t index) -> std::optional<accessor>
+	{
+		auto &doc = src.doc;
+		if (index >= doc.accessors.size())
+			return std::nullopt;
+
+		auto node = doc.accessors[index];
+		auto view = as_index(doc, member(doc, node, "bufferView"sv));
+		if (view >= doc.buffer_views.size() or member(doc, node, "sparse"sv) != NONE)
+			return std::nullopt;
+
+		auto view_node = doc.buffer_views[view];
+		auto buffer    = as_index(doc, member(doc, view_node, "buffer"sv));
+		if (buffer >= src.buffers.size())
+			return std::nullopt;
+
+		auto acc = accessor{
+			.count      = as_index(doc, member(doc, node, "count"sv)),
+			.component  = static_cast<component_t>(as_index(doc, member(doc, node, "componentType"sv))),
+			.components = component_count(as_string(doc, member(doc, node, "type"sv))),
+			.normalized = as_number(doc, member(doc, node, "normalized"sv), 0.0) != 0.0,
+		};
+
+		auto element_size = component_size(acc.component) * acc.components;
+		acc.stride        = as_index(doc, member(doc, view_node, "byteStride"sv));
+		if (acc.stride == NONE)
+			acc.stride = element_size;
+		if (element_size == 0 or acc.count == NONE or acc.count == 0 or acc.stride < element_size)
+			return std::nullopt;
+
+		auto view_offset = static_cast<uint64_t>(as_number(doc, member(doc, view_node, "byteOffset"sv), 0.0));
+		auto view_length = static_cast<uint64_t>(as_number(doc, member(doc, view_node, "byteLength"sv), 0.0));
+		auto offset      = static_cast<uint64_t>(as_number(doc, member(doc, node, "byteOffset"sv), 0.0));
+		auto span_size   = offset + uint64_t{ acc.stride } * (acc.count - 1) + element_size;
+
+		auto &bytes = src.buffers[buffer];
+		if (view_offset + view_length > bytes.size() or span_size > view_length)
+			return std::nullopt;
+
+		acc.data = bytes.subspan(view_offset + offset, span_size - offset);
+		return acc;
+	}
+
+	// Component c of element i, normalized integers map to 0..1, or -1..1 when signed
+	auto read_float(const accessor &acc, uint32_t i, uint32_t c) -> float
+	{
+		auto ptr = acc.data.data() + uint64_t{ acc.stride } * i + component_size(acc.component) * c;
+
+		auto load = [&]<typename T>(T, float scale) {
+			auto value = T{};
+			std::memcpy(&value, ptr, sizeof(T));
+			return acc.normalized ? std::max(static_cast<float>(value) / scale, -1.0f) : static_cast<float>(value);
+		};
+
+		switch (acc.component)
+		{
+		case component_t::i8:
+			return load(int8_t{}, 127.0f);
+		case component_t::u8:
+			return load(uint8_t{}, 255.0f);
+		case component_t::i16:
+			return load(int16_t{}, 32767.0f);
+		case component_t::u16:
+			return load(uint16_t{}, 65535.0f);
+		case component_t::u32:
+			return load(uint32_t{}, 4294967295.0f);
+		case component_t::f32:
+			return load(float{}, 1.0f);
+		}
+		return 0.0f;
+	}
+
+	// Positions are mirrored in to left handed space, uvs keep glTF's top left origin, same as app's
+	void convert_vertices(const accessor &positions, const accessor *uvs, std::span<sfile::vertex> out)
+	{
+		for (auto &&[i, vtx] : out | std::views::enumerate)
+		{
+			std::memcpy(vtx.pos.data(), positions.data.data() + uint64_t{ positions.stride } * i, sizeof(vtx.pos));
+			vtx.pos[2] = -vtx.pos[2];
+		}
+
+		if (uvs == nullptr)
+		{
+			std::ranges::for_each(out, [](sfile::vertex &vtx) { vtx.uv = {}; });
+			return;
+		}
+
+		auto i = uint32_t{ 0 };
+		if (uvs->component == component_t::f32)
+		{
+			for (; i < out.size(); ++i)
+				std::memcpy(out[i].uv.data(), uvs->data.data() + uint64_t{ uvs->stride } * i, sizeof(out[i].uv));
+		}
+#if GLTF_SSE2
+		// Tightly packed unorm16 pairs, 4 uvs per load, widened with zeros and scaled to 0..1
+		else if (uvs->component == component_t::u16 and uvs->normalized and uvs->stride == 4)
+		{
+			const auto zero  = _mm_setzero_si128();
+			const auto scale = _mm_set1_ps(1.0f / 65535.0f);
+			for (; i + 4 <= out.size(); i += 4)
+			{
+				auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(uvs->data.data() + uint64_t{ i } * 4));
+				auto lo     = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero)), scale);
+				auto hi     = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, zero)), scale);
+				_mm_storel_pi(reinterpret_cast<__m64 *>(out[i + 0].uv.data()), lo);
+				_mm_storeh_pi(reinterpret_cast<__m64 *>(out[i + 1].uv.data()), lo);
+				_mm_storel_pi(reinterpret_cast<__m64 *>(out[i + 2].uv.data()), hi);
+				_mm_storeh_pi(reinterpret_cast<__m64 *>(out[i + 3].uv.data()), hi);
+			}
+		}
+#endif
+
+		for (; i < out.size(); ++i)
+			out[i].uv = { read_float(*uvs, i, 0), read_float(*uvs, i, 1) };
+	}
+
+	// glTF only allows unsigned index types
+	auto is_index_component(component_t component) -> bool
+	{
+		return component == component_t::u8 or component == component_t::u16 or component == component_t::u32;
+	}
+
+	// Index accessors are tightly packed, glTF doesn't allow a stride on them.
+	// Other than unsigned components are rejected by caller, see is_index_component.
+	void widen_indices(const accessor &acc, std::span<uint32_t> out)
+	{
+		auto src = acc.data.data();
+		auto i   = size_t{ 0 };
+
+		switch (acc.component)
+		{
+		case component_t::u32:
+			std::memcpy(out.data(), src, out.size_bytes());
+			return;
+
+		case component_t::u16:
+#if GLTF_SSE2
+			for (; i + 8 <= out.size(); i += 8)
+			{
+				auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i), _mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i + 4), _mm_unpackhi_epi16(packed, _mm_setzero_si128()));
+			}
+#endif
+			for (; i < out.size(); ++i)
+			{
+				auto value = uint16_t{};
+				std::memcpy(&value, src + i * 2, sizeof(value));
+				out[i] = value;
+			}
+			return;
+
+		case component_t::u8:
+#if GLTF_SSE2
+			for (; i + 16 <= out.size(); i += 16)
+			{
+				auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+				auto lo     = _mm_unpacklo_epi8(packed, _mm_setzero_si128());
+				auto hi     = _mm_unpackhi_epi8(packed, _mm_setzero_si128());
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i), _mm_unpacklo_epi16(lo, _mm_setzero_si128()));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i + 4), _mm_unpackhi_epi16(lo, _mm_setzero_si128()));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i + 8), _mm_unpacklo_epi16(hi, _mm_setzero_si128()));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i + 12), _mm_unpackhi_epi16(hi, _mm_setzero_si128()));
+			}
+#endif
+			for (; i < out.size(); ++i)
+				out[i] = static_cast<uint32_t>(src[i]);
+			return;
+
+		default:
+			std::ranges::fill(out, 0u);
+		}
+	}
+
+	struct import_stats
+	{
+		uint32_t primitives    = 0;
+		uint32_t skipped       = 0; // primitives that couldn't be converted
+		uint64_t vertices_read = 0;
+		uint64_t vertices_kept = 0; // after welding
+		uint64_t triangles     = 0;
+		double seconds         = 0.0;
+	};
+
+	struct primitive
+	{
+		std::vector<sfile::vertex> vertices;
+		std::vector<uint32_t> indices;
+		uint32_t material = NONE;
+		sfile::aabb bounds;
+	};
+
+	// Identical vertices are merged, and vertices are reordered by first use,
+	// so vertex fetch walks memory forward. Unreferenced vertices drop out.
+	void optimize(primitive &prim)
+	{
+		auto key = [&](uint32_t v) {
+			return std::string_view{ reinterpret_cast<const char *>(&prim.vertices[v]), sizeof(sfile::vertex) };
+		};
+
+		auto first_use = std::unordered_map<std::string_view, uint32_t>{};
+		first_use.reserve(prim.vertices.size());
+
+		auto vertices = std::vector<sfile::vertex>{};
+		vertices.reserve(prim.vertices.size());
+		for (auto &&idx : prim.indices)
+		{
+			auto [it, inserted] = first_use.try_emplace(key(idx), static_cast<uint32_t>(vertices.size()));
+			if (inserted)
+				vertices.push_back(prim.vertices[idx]);
+			idx = it->second;
+		}
+
+		prim.vertices = std::move(vertices);
+	}
+
+	auto convert_primitive(const source &src, uint32_t node, import_stats &stats) -> std::optional<primitive>
+	{
+		auto &doc = src.doc;
+
+		// Points and lines aren't drawn by app, strips and fans are rare enough to leave out
+		constexpr auto MODE_TRIANGLES = 4u;
+		auto mode                     = as_index(doc, member(doc, node, "mode"sv));
+		if (mode != NONE and mode != MODE_TRIANGLES)
+			return std::nullopt;
+
+		auto attributes = member(doc, node, "attributes"sv);
+		auto positions  = read_accessor(src, as_index(doc, member(doc, attributes, "POSITION"sv)));
+		if (not positions or positions->component != component_t::f32 or positions->components != 3)
+			return std::nullopt;
+
+		auto uvs      = read_accessor(src, as_index(doc, member(doc, attributes, "TEXCOORD_0"sv)));
+		auto uvs_used = uvs and uvs->components == 2 and uvs->count == positions->count
+		            and (uvs->component == component_t::f32 or uvs->normalized);
+
+		auto prim = primitive{
+			.vertices = std::vector<sfile::vertex>(positions->count),
+			.material = as_index(doc, member(doc, node, "material"sv)),
+		};
+		convert_vertices(*positions, uvs_used ? &*uvs : nullptr, prim.vertices);
+
+		auto index_member = member(doc, node, "indices"sv);
+		if (index_member == NONE)
+		{
+			prim.indices = std::views::iota(0u, positions->count) | std::ranges::to<std::vector>();
+		}
+		else
+		{
+			auto indices = read_accessor(src, as_index(doc, index_member));
+			if (not indices or indices->components != 1 or not is_index_component(indices->component)
+			    or indices->stride != component_size(indices->component))
+				return std::nullopt;
+
+			prim.indices.resize(indices->count);
+			widen_indices(*indices, prim.indices);
+		}
+
+		prim.indices.resize(prim.indices.size() / 3 * 3);
+		if (prim.indices.empty() or std::ranges::max(prim.indices) >= prim.vertices.size())
+			return std::nullopt;
+
+		// Mirroring flips winding, swap back to counter clockwise front faces
+		for (auto t = size_t{ 0 }; t < prim.indices.size(); t += 3)
+			std::swap(prim.indices[t + 1], prim.indices[t + 2]);
+
+		stats.vertices_read += prim.vertices.size();
+		optimize(prim);
+
+		prim.bounds = { .min = prim.vertices.front().pos, .max = prim.vertices.front().pos };
+		for (auto &&vtx : prim.vertices)
+			prim.bounds = sfile::merge(prim.bounds, { .min = vtx.pos, .max = vtx.pos });
+
+		return prim;
+	}
+
+	struct mesh
+	{
+		std::vector<primitive> primitives;
+	};
+
+	struct instance
+	{
+		uint32_t mesh;
+		uint32_t skin; // NONE when mesh isn't skinned
+		sfile::transform transform;
+	};
+
+	struct material
+	{
+		std::array<float, 4> base_color;
+		uint32_t base_color_image; // index in to images, NONE for none
+		bool blend;
+		bool double_sided;
+	};
+
+	// Image file, or bytes of an image embedded in a buffer, not decoded
+	struct image
+	{
+		std::filesystem::path path;
+		std::string mime_type;
+		io::byte_array bytes;
+	};
+
+	struct skin
+	{
+		std::vector<uint32_t> joints; // node indices
+		std::vector<sfile::transform> inverse_bind;
+	};
+
+	struct asset
+	{
+		std::vector<mesh> meshes;
+		std::vector<instance> instances; // every node with a mesh, in scene order
+		std::vector<material> materials;
+		std::vector<image> images;
+		std::vector<skin> skins;
+		import_stats stats;
+	};
+
+	struct import_desc
+	{
+		uint32_t worker_threads = 4;
+		uint32_t max_queued     = 16; // tasks waiting for a worker, bounds memory held by queued work
+	};
+
+	// Mirror along z, for matrices and points alike
+	const auto MIRROR_Z = glm::scale(glm::mat4(1.0f), glm::vec3{ 1.0f, 1.0f, -1.0f });
+
+	auto to_transform(const glm::mat4 &m) -> sfile::transform
+	{
+		auto t = sfile::transform{};
+		std::memcpy(t.data(), glm::value_ptr(m), sizeof(t));
+		return t;
+	}
+
+	auto local_transform(const document &doc, uint32_t node) -> glm::mat4
+	{
+		auto matrix = std::array<float, 16>{};
+		if (read_floats(doc, member(doc, node, "matrix"sv), matrix))
+			return glm::make_mat4(matrix.data());
+
+		auto translation = std::array{ 0.0f, 0.0f, 0.0f };
+		auto rotation    = std::array{ 0.0f, 0.0f, 0.0f, 1.0f }; // x, y, z, w
+		auto scale       = std::array{ 1.0f, 1.0f, 1.0f };
+		read_floats(doc, member(doc, node, "translation"sv), translation);
+		read_floats(doc, member(doc, node, "rotation"sv), rotation);
+		read_floats(doc, member(doc, node, "scale"sv), scale);
+
+		return glm::translate(glm::mat4(1.0f), glm::make_vec3(translation.data()))
+		     * glm::mat4_cast(glm::quat{ rotation[3], rotation[0], rotation[1], rotation[2] })
+		     * glm::scale(glm::mat4(1.0f), glm::make_vec3(scale.data()));
+	}
+
+	// Walk default scene, or every root node if there is no scene, collecting nodes with meshes
+	auto collect_instances(const document &doc) -> std::vector<instance>
+	{
+		auto roots = std::vector<uint32_t>{};
+		auto scene = as_index(doc, member(doc, 0, "scene"sv));
+		if (scene == NONE and not doc.scenes.empty())
+			scene = 0;
+
+		if (scene < doc.scenes.size())
+		{
+			roots = children(doc, member(doc, doc.scenes[scene], "nodes"sv))
+			      | std::views::transform([&](uint32_t n) { return as_index(doc, n); })
+			      | std::ranges::to<std::vector>();
+		}
+		else
+		{
+			auto has_parent = std::vector<bool>(doc.nodes.size());
+			for (auto &&node : doc.nodes)
+			{
+				for (auto &&child : children(doc, member(doc, node, "children"sv)))
+				{
+					if (auto c = as_index(doc, child); c < has_parent.size())
+						has_parent[c] = true;
+				}
+			}
+			roots = std::views::iota(0u, static_cast<uint32_t>(doc.nodes.size()))
+			      | std::views::filter([&](uint32_t n) { return not has_parent[n]; })
+			      | std::ranges::to<std::vector>();
+		}
+
+		auto instances = std::vector<instance>{};
+		auto stack     = roots
+		           | std::views::transform([](uint32_t n) { return std::pair{ n, glm::mat4(1.0f) }; })
+		           | std::ranges::to<std::vector>();
+
+		// Node graph must be a forest, visit budget stops cycles in broken files
+		auto visits = doc.nodes.size();
+		while (not stack.empty() and visits-- > 0)
+		{
+			auto [index, parent] = stack.back();
+			stack.pop_back();
+			if (index >= doc.nodes.size())
+				continue;
+
+			auto node  = doc.nodes[index];
+			auto world = parent * local_transform(doc, node);
+
+			auto mesh = as_index(doc, member(doc, node, "mesh"sv));
+			if (mesh < doc.meshes.size())
+			{
+				instances.push_back({
+				  .mesh      = mesh,
+				  .skin      = as_index(doc, member(doc, node, "skin"sv)),
+				  .transform = to_transform(MIRROR_Z * world * MIRROR_Z),
+				});
+			}
+
+			for (auto &&child : children(doc, member(doc, node, "children"sv)))
+				stack.push_back({ as_index(doc, child), world });
+		}
+
+		return instances;
+	}
+
+	auto read_material(const document &doc, uint32_t node) -> material
+	{
+		auto pbr = member(doc, node, "pbrMetallicRoughness"sv);
+
+		auto mat = material{
+			.base_color       = { 1.0f, 1.0f, 1.0f, 1.0f },
+			.base_color_image = NONE,
+			.blend            = as_string(doc, member(doc, node, "alphaMode"sv)) == "BLEND"sv,
+			.double_sided     = as_number(doc, member(doc, node, "doubleSided"sv), 0.0) != 0.0,
+		};
+		read_floats(doc, member(doc, pbr, "baseColorFactor"sv), mat.base_color);
+
+		auto texture = as_index(doc, member(doc, member(doc, pbr, "baseColorTexture"sv), "index"sv));
+		if (texture < doc.textures.size())
+			mat.base_color_image = as_index(doc, member(doc, doc.textures[texture], "source"sv));
+
+		return mat;
+	}
+
+	auto convert_mesh(const source &src, uint32_t index, import_stats &stats) -> mesh
+	{
+		auto msh = mesh{};
+		for (auto &&node : children(src.doc, member(src.doc, src.doc.meshes[index], "primitives"sv)))
+		{
+			auto prim = convert_primitive(src, node, stats);
+			if (not prim)
+			{
+				++stats.skipped;
+				continue;
+			}
+
+			++stats.primitives;
+			stats.vertices_kept += prim->vertices.size();
+			stats.triangles += prim->indices.size() / 3;
+			msh.primitives.push_back(std::move(*prim));
+		}
+		return msh;
+	}
+
+	auto convert_skin(const source &src, uint32_t index) -> skin
+	{
+		auto &doc   = src.doc;
+		auto node   = doc.skins[index];
+		auto joints = children(doc, member(doc, node, "joints"sv))
+		            | std::views::transform([&](uint32_t j) { return as_index(doc, j); })
+		            | std::ranges::to<std::vector>();
+
+		// Identity when matrices are left out, per spec
+		auto inverse_bind = std::vector<sfile::transform>(joints.size(), to_transform(glm::mat4(1.0f)));
+
+		auto matrices = read_accessor(src, as_index(doc, member(doc, node, "inverseBindMatrices"sv)));
+		if (matrices and matrices->component == component_t::f32 and matrices->components == 16)
+		{
+			for (auto i : std::views::iota(0u, std::min<uint32_t>(matrices->count, static_cast<uint32_t>(joints.size()))))
+			{
+				auto m = glm::mat4{};
+				std::memcpy(glm::value_ptr(m), matrices->data.data() + uint64_t{ matrices->stride } * i, sizeof(m));
+				inverse_bind[i] = to_transform(MIRROR_Z * m * MIRROR_Z);
+			}
+		}
+
+		return { std::move(joints), std::move(inverse_bind) };
+	}
+
+	// Resolve image's file, or copy it's bytes out of buffer or data URI
+	auto convert_image(const source &src, uint32_t index) -> image
+	{
+		auto &doc = src.doc;
+		auto node = doc.images[index];
+
+		auto img = image{ .mime_type = std::string{ as_string(doc, member(doc, node, "mimeType"sv)) } };
+
+		auto uri = decode_uri(as_string(doc, member(doc, node, "uri"sv)));
+		if (uri.starts_with("data:"sv))
+		{
+			auto comma = uri.find(',');
+			if (comma != uri.npos)
+				img.bytes = decode_base64(std::string_view{ uri }.substr(comma + 1)).value_or(io::byte_array{});
+		}
+		else if (not uri.empty())
+		{
+			img.path = src.directory / std::filesystem::path{ uri };
+		}
+		else if (auto view = as_index(doc, member(doc, node, "bufferView"sv)); view < doc.buffer_views.size())
+		{
+			auto view_node = doc.buffer_views[view];
+			auto buffer    = as_index(doc, member(doc, view_node, "buffer"sv));
+			auto offset    = static_cast<uint64_t>(as_number(doc, member(doc, view_node, "byteOffset"sv), 0.0));
+			auto length    = static_cast<uint64_t>(as_number(doc, member(doc, view_node, "byteLength"sv), 0.0));
+			if (buffer < src.buffers.size() and offset + length <= src.buffers[buffer].size())
+			{
+				auto bytes = src.buffers[buffer].subspan(offset, length);
+				img.bytes.assign(bytes.begin(), bytes.end());
+			}
+		}
+
+		return img;
+	}
+
+	// Meshes, skins and images are converted in parallel, each task writes only it's own slot
+	auto import_file(const std::filesystem::path &filename, const import_desc &desc = {}) -> std::optional<asset>
+	{
+		auto start_ns = SDL_GetTicksNS();
+
+		auto src = open_source(filename);
+		if (not src)
+			return std::nullopt;
+
+		auto &doc = src->doc;
+		auto out  = asset{
+			.meshes = std::vector<mesh>(doc.meshes.size()),
+			.images = std::vector<image>(doc.images.size()),
+			.skins  = std::vector<skin>(doc.skins.size()),
+		};
+		auto mesh_stats = std::vector<import_stats>(doc.meshes.size());
+
+		auto workers = batch::worker_pool{};
+		batch::start_workers(workers, desc.worker_threads);
+
+		for (auto i : std::views::iota(0u, static_cast<uint32_t>(doc.meshes.size())))
+		{
+			batch::submit(workers, [&, i] { out.meshes[i] = convert_mesh(*src, i, mesh_stats[i]); }, desc.max_queued);
+		}
+		for (auto i : std::views::iota(0u, static_cast<uint32_t>(doc.skins.size())))
+		{
+			batch::submit(workers, [&, i] { out.skins[i] = convert_skin(*src, i); }, desc.max_queued);
+		}
+		for (auto i : std::views::iota(0u, static_cast<uint32_t>(doc.images.size())))
+		{
+			batch::submit(workers, [&, i] { out.images[i] = convert_image(*src, i); }, desc.max_queued);
+		}
+
+		// Scene graph and materials are small, done here while workers convert
+		out.instances = collect_instances(doc);
+		out.materials = doc.materials
+		              | std::views::transform([&](uint32_t node) { return read_material(doc, node); })
+		              | std::ranges::to<std::vector>();
+
+		batch::wait_idle(workers);
+		batch::stop_workers(workers);
+
+		for (auto &&s : mesh_stats)
+		{
+			out.stats.primitives += s.primitives;
+			out.stats.skipped += s.skipped;
+			out.stats.vertices_read += s.vertices_read;
+			out.stats.vertices_kept += s.vertices_kept;
+			out.stats.triangles += s.triangles;
+		}
+		out.stats.seconds = static_cast<double>(SDL_GetTicksNS() - start_ns) / 1'000'000'000.0;
+
+		msg::info(std::format("glTF: {} meshes, {} primitives ({} skipped), {} instances, {} skins, {} images.",
+		                      out.meshes.size(), out.stats.primitives, out.stats.skipped, out.instances.size(), out.skins.size(), out.images.size()));
+		msg::info(std::format("glTF: {} triangles, {} of {} vertices kept after welding, imported in {:.2f} s.",
+		                      out.stats.triangles, out.stats.vertices_kept, out.stats.vertices_read, out.stats.seconds));
+
+		return out;
+	}
+}
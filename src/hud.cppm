@@ -0,0 +1,457 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module hud;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import debug_draw;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Performance overlay: frame time percentiles, GPU time, draw calls and GPU memory.
+ * Text and frame time graph are quads from one bitmap glyph atlas, drawn with a single instanced draw.
+ */
+export namespace hud
+{
+	// Frame time samples kept for percentiles and graph
+	constexpr auto HISTORY_SIZE = 240u;
+	constexpr auto MAX_QUADS    = 4096u;
+
+	// 5x7 glyphs in 8x8 cells, printable ASCII from ' ' to DEL
+	constexpr auto GLYPH_WIDTH   = 5u;
+	constexpr auto GLYPH_HEIGHT  = 7u;
+	constexpr auto CELL_SIZE     = 8u;
+	constexpr auto FIRST_CHAR    = ' ';
+	constexpr auto SOLID_CHAR    = '\x7f'; // DEL cell is filled, used for panel and graph bars
+	constexpr auto ATLAS_COLUMNS = 16u;
+	constexpr auto ATLAS_ROWS    = 6u;
+	constexpr auto ATLAS_WIDTH   = ATLAS_COLUMNS * CELL_SIZE;
+	constexpr auto ATLAS_HEIGHT  = ATLAS_ROWS * CELL_SIZE;
+
+	// Layout, in pixels
+	constexpr auto TEXT_SCALE   = 2.0f;
+	constexpr auto LINE_HEIGHT  = (GLYPH_HEIGHT + 3) * TEXT_SCALE;
+	constexpr auto MARGIN       = 8.0f;
+	constexpr auto BAR_WIDTH    = 2.0f;
+	constexpr auto GRAPH_HEIGHT = 80.0f;
+
+	// Budget line on graph, and frame time at full graph height
+	constexpr auto TARGET_FRAME_MS = 1000.0f / 60.0f;
+	constexpr auto GRAPH_MAX_MS    = TARGET_FRAME_MS * 2.0f;
+
+	// Quad colors are RGBA8, packed same as debug lines
+	using dbg::rgba;
+
+	struct glyph
+	{
+		char code;
+		std::array<uint8_t, GLYPH_HEIGHT> rows; // top to bottom, bit 4 is left most column
+	};
+
+	// Only what overlay prints, lower case is drawn as upper case
+	constexpr auto GLYPHS = std::array{
+		glyph{ ' ', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 } },
+		glyph{ '0', { 0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110 } },
+		glyph{ '1', { 0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+		glyph{ '2', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111 } },
+		glyph{ '3', { 0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110 } },
+		glyph{ '4', { 0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010 } },
+		glyph{ '5', { 0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110 } },
+		glyph{ '6', { 0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110 } },
+		glyph{ '7', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000 } },
+		glyph{ '8', { 0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110 } },
+		glyph{ '9', { 0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100 } },
+		glyph{ 'A', { 0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+		glyph{ 'B', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110 } },
+		glyph{ 'C', { 0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110 } },
+		glyph{ 'D', { 0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100 } },
+		glyph{ 'E', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111 } },
+		glyph{ 'F', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000 } },
+		glyph{ 'G', { 0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111 } },
+		glyph{ 'H', { 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+		glyph{ 'I', { 0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+		glyph{ 'J', { 0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100 } },
+		glyph{ 'K', { 0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001 } },
+		glyph{ 'L', { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111 } },
+		glyph{ 'M', { 0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001 } },
+		glyph{ 'N', { 0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001 } },
+		glyph{ 'O', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+		glyph{ 'P', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000 } },
+		glyph{ 'Q', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101 } },
+		glyph{ 'R', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001 } },
+		glyph{ 'S', { 0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110 } },
+		glyph{ 'T', { 0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100 } },
+		glyph{ 'U', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+		glyph{ 'V', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100 } },
+		glyph{ 'W', { 0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010 } },
+		glyph{ 'X', { 0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001 } },
+		glyph{ 'Y', { 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100, 0b00100 } },
+		glyph{ 'Z', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111 } },
+		glyph{ '.', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100 } },
+		glyph{ ':', { 0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000 } },
+		glyph{ '%', { 0b11000, 0b11001, 0b00010, 0b00100, 0b01000, 0b10011, 0b00011 } },
+		glyph{ '/', { 0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000 } },
+		glyph{ '(', { 0b00010, 0b00100, 0b01000, 0b01000, 0b01000, 0b00100, 0b00010 } },
+		glyph{ ')', { 0b01000, 0b00100, 0b00010, 0b00010, 0b00010, 0b00100, 0b01000 } },
+		glyph{ '-', { 0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000 } },
+		glyph{ '=', { 0b00000, 0b00000, 0b11111, 0b00000, 0b11111, 0b00000, 0b00000 } },
+		glyph{ '_', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111 } },
+		glyph{ '<', { 0b00010, 0b00100, 0b01000, 0b10000, 0b01000, 0b00100, 0b00010 } },
+		glyph{ '>', { 0b01000, 0b00100, 0b00010, 0b00001, 0b00010, 0b00100, 0b01000 } },
+	};
+
+	// One instance per quad, layout matches screen_quad.vs.hlsl
+	struct quad
+	{
+		std::array<float, 4> rect; // x, y, width, height in pixels, origin top-left
+		std::array<float, 4> uv;   // u0, v0, u1, v1
+		uint32_t color;            // RGBA8
+	};
+
+	struct frame_stats
+	{
+		std::array<float, HISTORY_SIZE> frame_ms = {};
+		uint32_t head  = 0; // next sample to write
+		uint32_t count = 0;
+
+		float p50 = 0.0f;
+		float p95 = 0.0f;
+		float p99 = 0.0f;
+
+		float gpu_ms        = 0.0f;
+		uint32_t draw_calls = 0; // previous frame's, overlay draws after everything else
+		uint64_t gpu_memory = 0;
+	};
+
+	struct overlay
+	{
+		bool visible = true;
+
+		sdl3::gfx_pipeline_ptr pipeline;
+		sdl3::gpu_texture_ptr atlas;
+		sdl3::gpu_sampler_ptr sampler;
+		sdl3::gpu_buffer_ptr instance_buffer;
+
+		std::vector<quad> quads; // rebuilt every frame, capacity is kept
+		uint32_t quad_count = 0;
+
+		frame_stats stats;
+	};
+
+	// White texels with glyph coverage in alpha, so quad color tints it
+	auto make_atlas() -> std::vector<uint32_t>
+	{
+		constexpr auto WHITE = rgba(255, 255, 255);
+
+		auto pixels = std::vector<uint32_t>(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+
+		auto cell_origin = [](char code) {
+			auto idx = static_cast<uint32_t>(code - FIRST_CHAR);
+			return std::pair{ (idx % ATLAS_COLUMNS) * CELL_SIZE, (idx / ATLAS_COLUMNS) * CELL_SIZE };
+		};
+
+		for (auto &&[code, rows] : GLYPHS)
+		{
+			auto [cx, cy] = cell_origin(code);
+			for (auto y : std::views::iota(0u, GLYPH_HEIGHT))
+			{
+				for (auto x : std::views::iota(0u, GLYPH_WIDTH))
+				{
+					if (rows[y] & (1u << (GLYPH_WIDTH - 1 - x)))
+					{
+						pixels[(cy + y) * ATLAS_WIDTH + cx + x] = WHITE;
+					}
+				}
+			}
+		}
+
+		auto [sx, sy] = cell_origin(SOLID_CHAR);
+		for (auto y : std::views::iota(sy, sy + CELL_SIZE))
+		{
+			std::fill_n(pixels.begin() + y * ATLAS_WIDTH + sx, CELL_SIZE, WHITE);
+		}
+
+		return pixels;
+	}
+
+	// UV rect of glyph in atlas, empty for characters outside atlas
+	constexpr auto glyph_uv(char code) -> std::array<float, 4>
+	{
+		auto idx = static_cast<uint32_t>(code - FIRST_CHAR);
+		if (code < FIRST_CHAR or idx >= ATLAS_COLUMNS * ATLAS_ROWS)
+			return {};
+
+		auto x = static_cast<float>((idx % ATLAS_COLUMNS) * CELL_SIZE);
+		auto y = static_cast<float>((idx / ATLAS_COLUMNS) * CELL_SIZE);
+
+		return {
+			x / ATLAS_WIDTH,
+			y / ATLAS_HEIGHT,
+			(x + GLYPH_WIDTH) / ATLAS_WIDTH,
+			(y + GLYPH_HEIGHT) / ATLAS_HEIGHT,
+		};
+	}
+
+	auto init_overlay(const sdl3::context &ctx) -> overlay
+	{
+		auto gpu = ctx.gpu.get();
+
+		msg::info("Create Performance Overlay.");
+
+		using VA                              = SDL_GPUVertexAttribute;
+		constexpr static auto QUAD_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = sizeof(std::array<float, 4>),
+			},
+			VA{
+			  .location    = 2,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+			  .offset      = sizeof(std::array<float, 4>) * 2,
+			},
+		};
+
+		using VBD                               = SDL_GPUVertexBufferDescription;
+		constexpr static auto QUAD_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot               = 0,
+			  .pitch              = sizeof(quad),
+			  .input_rate         = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+			  .instance_step_rate = 1,
+			},
+		};
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary        = io::read_file("shaders/screen_quad.vs_6_4.cso"),
+			  .stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+			  .uniform_buffer_count = 1,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file(sdl3::shader_file(ctx, "textured_quad_tinted"sv, "ps_6_4"sv)),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			  .sampler_count = 1,
+			},
+			.vertex_attributes          = QUAD_ATTRIBUTES,
+			.vertex_buffer_descriptions = QUAD_BUFFER_DESCS,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+			.blend_mode                 = sdl3::blend_mode_t::alpha,
+			.queue                      = sdl3::render_queue_t::transparent,
+			.color_format               = sdl3::SWAPCHAIN_FORMAT, // drawn after post processing
+		};
+
+		auto ovl     = overlay{};
+		ovl.pipeline = sdl3::make_gfx_pipeline(ctx, desc);
+
+		auto atlas_desc = sdl3::texture_desc{
+			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+			.format     = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.width      = ATLAS_WIDTH,
+			.height     = ATLAS_HEIGHT,
+			.depth      = 1,
+			.mip_levels = 1,
+		};
+		ovl.atlas = sdl3::make_texture(gpu, atlas_desc, "HUD Glyph Atlas"sv);
+		sdl3::upload_texture(gpu, ovl.atlas.get(), io::as_byte_span(make_atlas()), ATLAS_WIDTH, ATLAS_HEIGHT);
+
+		ovl.sampler         = sdl3::make_sampler(gpu, sdl3::sampler_type::point_clamp);
+		ovl.instance_buffer = sdl3::make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, MAX_QUADS * sizeof(quad), "HUD Quad Buffer"sv);
+		ovl.quads.reserve(MAX_QUADS);
+
+		return ovl;
+	}
+
+	void destroy_overlay(overlay &ovl)
+	{
+		msg::info("Destroy Performance Overlay.");
+
+		ovl = {};
+	}
+
+	// Add frame's CPU time, and collect GPU side numbers from scene
+	void record_frame(overlay &ovl, float frame_ms, const sdl3::scene &scn)
+	{
+		auto &st = ovl.stats;
+
+		st.frame_ms[st.head] = frame_ms;
+		st.head              = (st.head + 1) % HISTORY_SIZE;
+		st.count             = std::min(st.count + 1, HISTORY_SIZE);
+
+		// Nearest rank percentiles, on a copy so graph keeps sample order
+		auto sorted = st.frame_ms;
+		auto valid  = std::span{ sorted.data(), st.count };
+		auto rank   = [&](float p) {
+			auto nth = valid.begin() + static_cast<std::ptrdiff_t>(std::ceil(p * st.count)) - 1;
+			std::ranges::nth_element(valid, nth);
+			return *nth;
+		};
+		st.p50 = rank(0.50f);
+		st.p95 = rank(0.95f);
+		st.p99 = rank(0.99f);
+
+		st.gpu_ms     = scn.timeline.gpu_ms;
+		st.gpu_memory = sdl3::gpu_memory_bytes.load();
+	}
+
+	// Append quads for a line of text, at pixel position
+	void add_text(std::vector<quad> &quads, float x, float y, std::string_view text, uint32_t color)
+	{
+		for (auto c : text)
+		{
+			auto code = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+			if (code != ' ')
+			{
+				quads.push_back({
+				  .rect  = { x, y, GLYPH_WIDTH * TEXT_SCALE, GLYPH_HEIGHT * TEXT_SCALE },
+				  .uv    = glyph_uv(code),
+				  .color = color,
+				});
+			}
+			x += (GLYPH_WIDTH + 1) * TEXT_SCALE;
+		}
+	}
+
+	// Append solid colored rectangle
+	void add_rect(std::vector<quad> &quads, float x, float y, float w, float h, uint32_t color)
+	{
+		quads.push_back({
+		  .rect  = { x, y, w, h },
+		  .uv    = glyph_uv(SOLID_CHAR),
+		  .color = color,
+		});
+	}
+
+	// Build this frame's quads and stage them in upload ring.
+	// Must be called before sdl3::begin_frame.
+	void prepare(const sdl3::context &ctx, overlay &ovl, sdl3::scene &scn)
+	{
+		ovl.quads.clear();
+		ovl.quad_count = 0;
+
+		if (not ovl.visible or ovl.stats.count == 0)
+			return;
+
+		constexpr auto PANEL_COLOR = rgba(0, 0, 0, 160);
+		constexpr auto TEXT_COLOR  = rgba(255, 255, 255);
+		constexpr auto LINE_COLOR  = rgba(255, 255, 255, 128);
+
+		auto &st     = ovl.stats;
+		auto last_ms = st.frame_ms[(st.head + HISTORY_SIZE - 1) % HISTORY_SIZE];
+
+		auto lines = std::array{
+			std::format("FRAME {:6.2f} MS {:5.0f} FPS", last_ms, 1000.0f / std::max(last_ms, 0.001f)),
+			std::format("P50 {:5.2f} P95 {:5.2f} P99 {:5.2f}", st.p50, st.p95, st.p99),
+			std::format("GPU {:6.2f} MS (FENCE)", st.gpu_ms),
+			std::format("DRAWS {}", st.draw_calls),
+			std::format("GPU MEM {:.1f} MB", static_cast<double>(st.gpu_memory) / (1024.0 * 1024.0)),
+		};
+
+		auto graph_width = HISTORY_SIZE * BAR_WIDTH;
+		auto text_height = lines.size() * LINE_HEIGHT;
+
+		// Background first, everything else blends on top
+		add_rect(ovl.quads, MARGIN, MARGIN,
+		         graph_width + MARGIN * 2, text_height + GRAPH_HEIGHT + MARGIN * 3,
+		         PANEL_COLOR);
+
+		auto y = MARGIN * 2;
+		for (auto &&line : lines)
+		{
+			add_text(ovl.quads, MARGIN * 2, y, line, TEXT_COLOR);
+			y += LINE_HEIGHT;
+		}
+
+		// Oldest sample on left, bars grow up from graph bottom
+		auto graph_bottom = y + GRAPH_HEIGHT;
+		auto first        = (st.head + HISTORY_SIZE - st.count) % HISTORY_SIZE;
+		for (auto i : std::views::iota(0u, st.count))
+		{
+			auto ms     = st.frame_ms[(first + i) % HISTORY_SIZE];
+			auto height = std::clamp(ms / GRAPH_MAX_MS, 0.0f, 1.0f) * GRAPH_HEIGHT;
+			auto color  = (ms <= TARGET_FRAME_MS)       ? rgba(64, 220, 64)
+			            : (ms <= TARGET_FRAME_MS * 1.5f) ? rgba(240, 200, 40)
+			                                             : rgba(230, 50, 50);
+
+			add_rect(ovl.quads, MARGIN * 2 + i * BAR_WIDTH, graph_bottom - height, BAR_WIDTH, height, color);
+		}
+
+		// Frame budget
+		auto budget_y = graph_bottom - (TARGET_FRAME_MS / GRAPH_MAX_MS) * GRAPH_HEIGHT;
+		add_rect(ovl.quads, MARGIN * 2, budget_y, graph_width, 1.0f, LINE_COLOR);
+
+		if (ovl.quads.size() > MAX_QUADS)
+		{
+			msg::error(false, "Too many HUD quads this frame.");
+			return;
+		}
+
+		if (sdl3::stage_upload(ctx.gpu.get(), scn.uploads, io::as_byte_span(ovl.quads), ovl.instance_buffer.get(), 0, true))
+		{
+			ovl.quad_count = static_cast<uint32_t>(ovl.quads.size());
+		}
+	}
+
+	// Draw overlay on top of swapchain image, after post processing
+	void draw(sdl3::frame_context &frm, overlay &ovl)
+	{
+		if (ovl.quad_count > 0)
+		{
+			auto screen_size = std::array{
+				static_cast<float>(frm.width),
+				static_cast<float>(frm.height),
+				0.0f,
+				0.0f,
+			};
+			SDL_PushGPUVertexUniformData(frm.cmd_buf, 0, screen_size.data(), static_cast<uint32_t>(sizeof(screen_size)));
+
+			auto color_target = SDL_GPUColorTargetInfo{
+				.texture  = frm.swapchain,
+				.load_op  = SDL_GPU_LOADOP_LOAD,
+				.store_op = SDL_GPU_STOREOP_STORE,
+			};
+
+			auto render_pass = SDL_BeginGPURenderPass(frm.cmd_buf, &color_target, 1, nullptr);
+			{
+				auto instance_binding = SDL_GPUBufferBinding{
+					.buffer = ovl.instance_buffer.get(),
+					.offset = 0,
+				};
+				SDL_BindGPUVertexBuffers(render_pass, 0, &instance_binding, 1);
+
+				auto sampler_binding = SDL_GPUTextureSamplerBinding{
+					.texture = ovl.atlas.get(),
+					.sampler = ovl.sampler.get(),
+				};
+				SDL_BindGPUFragmentSamplers(render_pass, 0, &sampler_binding, 1);
+
+				SDL_BindGPUGraphicsPipeline(render_pass, ovl.pipeline.get());
+
+				// 6 vertices per quad, made in vertex shader
+				SDL_DrawGPUPrimitives(render_pass, 6, ovl.quad_count, 0, 0);
+				++frm.draw_calls;
+			}
+			SDL_EndGPURenderPass(render_pass);
+		}
+
+		// Shown next frame
+		ovl.stats.draw_calls = frm.draw_calls;
+	}
+}
@@ -0,0 +1,398 @@
+export module image_encode;
+
+import std;
+import io;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * PNG and QOI encoders for 8 bit RGBA images, as read back from GPU.
+ * No external dependencies, and no shared state, so any number of threads can encode at once.
+ */
+export namespace encode
+{
+	enum class format_t
+	{
+		png,
+		qoi,
+	};
+
+	auto extension(format_t format) -> std::string_view
+	{
+		return (format == format_t::png) ? ".png"sv : ".qoi"sv;
+	}
+
+	auto parse_format(std::string_view name) -> std::optional<format_t>
+	{
+		if (name == "png"sv)
+			return format_t::png;
+		if (name == "qoi"sv)
+			return format_t::qoi;
+		return std::nullopt;
+	}
+
+	// Append big-endian uint32, both formats store header fields this way
+	void put_u32be(io::byte_array &out, uint32_t value)
+	{
+		out.push_back(static_cast<std::byte>(value >> 24));
+		out.push_back(static_cast<std::byte>(value >> 16));
+		out.push_back(static_cast<std::byte>(value >> 8));
+		out.push_back(static_cast<std::byte>(value));
+	}
+
+	void put_bytes(io::byte_array &out, std::string_view bytes)
+	{
+		for (auto c : bytes)
+			out.push_back(static_cast<std::byte>(c));
+	}
+
+	// CRC-32 with polynomial 0xEDB88320, as used by PNG chunks
+	constexpr auto CRC_TABLE = [] {
+		auto table = std::array<uint32_t, 256>{};
+		for (auto n : std::views::iota(0u, 256u))
+		{
+			auto c = n;
+			for (auto k = 0; k < 8; ++k)
+				c = (c & 1) ? 0xEDB8'8320u ^ (c >> 1) : (c >> 1);
+			table[n] = c;
+		}
+		return table;
+	}();
+
+	auto crc32(std::span<const std::byte> data, uint32_t crc = 0) -> uint32_t
+	{
+		crc = ~crc;
+		for (auto b : data)
+			crc = CRC_TABLE[(crc ^ std::to_integer<uint32_t>(b)) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	auto adler32(std::span<const std::byte> data) -> uint32_t
+	{
+		constexpr auto MOD_ADLER = 65521u;
+		constexpr auto NMAX      = 5552u; // most bytes before sums can overflow uint32
+
+		auto a = 1u, b = 0u;
+		while (not data.empty())
+		{
+			auto chunk = data.first(std::min<size_t>(data.size(), NMAX));
+			for (auto byte : chunk)
+			{
+				a += std::to_integer<uint32_t>(byte);
+				b += a;
+			}
+			a %= MOD_ADLER;
+			b %= MOD_ADLER;
+			data = data.subspan(chunk.size());
+		}
+		return (b << 16) | a;
+	}
+
+	// LSB first bit stream, as deflate wants
+	struct bit_writer
+	{
+		io::byte_array &out;
+		uint64_t bits  = 0;
+		uint32_t count = 0;
+
+		void put(uint32_t value, uint32_t bit_count)
+		{
+			bits |= static_cast<uint64_t>(value) << count;
+			count += bit_count;
+			while (count >= 8)
+			{
+				out.push_back(static_cast<std::byte>(bits & 0xFF));
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		void flush()
+		{
+			if (count > 0)
+				out.push_back(static_cast<std::byte>(bits & 0xFF));
+			bits  = 0;
+			count = 0;
+		}
+	};
+
+	// Huffman codes are stored most significant bit first
+	constexpr auto reverse_bits(uint32_t code, uint32_t bit_count) -> uint32_t
+	{
+		auto result = 0u;
+		for (auto i = 0u; i < bit_count; ++i)
+		{
+			result = (result << 1) | (code & 1);
+			code >>= 1;
+		}
+		return result;
+	}
+
+	// Fixed Huffman code for literal/length symbol, RFC 1951 section 3.2.6
+	void put_symbol(bit_writer &bw, uint32_t symbol)
+	{
+		if (symbol < 144)
+			bw.put(reverse_bits(0x30 + symbol, 8), 8);
+		else if (symbol < 256)
+			bw.put(reverse_bits(0x190 + symbol - 144, 9), 9);
+		else if (symbol < 280)
+			bw.put(reverse_bits(symbol - 256, 7), 7);
+		else
+			bw.put(reverse_bits(0xC0 + symbol - 280, 8), 8);
+	}
+
+	constexpr auto LENGTH_BASE  = std::array<uint16_t, 29>{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr auto LENGTH_EXTRA = std::array<uint8_t, 29>{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr auto DIST_BASE    = std::array<uint16_t, 30>{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr auto DIST_EXTRA   = std::array<uint8_t, 30>{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	void put_match(bit_writer &bw, uint32_t length, uint32_t distance)
+	{
+		auto li = static_cast<uint32_t>(std::ranges::upper_bound(LENGTH_BASE, length) - LENGTH_BASE.begin()) - 1;
+		put_symbol(bw, 257 + li);
+		bw.put(length - LENGTH_BASE[li], LENGTH_EXTRA[li]);
+
+		auto di = static_cast<uint32_t>(std::ranges::upper_bound(DIST_BASE, distance) - DIST_BASE.begin()) - 1;
+		bw.put(reverse_bits(di, 5), 5);
+		bw.put(distance - DIST_BASE[di], DIST_EXTRA[di]);
+	}
+
+	// zlib stream with one fixed Huffman block.
+	// Greedy LZ77 with single entry hash table, fast rather than small, it runs once per batch image.
+	auto zlib_compress(std::span<const std::byte> data) -> io::byte_array
+	{
+		constexpr auto WINDOW_SIZE = 32'768u;
+		constexpr auto MIN_MATCH   = 3u;
+		constexpr auto MAX_MATCH   = 258u;
+		constexpr auto HASH_BITS   = 15u;
+
+		auto out = io::byte_array{};
+		out.reserve(data.size() / 2 + 64);
+		out.push_back(std::byte{ 0x78 }); // deflate, 32K window
+		out.push_back(std::byte{ 0x01 }); // no dictionary, fastest compression
+
+		auto bw = bit_writer{ out };
+		bw.put(1, 1); // final block
+		bw.put(1, 2); // fixed Huffman codes
+
+		auto size = data.size();
+		auto at   = [&](size_t i) { return std::to_integer<uint32_t>(data[i]); };
+		auto hash = [&](size_t i) {
+			auto v = at(i) | (at(i + 1) << 8) | (at(i + 2) << 16);
+			return (v * 2654435761u) >> (32 - HASH_BITS);
+		};
+
+		auto head = std::vector<int64_t>(1u << HASH_BITS, -1);
+
+		auto i = size_t{ 0 };
+		while (i < size)
+		{
+			auto length = 0u;
+			auto dist   = 0u;
+
+			if (i + MIN_MATCH <= size)
+			{
+				auto h    = hash(i);
+				auto cand = head[h];
+				head[h]   = static_cast<int64_t>(i);
+
+				if (cand >= 0 and i - static_cast<size_t>(cand) <= WINDOW_SIZE)
+				{
+					auto max_len = static_cast<uint32_t>(std::min<size_t>(MAX_MATCH, size - i));
+					while (length < max_len and data[cand + length] == data[i + length])
+						++length;
+					dist = static_cast<uint32_t>(i - static_cast<size_t>(cand));
+				}
+			}
+
+			if (length >= MIN_MATCH)
+			{
+				put_match(bw, length, dist);
+				for (auto j = i + 1; j < i + length and j + MIN_MATCH <= size; ++j)
+					head[hash(j)] = static_cast<int64_t>(j);
+				i += length;
+			}
+			else
+			{
+				put_symbol(bw, at(i));
+				++i;
+			}
+		}
+		put_symbol(bw, 256); // end of block
+		bw.flush();
+
+		put_u32be(out, adler32(data));
+		return out;
+	}
+
+	void put_chunk(io::byte_array &out, std::string_view type, std::span<const std::byte> payload)
+	{
+		put_u32be(out, static_cast<uint32_t>(payload.size()));
+
+		auto start = out.size();
+		put_bytes(out, type);
+		out.insert(out.end(), payload.begin(), payload.end());
+
+		put_u32be(out, crc32(std::span{ out }.subspan(start)));
+	}
+
+	// 8 bit RGBA PNG, every row uses Paeth filter
+	auto png(std::span<const std::byte> rgba, uint32_t width, uint32_t height) -> io::byte_array
+	{
+		auto stride = size_t{ width } * 4;
+
+		auto filtered = io::byte_array{};
+		filtered.reserve((stride + 1) * height);
+
+		auto paeth = [](int a, int b, int c) {
+			auto p  = a + b - c;
+			auto pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+			return (pa <= pb and pa <= pc) ? a : (pb <= pc) ? b : c;
+		};
+
+		for (auto y : std::views::iota(0u, height))
+		{
+			auto row  = rgba.subspan(y * stride, stride);
+			auto prev = (y > 0) ? rgba.subspan((y - 1) * stride, stride) : std::span<const std::byte>{};
+
+			filtered.push_back(std::byte{ 4 }); // Paeth
+			for (auto x : std::views::iota(size_t{ 0 }, stride))
+			{
+				auto a = (x >= 4) ? std::to_integer<int>(row[x - 4]) : 0;
+				auto b = (y > 0) ? std::to_integer<int>(prev[x]) : 0;
+				auto c = (x >= 4 and y > 0) ? std::to_integer<int>(prev[x - 4]) : 0;
+				filtered.push_back(static_cast<std::byte>(std::to_integer<int>(row[x]) - paeth(a, b, c)));
+			}
+		}
+
+		auto out = io::byte_array{};
+		put_bytes(out, "\x89PNG\r\n\x1a\n"sv);
+
+		auto header = io::byte_array{};
+		put_u32be(header, width);
+		put_u32be(header, height);
+		header.push_back(std::byte{ 8 }); // bit depth
+		header.push_back(std::byte{ 6 }); // RGBA
+		header.push_back(std::byte{ 0 }); // deflate
+		header.push_back(std::byte{ 0 }); // adaptive filtering
+		header.push_back(std::byte{ 0 }); // not interlaced
+		put_chunk(out, "IHDR"sv, header);
+
+		put_chunk(out, "IDAT"sv, zlib_compress(filtered));
+		put_chunk(out, "IEND"sv, {});
+
+		return out;
+	}
+
+	// 8 bit RGBA QOI, https://qoiformat.org/qoi-specification.pdf
+	auto qoi(std::span<const std::byte> rgba, uint32_t width, uint32_t height) -> io::byte_array
+	{
+		constexpr auto OP_INDEX = uint8_t{ 0x00 };
+		constexpr auto OP_DIFF  = uint8_t{ 0x40 };
+		constexpr auto OP_LUMA  = uint8_t{ 0x80 };
+		constexpr auto OP_RUN   = uint8_t{ 0xC0 };
+		constexpr auto OP_RGB   = uint8_t{ 0xFE };
+		constexpr auto OP_RGBA  = uint8_t{ 0xFF };
+		constexpr auto MAX_RUN  = 62u;
+
+		using pixel = std::array<uint8_t, 4>;
+
+		auto out = io::byte_array{};
+		out.reserve(size_t{ width } * height * 4 / 2 + 22);
+
+		put_bytes(out, "qoif"sv);
+		put_u32be(out, width);
+		put_u32be(out, height);
+		out.push_back(std::byte{ 4 }); // channels
+		out.push_back(std::byte{ 0 }); // sRGB with linear alpha
+
+		auto put = [&](uint32_t value) { out.push_back(static_cast<std::byte>(value)); };
+
+		auto index = std::array<pixel, 64>{};
+		auto prev  = pixel{ 0, 0, 0, 255 };
+		auto run   = 0u;
+
+		auto pixel_count = size_t{ width } * height;
+		for (auto i : std::views::iota(size_t{ 0 }, pixel_count))
+		{
+			auto px = pixel{};
+			std::memcpy(px.data(), rgba.data() + i * 4, 4);
+
+			if (px == prev)
+			{
+				++run;
+				if (run == MAX_RUN or i + 1 == pixel_count)
+				{
+					put(OP_RUN | (run - 1));
+					run = 0;
+				}
+				continue;
+			}
+
+			if (run > 0)
+			{
+				put(OP_RUN | (run - 1));
+				run = 0;
+			}
+
+			auto slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+			if (index[slot] == px)
+			{
+				put(OP_INDEX | slot);
+			}
+			else
+			{
+				index[slot] = px;
+
+				if (px[3] == prev[3])
+				{
+					auto dr = static_cast<int8_t>(px[0] - prev[0]);
+					auto dg = static_cast<int8_t>(px[1] - prev[1]);
+					auto db = static_cast<int8_t>(px[2] - prev[2]);
+
+					auto dr_dg = static_cast<int8_t>(dr - dg);
+					auto db_dg = static_cast<int8_t>(db - dg);
+
+					if (dr >= -2 and dr <= 1 and dg >= -2 and dg <= 1 and db >= -2 and db <= 1)
+					{
+						put(OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+					}
+					else if (dg >= -32 and dg <= 31 and dr_dg >= -8 and dr_dg <= 7 and db_dg >= -8 and db_dg <= 7)
+					{
+						put(OP_LUMA | (dg + 32));
+						put(((dr_dg + 8) << 4) | (db_dg + 8));
+					}
+					else
+					{
+						put(OP_RGB);
+						put(px[0]);
+						put(px[1]);
+						put(px[2]);
+					}
+				}
+				else
+				{
+					put(OP_RGBA);
+					put(px[0]);
+					put(px[1]);
+					put(px[2]);
+					put(px[3]);
+				}
+			}
+			prev = px;
+		}
+
+		// End marker, 7 zeros and a one
+		for (auto i = 0; i < 7; ++i)
+			put(0);
+		put(1);
+
+		return out;
+	}
+
+	auto encode(format_t format, std::span<const std::byte> rgba, uint32_t width, uint32_t height) -> io::byte_array
+	{
+		return (format == format_t::png) ? png(rgba, width, height) : qoi(rgba, width, height);
+	}
+}
@@ -40,6 +40,18 @@ export namespace io
 		return buffer;
 	}
 
+	// Write whole span in to file in binary mode, replacing file if it exists.
+	// Doesn't log, it's called from worker threads in batch mode.
+	auto write_file(const std::filesystem::path &filename, std::span<const std::byte> data) -> bool
+	{
+		auto file = std::ofstream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (not file.good())
+			return false;
+
+		file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+		return file.good();
+	}
+
 	// Convert any object type to a span of bytes
 	auto as_byte_span(const auto &src) -> byte_span
 	{
@@ -18,6 +18,21 @@ import logs;
 import io;
 import sdl3_init;
 import sdl3_scene;
+import sdl3_postfx;
+import debug_draw;
+import hud;
+import sprite_batch;
+import sort;
+import scenario;
+import basic_scenarios;
+import image_encode;
+import batch;
+import tiled_export;
+import render_service;
+import world_partition;
+import geometry_residency;
+import scene_file;
+import gltf_import;
 
 // literal suffixes for strings, string_view, etc
 using namespace std::literals;
@@ -27,15 +42,17 @@ using namespace std::literals;
  */
 namespace app
 {
-	auto quit = false;
+	auto quit    = false;
+	auto capture = false; // read back scene color at end of next frame
 
-	void update(float &angle, float &cam_y)
+	// Model gltf_viewer opens, set by --import
+	auto gltf_file = std::filesystem::path{ "data/model.glb" };
+
+	// Camera orbits around origin with A/D, moves up and down with W/S
+	void update_camera(float &angle, float &cam_y)
 	{
 		auto *key_states = SDL_GetKeyboardState(nullptr);
 
-		if (key_states[SDL_SCANCODE_ESCAPE])
-			quit = true;
-
 		if (key_states[SDL_SCANCODE_A] or key_states[SDL_SCANCODE_LEFT])
 			angle -= 0.5f;
 		if (key_states[SDL_SCANCODE_D] or key_states[SDL_SCANCODE_RIGHT])
@@ -50,6 +67,74 @@ namespace app
 			cam_y -= 0.1f;
 	}
 
+	void toggle(bool &flag, std::string_view name)
+	{
+		flag = not flag;
+		msg::info(std::format("{}: {}", name, flag ? "on" : "off"));
+	}
+
+	// Layout presets for procedural instances, cycled with L
+	auto procedural_preset(sdl3::layout_t layout) -> sdl3::procedural_params
+	{
+		using lt = sdl3::layout_t;
+		switch (layout)
+		{
+		case lt::grid:
+			return {
+				.layout  = lt::grid,
+				.count   = 256 * 256,
+				.columns = 256,
+				.origin  = { 0.0f, -1.0f, 0.0f },
+				.spacing = 0.1f,
+				.scale   = 0.05f,
+			};
+		case lt::ring:
+			return {
+				.layout  = lt::ring,
+				.count   = 64,
+				.spacing = 4.0f,
+				.scale   = 0.3f,
+			};
+		case lt::scatter:
+			return {
+				.layout  = lt::scatter,
+				.count   = 10'000,
+				.seed    = 1234,
+				.origin  = { 0.0f, -1.0f, 0.0f },
+				.spacing = 12.0f,
+				.scale   = 0.08f,
+			};
+		case lt::noise:
+			return {
+				.layout    = lt::noise,
+				.count     = 128 * 128,
+				.columns   = 128,
+				.seed      = 42,
+				.origin    = { 0.0f, -1.5f, 0.0f },
+				.spacing   = 0.15f,
+				.scale     = 0.12f,
+				.amplitude = 0.5f,
+			};
+		}
+		return {};
+	}
+
+	// off -> grid -> ring -> scatter -> noise -> off
+	void cycle_procedural(sdl3::procedural_params &params)
+	{
+		using lt = sdl3::layout_t;
+
+		if (params.count == 0)
+			params = procedural_preset(lt::grid);
+		else if (params.layout == lt::noise)
+			params = {};
+		else
+			params = procedural_preset(static_cast<lt>(std::to_underlying(params.layout) + 1));
+
+		constexpr static auto names = std::array{ "grid"sv, "ring"sv, "scatter"sv, "noise"sv };
+		msg::info(std::format("Procedural instances: {}", params.count == 0 ? "off"sv : names.at(std::to_underlying(params.layout))));
+	}
+
 	struct vertex
 	{
 		glm::vec3 pos;
@@ -62,6 +147,14 @@ namespace app
 		std::vector<uint32_t> indices;
 	};
 
+	// Position only copy of vertex stream, used by depth prepass so it doesn't fetch uv
+	auto make_position_stream(const mesh &msh) -> std::vector<glm::vec3>
+	{
+		return msh.vertices
+		     | std::views::transform(&vertex::pos)
+		     | std::ranges::to<std::vector>();
+	}
+
 	auto make_cube() -> mesh
 	{
 		auto x = 0.5f, y = 0.5f, z = 0.5f;
@@ -136,7 +229,46 @@ namespace app
 		};
 	}
 
-	auto get_pipeline_desc() -> std::vector<sdl3::pipeline_desc>
+	// Glass cubes around the opaque ones, drawn in transparent queue
+	auto make_glass_cube_instances() -> instance_data
+	{
+		auto offsets = std::array{
+			glm::vec3{ +1.5f, 0.f, +1.5f },
+			glm::vec3{ -1.5f, 0.f, +1.5f },
+			glm::vec3{ +1.5f, 0.f, -1.5f },
+			glm::vec3{ -1.5f, 0.f, -1.5f },
+		};
+
+		return {
+			offsets
+			  | std::views::transform([](const glm::vec3 &offset) {
+					return glm::translate(glm::mat4(1.0f), offset);
+				})
+			  | std::ranges::to<std::vector>(),
+		};
+	}
+
+	// Order instances by view space depth using radix sort.
+	// Opaque instances go front-to-back for early depth rejection, transparent back-to-front for correct blending.
+	auto sort_by_view_depth(std::span<const glm::mat4> transforms, const glm::mat4 &view, sdl3::render_queue_t queue) -> std::vector<glm::mat4>
+	{
+		auto back_to_front = (queue == sdl3::render_queue_t::transparent);
+
+		auto keys = transforms
+		          | std::views::transform([&](const glm::mat4 &transform) {
+						auto depth = (view * transform[3]).z;
+						return sort::float_key(back_to_front ? -depth : depth);
+					})
+		          | std::ranges::to<std::vector>();
+
+		return sort::radix_sort(keys)
+		     | std::views::transform([&](uint32_t idx) {
+				   return transforms[idx];
+			   })
+		     | std::ranges::to<std::vector>();
+	}
+
+	auto get_pipeline_desc(const sdl3::context &ctx) -> std::vector<sdl3::pipeline_desc>
 	{
 		using VA                                = SDL_GPUVertexAttribute;
 		constexpr static auto VERTEX_ATTRIBUTES = std::array{
@@ -178,6 +310,40 @@ namespace app
 			},
 		};
 
+		// Depth prepass reads position only stream in slot 0, and same instance stream in slot 1
+		constexpr static auto POSITION_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 1,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 2,
+			  .buffer_slot = 1,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = sizeof(glm::vec4),
+			},
+			VA{
+			  .location    = 3,
+			  .buffer_slot = 1,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = sizeof(glm::vec4) * 2,
+			},
+			VA{
+			  .location    = 4,
+			  .buffer_slot = 1,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+			  .offset      = sizeof(glm::vec4) * 3,
+			},
+		};
+
 		using VBD                                 = SDL_GPUVertexBufferDescription;
 		constexpr static auto VERTEX_BUFFER_DESCS = std::array{
 			VBD{
@@ -193,12 +359,42 @@ namespace app
 			},
 		};
 
+		constexpr static auto POSITION_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot       = 0,
+			  .pitch      = sizeof(glm::vec3),
+			  .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+			},
+			VBD{
+			  .slot               = 1,
+			  .pitch              = sizeof(glm::mat4),
+			  .input_rate         = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+			  .instance_step_rate = 1,
+			},
+		};
+
 		auto vs_bin = io::read_file("shaders/instanced_mesh.vs_6_4.cso");
-		auto fs_bin = io::read_file("shaders/textured_quad.ps_6_4.cso");
+		auto fs_bin = io::read_file(sdl3::shader_file(ctx, "textured_quad"sv, "ps_6_4"sv));
+
+		auto glass_fs_bin = io::read_file(sdl3::shader_file(ctx, "transparent_mesh"sv, "ps_6_4"sv));
+		auto oit_fs_bin   = io::read_file("shaders/oit_accumulate.ps_6_4.cso");
+
+		auto fullscreen_vs_bin    = io::read_file("shaders/fullscreen.vs_6_4.cso");
+		auto oit_composite_fs_bin = io::read_file("shaders/oit_composite.ps_6_4.cso");
 
 		auto grid_vs_bin = io::read_file("shaders/grid.vs_6_4.cso");
-		auto grid_fs_bin = io::read_file("shaders/grid.ps_6_4.cso");
+		auto grid_fs_bin = io::read_file(sdl3::shader_file(ctx, "grid"sv, "ps_6_4"sv));
+
+		auto depth_vs_bin = io::read_file("shaders/depth_only.vs_6_4.cso");
+		auto depth_fs_bin = io::read_file("shaders/depth_only.ps_6_4.cso");
+
+		auto procedural_vs_bin = io::read_file("shaders/procedural_instance.vs_6_4.cso");
+
+		auto camera_motion_fs_bin     = io::read_file("shaders/camera_motion.ps_6_4.cso");
+		auto procedural_motion_vs_bin = io::read_file("shaders/procedural_motion.vs_6_4.cso");
+		auto motion_fs_bin            = io::read_file("shaders/motion.ps_6_4.cso");
 
+		// Order must match sdl3::pipeline_id
 		return {
 			{
 			  .vertex = sdl3::shader_desc{
@@ -229,6 +425,146 @@ namespace app
 			  },
 			  .depth_test = true,
 			  .cull_mode  = sdl3::cull_mode_t::none,
+			  .blend_mode = sdl3::blend_mode_t::alpha, // lines fade out, but grid stays in opaque queue so it still writes depth
+			},
+			{
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = depth_vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 1,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary = depth_fs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			  },
+			  .vertex_attributes          = POSITION_ATTRIBUTES,
+			  .vertex_buffer_descriptions = POSITION_BUFFER_DESCS,
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			  .depth_only                 = true,
+			},
+			{
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 1,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary = fs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count = 1,
+			  },
+			  .vertex_attributes          = VERTEX_ATTRIBUTES,
+			  .vertex_buffer_descriptions = VERTEX_BUFFER_DESCS,
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			  .depth_compare              = SDL_GPU_COMPAREOP_EQUAL,
+			  .depth_write                = false,
+			},
+			{
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 1,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary        = glass_fs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count        = 1,
+				.uniform_buffer_count = 1,
+			  },
+			  .vertex_attributes          = VERTEX_ATTRIBUTES,
+			  .vertex_buffer_descriptions = VERTEX_BUFFER_DESCS,
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			  .blend_mode                 = sdl3::blend_mode_t::alpha,
+			  .queue                      = sdl3::render_queue_t::transparent,
+			},
+			{
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 1,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary        = oit_fs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count        = 1,
+				.uniform_buffer_count = 1,
+			  },
+			  .vertex_attributes          = VERTEX_ATTRIBUTES,
+			  .vertex_buffer_descriptions = VERTEX_BUFFER_DESCS,
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			  .blend_mode                 = sdl3::blend_mode_t::weighted_oit,
+			  .queue                      = sdl3::render_queue_t::transparent,
+			},
+			{
+			  .vertex = sdl3::shader_desc{
+				.shader_binary = fullscreen_vs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary = oit_composite_fs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count = 2,
+			  },
+			  .depth_test = false,
+			  .cull_mode  = sdl3::cull_mode_t::none,
+			  .blend_mode = sdl3::blend_mode_t::alpha,
+			  .queue      = sdl3::render_queue_t::transparent,
+			},
+			{
+			  // Vertex stream only, placement comes from uniform parameter block in slot 1
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = procedural_vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 2,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary = fs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count = 1,
+			  },
+			  .vertex_attributes          = std::span{ VERTEX_ATTRIBUTES }.first(2),
+			  .vertex_buffer_descriptions = std::span{ VERTEX_BUFFER_DESCS }.first(1),
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			},
+			{
+			  // Motion from camera alone, reprojected from scene depth
+			  .vertex = sdl3::shader_desc{
+				.shader_binary = fullscreen_vs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_VERTEX,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary        = camera_motion_fs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_FRAGMENT,
+				.sampler_count        = 1,
+				.uniform_buffer_count = 1,
+			  },
+			  .depth_test   = false,
+			  .cull_mode    = sdl3::cull_mode_t::none,
+			  .color_format = sdl3::MOTION_FORMAT,
+			},
+			{
+			  // Procedural instances at this and last frame's time, only where they are visible
+			  .vertex = sdl3::shader_desc{
+				.shader_binary        = procedural_motion_vs_bin,
+				.stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+				.uniform_buffer_count = 4,
+			  },
+			  .fragment = sdl3::shader_desc{
+				.shader_binary = motion_fs_bin,
+				.stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			  },
+			  .vertex_attributes          = std::span{ VERTEX_ATTRIBUTES }.first(2),
+			  .vertex_buffer_descriptions = std::span{ VERTEX_BUFFER_DESCS }.first(1),
+			  .depth_test                 = true,
+			  .cull_mode                  = sdl3::cull_mode_t::back_ccw,
+			  .depth_compare              = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
+			  .depth_write                = false,
+			  .color_format               = sdl3::MOTION_FORMAT,
 			},
 		};
 	}
@@ -238,6 +574,51 @@ namespace app
 		return io::read_image_file("data/uv_grid.dds");
 	}
 
+	// Bounds of every instance, and world axes on top of everything
+	void add_debug_shapes(std::span<const glm::mat4> opaque, std::span<const glm::mat4> transparent)
+	{
+		for (auto &&transform : opaque)
+		{
+			dbg::box(transform, dbg::color::YELLOW);
+		}
+		for (auto &&transform : transparent)
+		{
+			dbg::box(transform, dbg::color::CYAN);
+			dbg::sphere(glm::vec3(transform[3]), 0.866f, dbg::color::MAGENTA); // bounding sphere of unit cube
+		}
+
+		dbg::line({ 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, dbg::color::RED, dbg::depth_t::overlay);
+		dbg::line({ 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, dbg::color::GREEN, dbg::depth_t::overlay);
+		dbg::line({ 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, dbg::color::BLUE, dbg::depth_t::overlay);
+	}
+
+	// Screen space marker over every instance, spinning with camera angle
+	void add_markers(sprites::batch &btch, uint16_t texture,
+	                 std::span<const glm::mat4> transforms, uint16_t layer,
+	                 const std::array<glm::mat4, 2> &view_proj,
+	                 float width, float height, float angle)
+	{
+		auto &[projection, view] = view_proj;
+		for (auto &&transform : transforms)
+		{
+			auto clip = projection * view * transform[3];
+			if (clip.w <= 0.0f)
+				continue;
+
+			auto ndc = glm::vec2(clip) / clip.w;
+			auto marker = sprites::sprite{
+				.position = { (ndc.x * 0.5f + 0.5f) * width, (0.5f - ndc.y * 0.5f) * height },
+				.rotation = angle,
+				.scale    = { 32.0f, 32.0f },
+				.uv       = { 0.0f, 0.0f, 1.0f, 1.0f },
+				.color    = dbg::rgba(255, 255, 255, 192),
+				.layer    = layer,
+				.texture  = texture,
+			};
+			sprites::add(btch, marker);
+		}
+	}
+
 	auto get_projection(uint32_t width, uint32_t height, float angle, float cam_y) -> std::array<glm::mat4, 2>
 	{
 		auto fov          = glm::radians(90.0f);
@@ -260,53 +641,1208 @@ namespace app
 			view,
 		};
 	}
-}
 
-auto main() -> int
-{
-	constexpr auto app_title = "SDL3 GPU minimal example."sv;
-	constexpr auto width     = 1920;
-	constexpr auto height    = 1080;
+	// Scale and offset clip space, so only tile's part of projection fills render target.
+	// Same result as an off-center frustum around tile.
+	auto crop_projection(const glm::mat4 &projection, const scenario::tile_view &tile) -> glm::mat4
+	{
+		auto x0 = 2.0f * tile.x / tile.image_width - 1.0f;
+		auto x1 = 2.0f * (tile.x + tile.width) / tile.image_width - 1.0f;
+		auto y0 = 1.0f - 2.0f * (tile.y + tile.height) / tile.image_height; // image rows go down, NDC y goes up
+		auto y1 = 1.0f - 2.0f * tile.y / tile.image_height;
+
+		auto crop  = glm::mat4(1.0f);
+		crop[0][0] = 2.0f / (x1 - x0);
+		crop[1][1] = 2.0f / (y1 - y0);
+		crop[3][0] = -(x1 + x0) / (x1 - x0);
+		crop[3][1] = -(y1 + y0) / (y1 - y0);
 
-	auto angle = 0.f;
-	auto cam_y = 0.f;
+		return crop * projection;
+	}
 
-	auto view_proj      = app::get_projection(width, height, glm::radians(angle), cam_y);
-	auto texture        = app::load_texture();
-	auto cube_mesh      = app::make_cube();
-	auto cube_instances = app::make_cube_instances();
-	auto pl_descs       = app::get_pipeline_desc();
+	// Spinning cubes scene, with transparency, debug shapes and screen markers on top
+	struct textured_mesh_state
+	{
+		float angle = 0.f;
+		float cam_y = 0.f;
+		float width;
+		float height;
 
-	auto ctx = sdl3::init_context(width, height, app_title);
-	auto scn = sdl3::init_scene(
-		ctx,
-		pl_descs,
-		io::as_byte_span(cube_mesh.vertices), static_cast<uint32_t>(cube_mesh.vertices.size()),
-		io::as_byte_span(cube_mesh.indices), static_cast<uint32_t>(cube_mesh.indices.size()),
-		io::as_byte_span(cube_instances.transforms), static_cast<uint32_t>(cube_instances.transforms.size()),
-		texture);
+		bool show_debug   = true;
+		bool show_markers = true;
 
-	scn.clear_color = { 0.4f, 0.4f, 0.4f, 1.0f };
+		std::array<glm::mat4, 2> view_proj;
+		std::optional<glm::mat4> previous_view_projection; // last frame's, without jitter, for temporal upscaling
+		std::optional<scenario::tile_view> tile;           // tiled export, set_tile crops projection to this
+		instance_data cube_instances;
+		instance_data glass_cubes;
 
-	auto e = SDL_Event{};
-	while (not app::quit)
+		dbg::renderer dbg_rndr;
+		sprites::batch sprite_batch;
+		uint16_t marker_texture;
+	};
+
+	// Procedural grid used by textured_mesh_stress, 1M instances
+	constexpr auto STRESS_GRID_SIDE = 1024u;
+
+	// Column major floats, as HLSL reads them
+	auto to_array(const glm::mat4 &m) -> std::array<float, 16>
 	{
-		while (SDL_PollEvent(&e))
+		auto result = std::array<float, 16>{};
+		std::ranges::copy(std::span{ glm::value_ptr(m), 16 }, result.begin());
+		return result;
+	}
+
+	// Shift projection by this frame's sub-pixel jitter, and give temporal upscaler camera motion since last frame
+	void jitter_projection(const sdl3::context &ctx, sdl3::scene &scn, std::array<glm::mat4, 2> &view_proj, std::optional<glm::mat4> &previous_view_projection)
+	{
+		auto view_projection = view_proj[0] * view_proj[1];
+		auto previous        = previous_view_projection.value_or(view_projection);
+		auto jitter          = sdl3::temporal_jitter(scn.timeline.frame_index, ctx.render_scale);
+
+		// Content moves opposite to sample, NDC y is up while pixel rows go down.
+		// Perspective w is view z, so adding to z column shifts NDC by constant amount.
+		view_proj[0][2][0] -= 2.0f * jitter[0] / static_cast<float>(scn.width);
+		view_proj[0][2][1] += 2.0f * jitter[1] / static_cast<float>(scn.height);
+
+		scn.temporal.valid                    = true;
+		scn.temporal.jitter                   = jitter;
+		scn.temporal.view_projection          = to_array(view_projection);
+		scn.temporal.previous_view_projection = to_array(previous);
+		scn.temporal.reprojection             = to_array(previous * glm::inverse(view_projection));
+
+		previous_view_projection = view_projection;
+	}
+
+	void on_textured_mesh_key(const SDL_KeyboardEvent &key, sdl3::scene &scn, textured_mesh_state &st)
+	{
+		switch (key.key)
 		{
-			if (e.type == SDL_EVENT_QUIT)
-			{
-				app::quit = true;
-			}
+		case SDLK_P:
+			toggle(scn.depth_prepass, "Depth prepass"sv);
+			break;
+		case SDLK_O:
+			scn.transparency = (scn.transparency == sdl3::transparency_mode_t::sorted)
+			                     ? sdl3::transparency_mode_t::weighted_oit
+			                     : sdl3::transparency_mode_t::sorted;
+			msg::info(std::format("Order-independent transparency: {}", scn.transparency == sdl3::transparency_mode_t::weighted_oit ? "on" : "off"));
+			break;
+		case SDLK_X:
+			toggle(st.show_debug, "Debug shapes"sv);
+			break;
+		case SDLK_M:
+			toggle(st.show_markers, "Screen markers"sv);
+			break;
+		case SDLK_L:
+			cycle_procedural(scn.procedural);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void update_textured_mesh(const sdl3::context &ctx, sdl3::scene &scn, textured_mesh_state &st)
+	{
+		if (st.tile)
+		{
+			// Every tile has to see same camera and same moment
+			st.view_proj    = get_projection(st.tile->image_width, st.tile->image_height, glm::radians(st.angle), st.cam_y);
+			st.view_proj[0] = crop_projection(st.view_proj[0], *st.tile);
+		}
+		else
+		{
+			update_camera(st.angle, st.cam_y);
+			st.view_proj        = get_projection(static_cast<uint32_t>(st.width), static_cast<uint32_t>(st.height), glm::radians(st.angle), st.cam_y);
+			scn.procedural.time = static_cast<float>(SDL_GetTicks()) / 1000.0f;
 		}
-		sdl3::draw(ctx, scn, io::as_byte_span(view_proj));
-		app::update(angle, cam_y);
 
-		view_proj = app::get_projection(width, height, glm::radians(angle), cam_y);
+		auto opaque      = sort_by_view_depth(st.cube_instances.transforms, st.view_proj[1], sdl3::render_queue_t::opaque);
+		// Order-independent transparency doesn't need sorted transparent instances
+		auto transparent = (scn.transparency == sdl3::transparency_mode_t::sorted)
+		                     ? sort_by_view_depth(st.glass_cubes.transforms, st.view_proj[1], sdl3::render_queue_t::transparent)
+		                     : st.glass_cubes.transforms;
+		sdl3::update_instances(ctx, scn, io::as_byte_span(opaque), io::as_byte_span(transparent));
+
+		if (st.show_debug)
+			add_debug_shapes(st.cube_instances.transforms, st.glass_cubes.transforms);
+		dbg::prepare(ctx, st.dbg_rndr, scn);
+
+		if (st.show_markers)
+		{
+			add_markers(st.sprite_batch, st.marker_texture, st.glass_cubes.transforms, 1, st.view_proj, st.width, st.height, glm::radians(st.angle));
+			add_markers(st.sprite_batch, st.marker_texture, st.cube_instances.transforms, 0, st.view_proj, st.width, st.height, glm::radians(st.angle));
+		}
+		sprites::prepare(ctx, st.sprite_batch, scn);
+
+		if (scn.temporal.enabled and not st.tile)
+		{
+			jitter_projection(ctx, scn, st.view_proj, st.previous_view_projection);
+		}
+		else
+		{
+			scn.temporal.valid = false;
+			st.previous_view_projection.reset();
+		}
 	}
 
-	sdl3::destroy_scene(scn);
+	auto setup_textured_mesh(const sdl3::context &ctx, bool stress) -> scenario::running
+	{
+		auto [w, h] = sdl3::render_size(ctx);
 
-	sdl3::destroy_context(ctx);
+		auto texture        = load_texture();
+		auto cube_mesh      = make_cube();
+		auto cube_positions = make_position_stream(cube_mesh);
+		auto pl_descs       = get_pipeline_desc(ctx);
 
-	return 0;
-}
\ No newline at end of file
+		auto st            = std::make_shared<textured_mesh_state>();
+		st->width          = static_cast<float>(w);
+		st->height         = static_cast<float>(h);
+		st->view_proj      = get_projection(w, h, glm::radians(st->angle), st->cam_y);
+		st->cube_instances = make_cube_instances();
+		st->glass_cubes    = make_glass_cube_instances();
+
+		auto scn = sdl3::init_scene(
+			ctx,
+			pl_descs,
+			io::as_byte_span(cube_mesh.vertices), static_cast<uint32_t>(cube_mesh.vertices.size()),
+			io::as_byte_span(cube_positions),
+			io::as_byte_span(cube_mesh.indices), static_cast<uint32_t>(cube_mesh.indices.size()),
+			io::as_byte_span(st->cube_instances.transforms), static_cast<uint32_t>(st->cube_instances.transforms.size()),
+			io::as_byte_span(st->glass_cubes.transforms), static_cast<uint32_t>(st->glass_cubes.transforms.size()),
+			texture);
+
+		scn.clear_color = { 0.4f, 0.4f, 0.4f, 1.0f };
+
+		if (stress)
+		{
+			scn.procedural = {
+				.layout  = sdl3::layout_t::grid,
+				.count   = STRESS_GRID_SIDE * STRESS_GRID_SIDE,
+				.columns = STRESS_GRID_SIDE,
+				.origin  = { 0.0f, -1.0f, 0.0f },
+				.spacing = 0.05f,
+				.scale   = 0.025f,
+			};
+		}
+
+		st->dbg_rndr       = dbg::init_renderer(ctx);
+		st->sprite_batch   = sprites::init_batch(ctx);
+		st->marker_texture = sprites::add_texture(st->sprite_batch, scn.uv_texture.get(), scn.uv_sampler.get());
+
+		auto fn = scenario::hooks{
+			.update = [st](const sdl3::context &ctx, sdl3::scene &scn, float) {
+				update_textured_mesh(ctx, scn, *st);
+			},
+			.draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+				sdl3::draw(frm, scn, io::as_byte_span(st->view_proj));
+				dbg::draw(frm, st->dbg_rndr, scn, io::as_byte_span(st->view_proj));
+			},
+			.draw_overlay = [st](sdl3::frame_context &frm, sdl3::scene &) {
+				sprites::draw(frm, st->sprite_batch);
+			},
+			.on_key = [st](const SDL_KeyboardEvent &key, sdl3::scene &scn) {
+				on_textured_mesh_key(key, scn, *st);
+			},
+			.set_camera = [st](const scenario::camera &cam) {
+				st->angle = cam.angle;
+				st->cam_y = cam.cam_y;
+			},
+			.set_tile = [st](const scenario::tile_view &tile) {
+				st->tile = tile;
+			},
+			.shutdown = [st]() {
+				sprites::destroy_batch(st->sprite_batch);
+				dbg::destroy_renderer(st->dbg_rndr);
+			},
+		};
+
+		return { std::move(scn), std::move(fn) };
+	}
+
+	// Cell bundles are baked here on first run, then streamed from disk
+	constexpr auto WORLD_DIRECTORY = "world_cells"sv;
+	constexpr auto WORLD_SEED      = 1234u;
+
+	constexpr auto FLY_AUTO_TURN = 0.1f;  // radians per second, keeps camera circling over world with no input
+	constexpr auto FLY_TURN_RATE = 1.0f;  // radians per second, added by A/D
+	constexpr auto FLY_MAX_SPEED = 80.0f; // units per second
+
+	// Camera of streaming scenarios, flies over scene
+	struct fly_camera
+	{
+		glm::vec3 position = { 0.0f, 12.0f, 0.0f };
+		float heading      = 0.0f;  // radians around y, 0 looks along +z
+		float speed        = 16.0f; // units per second
+		float seconds      = 0.0f;  // flight time, camera samples for prefetch prediction are stamped with it
+	};
+
+	// Streamed city, camera flies over it
+	struct world_streaming_state
+	{
+		fly_camera cam;
+		float width;
+		float height;
+
+		std::array<glm::mat4, 2> view_proj;
+		std::optional<glm::mat4> previous_view_projection;
+		std::unique_ptr<world::partition> cells;
+	};
+
+	// Camera always moves forward, A/D turn, W/S speed up and slow down
+	void update_fly_camera(fly_camera &cam, float dt)
+	{
+		auto *key_states = SDL_GetKeyboardState(nullptr);
+
+		auto turn = FLY_AUTO_TURN;
+		if (key_states[SDL_SCANCODE_A] or key_states[SDL_SCANCODE_LEFT])
+			turn -= FLY_TURN_RATE;
+		if (key_states[SDL_SCANCODE_D] or key_states[SDL_SCANCODE_RIGHT])
+			turn += FLY_TURN_RATE;
+
+		if (key_states[SDL_SCANCODE_W] or key_states[SDL_SCANCODE_UP])
+			cam.speed += 0.5f * FLY_MAX_SPEED * dt;
+		if (key_states[SDL_SCANCODE_S] or key_states[SDL_SCANCODE_DOWN])
+			cam.speed -= 0.5f * FLY_MAX_SPEED * dt;
+		cam.speed = std::clamp(cam.speed, 0.0f, FLY_MAX_SPEED);
+
+		cam.seconds  += dt;
+		cam.heading  += turn * dt;
+		cam.position += glm::vec3(std::sinf(cam.heading), 0.0f, std::cosf(cam.heading)) * cam.speed * dt;
+	}
+
+	auto get_fly_projection(uint32_t width, uint32_t height, const fly_camera &cam) -> std::array<glm::mat4, 2>
+	{
+		auto fov          = glm::radians(75.0f);
+		auto aspect_ratio = static_cast<float>(width) / height;
+
+		// Looks ahead and a little down, at streets in front of camera
+		auto forward = glm::vec3(std::sinf(cam.heading), -0.35f, std::cosf(cam.heading));
+
+		auto projection = glm::perspective(fov, aspect_ratio, 0.1f, 200.f);
+		auto view       = glm::lookAt(cam.position, cam.position + forward, glm::vec3(0.f, 1.f, 0.f));
+
+		return {
+			projection,
+			view,
+		};
+	}
+
+	void update_world_streaming(const sdl3::context &ctx, sdl3::scene &scn, world_streaming_state &st, float dt)
+	{
+		update_fly_camera(st.cam, dt);
+		st.view_proj = get_fly_projection(static_cast<uint32_t>(st.width), static_cast<uint32_t>(st.height), st.cam);
+
+		auto camera = world::camera_sample{
+			.position = { st.cam.position.x, st.cam.position.y, st.cam.position.z },
+			.heading  = st.cam.heading,
+			.seconds  = st.cam.seconds,
+		};
+		world::update(ctx, scn, *st.cells, camera);
+
+		if (scn.temporal.enabled)
+		{
+			jitter_projection(ctx, scn, st.view_proj, st.previous_view_projection);
+		}
+		else
+		{
+			scn.temporal.valid = false;
+			st.previous_view_projection.reset();
+		}
+	}
+
+	auto setup_world_streaming(const sdl3::context &ctx) -> scenario::running
+	{
+		auto [w, h] = sdl3::render_size(ctx);
+
+		auto texture        = load_texture();
+		auto cube_mesh      = make_cube();
+		auto cube_positions = make_position_stream(cube_mesh);
+		auto pl_descs       = get_pipeline_desc(ctx);
+
+		auto desc = world::partition_desc{
+			.directory = std::filesystem::path{ WORLD_DIRECTORY },
+		};
+		world::bake_world(desc, WORLD_SEED);
+
+		auto st       = std::make_shared<world_streaming_state>();
+		st->width     = static_cast<float>(w);
+		st->height    = static_cast<float>(h);
+		st->view_proj = get_fly_projection(w, h, st->cam);
+
+		// Cubes at origin are scene's own instances, always resident, cells stream in around them
+		auto landmarks   = make_cube_instances();
+		auto glass_cubes = make_glass_cube_instances();
+
+		auto scn = sdl3::init_scene(
+			ctx,
+			pl_descs,
+			io::as_byte_span(cube_mesh.vertices), static_cast<uint32_t>(cube_mesh.vertices.size()),
+			io::as_byte_span(cube_positions),
+			io::as_byte_span(cube_mesh.indices), static_cast<uint32_t>(cube_mesh.indices.size()),
+			io::as_byte_span(landmarks.transforms), static_cast<uint32_t>(landmarks.transforms.size()),
+			io::as_byte_span(glass_cubes.transforms), static_cast<uint32_t>(glass_cubes.transforms.size()),
+			texture);
+
+		scn.clear_color = { 0.55f, 0.65f, 0.8f, 1.0f };
+
+		st->cells = world::make_partition(ctx, desc);
+
+		auto fn = scenario::hooks{
+			.update = [st](const sdl3::context &ctx, sdl3::scene &scn, float dt) {
+				update_world_streaming(ctx, scn, *st, dt);
+			},
+			.draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+				sdl3::draw(frm, scn, io::as_byte_span(st->view_proj));
+			},
+			.shutdown = [st]() {
+				world::destroy_partition(*st->cells);
+			},
+		};
+
+		return { std::move(scn), std::move(fn) };
+	}
+
+	// Archive of unique tower meshes, baked on first run, then streamed from disk
+	constexpr auto GEOMETRY_ARCHIVE   = "geometry.geoa"sv;
+	constexpr auto QUANTIZED_ARCHIVE  = "geometry_quantized.geoa"sv; // same towers, expanded on GPU
+	constexpr auto TOWER_GRID_SIDE    = 32u;
+	constexpr auto TOWER_SPACING      = 12.0f;
+	constexpr auto TOWER_BOUND_RADIUS = 12.0f; // sphere around tower's base, covers tallest tower
+	constexpr auto LOD_DISTANCES      = std::array{ 30.0f, 80.0f }; // towers further than last use pinned level
+
+	// Field of towers, each a unique mesh, far more geometry than residency budget holds
+	struct geometry_streaming_state
+	{
+		fly_camera cam;
+		float width;
+		float height;
+
+		std::array<glm::mat4, 2> view_proj;
+		std::optional<glm::mat4> previous_view_projection;
+		std::vector<glm::mat4> towers; // one instance per mesh, mesh i is instance i
+		sdl3::gpu_buffer_ptr tower_instances;
+		std::unique_ptr<geo::residency> geometry;
+	};
+
+	// Bounding sphere against view frustum's planes, clip space z is 0 to 1
+	auto sphere_visible(const glm::mat4 &view_projection, const glm::vec3 &centre, float radius) -> bool
+	{
+		auto row = [&](int i) {
+			return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+		};
+		auto planes = std::array{ row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2) };
+
+		return std::ranges::all_of(planes, [&](const glm::vec4 &plane) {
+			return glm::dot(glm::vec3(plane), centre) + plane.w >= -radius * glm::length(glm::vec3(plane));
+		});
+	}
+
+	void update_geometry_streaming(const sdl3::context &ctx, sdl3::scene &scn, geometry_streaming_state &st, float dt)
+	{
+		update_fly_camera(st.cam, dt);
+		st.view_proj = get_fly_projection(static_cast<uint32_t>(st.width), static_cast<uint32_t>(st.height), st.cam);
+
+		// Level by distance, residency hands back a stand in while wanted level streams in
+		auto view_projection = st.view_proj[0] * st.view_proj[1];
+		scn.pooled_draws.clear();
+		for (auto &&[i, transform] : st.towers | std::views::enumerate)
+		{
+			auto centre = glm::vec3(transform[3]);
+			if (not sphere_visible(view_projection, centre, TOWER_BOUND_RADIUS))
+				continue;
+
+			auto mesh     = static_cast<uint32_t>(i);
+			auto distance = glm::distance(centre, st.cam.position);
+			auto wanted   = static_cast<uint32_t>(std::ranges::count_if(LOD_DISTANCES, [&](float d) { return distance > d; }));
+			auto lod      = geo::use(*st.geometry, mesh, wanted, scn.timeline.frame_index);
+
+			auto draw      = geo::draw_of(*st.geometry, mesh, lod);
+			draw.instances = { .first = mesh, .count = 1 };
+			scn.pooled_draws.push_back(draw);
+		}
+		geo::update(ctx, scn, *st.geometry);
+
+		if (scn.temporal.enabled)
+		{
+			jitter_projection(ctx, scn, st.view_proj, st.previous_view_projection);
+		}
+		else
+		{
+			scn.temporal.valid = false;
+			st.previous_view_projection.reset();
+		}
+	}
+
+	auto setup_geometry_streaming(const sdl3::context &ctx, geo::encoding_t encoding) -> scenario::running
+	{
+		auto [w, h] = sdl3::render_size(ctx);
+		auto gpu    = ctx.gpu.get();
+
+		auto texture        = load_texture();
+		auto cube_mesh      = make_cube();
+		auto cube_positions = make_position_stream(cube_mesh);
+		auto pl_descs       = get_pipeline_desc(ctx);
+
+		auto archive = std::filesystem::path{ encoding == geo::encoding_t::quantized ? QUANTIZED_ARCHIVE : GEOMETRY_ARCHIVE };
+		geo::bake_archive(archive, TOWER_GRID_SIDE * TOWER_GRID_SIDE, WORLD_SEED, encoding);
+
+		auto st       = std::make_shared<geometry_streaming_state>();
+		st->width     = static_cast<float>(w);
+		st->height    = static_cast<float>(h);
+		st->view_proj = get_fly_projection(w, h, st->cam);
+
+		auto half  = 0.5f * TOWER_SPACING * (TOWER_GRID_SIDE - 1);
+		st->towers = std::views::cartesian_product(std::views::iota(0u, TOWER_GRID_SIDE), std::views::iota(0u, TOWER_GRID_SIDE))
+		           | std::views::transform([&](auto row_column) {
+				         auto [row, column] = row_column;
+				         return glm::translate(glm::mat4(1.0f), glm::vec3{ column * TOWER_SPACING - half, 0.f, row * TOWER_SPACING - half });
+			         })
+		           | std::ranges::to<std::vector>();
+
+		// Cubes at origin are scene's own instances, towers are drawn from geometry pool
+		auto landmarks   = make_cube_instances();
+		auto glass_cubes = make_glass_cube_instances();
+
+		auto scn = sdl3::init_scene(
+			ctx,
+			pl_descs,
+			io::as_byte_span(cube_mesh.vertices), static_cast<uint32_t>(cube_mesh.vertices.size()),
+			io::as_byte_span(cube_positions),
+			io::as_byte_span(cube_mesh.indices), static_cast<uint32_t>(cube_mesh.indices.size()),
+			io::as_byte_span(landmarks.transforms), static_cast<uint32_t>(landmarks.transforms.size()),
+			io::as_byte_span(glass_cubes.transforms), static_cast<uint32_t>(glass_cubes.transforms.size()),
+			texture);
+
+		scn.clear_color = { 0.55f, 0.65f, 0.8f, 1.0f };
+
+		auto towers_bytes   = io::as_byte_span(st->towers);
+		st->tower_instances = sdl3::make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(towers_bytes.size()), "Tower Instance Buffer"sv);
+		sdl3::stage_upload(gpu, scn.uploads, towers_bytes, st->tower_instances.get(), 0, false);
+
+		st->geometry = geo::make_residency(ctx, scn, { .archive = archive });
+
+		scn.pooled_vertex_buffer   = st->geometry->vertices.buffer.get();
+		scn.pooled_index_buffer    = st->geometry->indices.buffer.get();
+		scn.pooled_instance_buffer = st->tower_instances.get();
+
+		auto fn = scenario::hooks{
+			.update = [st](const sdl3::context &ctx, sdl3::scene &scn, float dt) {
+				update_geometry_streaming(ctx, scn, *st, dt);
+			},
+			.draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+				geo::expand(frm, *st->geometry);
+				sdl3::draw(frm, scn, io::as_byte_span(st->view_proj));
+			},
+			.shutdown = [st]() {
+				geo::destroy_residency(*st->geometry);
+			},
+		};
+
+		return { std::move(scn), std::move(fn) };
+	}
+
+	// Scene file of a million cubes, baked on first run, then mapped on every start
+	constexpr auto MAPPED_SCENE_FILE = "instances.scene"sv;
+	constexpr auto MAPPED_GRID_SIDE  = 1000u;
+	constexpr auto MAPPED_SPACING    = 2.0f;
+
+	// Scene file arrays are read as app types, without conversion
+	static_assert(sizeof(vertex) == sizeof(sfile::vertex));
+	static_assert(sizeof(glm::mat4) == sizeof(sfile::transform));
+
+	void bake_mapped_scene(const std::filesystem::path &filename)
+	{
+		auto cube_mesh = make_cube();
+
+		auto half      = 0.5f * MAPPED_SPACING * (MAPPED_GRID_SIDE - 1);
+		auto instances = std::views::cartesian_product(std::views::iota(0u, MAPPED_GRID_SIDE), std::views::iota(0u, MAPPED_GRID_SIDE))
+		               | std::views::transform([&](auto row_column) {
+				             auto [row, column] = row_column;
+				             return glm::translate(glm::mat4(1.0f), glm::vec3{ column * MAPPED_SPACING - half, -2.f, row * MAPPED_SPACING - half });
+			             })
+		               | std::ranges::to<std::vector>();
+
+		auto glass_cubes = make_glass_cube_instances();
+		auto opaque      = static_cast<uint32_t>(instances.size());
+		instances.insert(instances.end(), glass_cubes.transforms.begin(), glass_cubes.transforms.end());
+
+		auto materials = std::array{
+			sfile::material{ .texture = 0, .blend = sfile::blend_t::opaque, .first_instance = 0, .instance_count = opaque },
+			sfile::material{ .texture = 0, .blend = sfile::blend_t::transparent, .first_instance = opaque, .instance_count = static_cast<uint32_t>(glass_cubes.transforms.size()) },
+		};
+		auto textures = std::array{ "data/uv_grid.dds"s };
+
+		auto src = sfile::scene_source{
+			.vertices  = { reinterpret_cast<const sfile::vertex *>(cube_mesh.vertices.data()), cube_mesh.vertices.size() },
+			.indices   = cube_mesh.indices,
+			.instances = { reinterpret_cast<const sfile::transform *>(instances.data()), instances.size() },
+			.materials = materials,
+			.textures  = textures,
+		};
+		msg::error(sfile::write_scene(filename, src), "Failed to write scene file.");
+	}
+
+	struct mapped_scene_state
+	{
+		fly_camera cam;
+		float width;
+		float height;
+
+		std::array<glm::mat4, 2> view_proj;
+		std::optional<glm::mat4> previous_view_projection;
+	};
+
+	void update_mapped_scene(const sdl3::context &ctx, sdl3::scene &scn, mapped_scene_state &st, float dt)
+	{
+		update_fly_camera(st.cam, dt);
+		st.view_proj = get_fly_projection(static_cast<uint32_t>(st.width), static_cast<uint32_t>(st.height), st.cam);
+
+		if (scn.temporal.enabled)
+		{
+			jitter_projection(ctx, scn, st.view_proj, st.previous_view_projection);
+		}
+		else
+		{
+			scn.temporal.valid = false;
+			st.previous_view_projection.reset();
+		}
+	}
+
+	auto setup_mapped_scene(const sdl3::context &ctx) -> scenario::running
+	{
+		auto [w, h] = sdl3::render_size(ctx);
+		auto filename = std::filesystem::path{ MAPPED_SCENE_FILE };
+
+		// Missing or older file is baked again
+		auto start_ns = SDL_GetTicksNS();
+		auto view     = sfile::open_scene(filename);
+		if (not view)
+		{
+			bake_mapped_scene(filename);
+			start_ns = SDL_GetTicksNS();
+			view     = sfile::open_scene(filename);
+		}
+		msg::error(view.has_value(), "Failed to open scene file.");
+
+		auto open_ms = static_cast<double>(SDL_GetTicksNS() - start_ns) / 1'000'000.0;
+		msg::info(std::format("Scene file: {} instances mapped in {:.2f} ms.", view->instances.size(), open_ms));
+
+		auto opaque      = sfile::instances_of(*view, sfile::blend_t::opaque);
+		auto transparent = sfile::instances_of(*view, sfile::blend_t::transparent);
+		auto texture     = io::read_image_file(sfile::texture_path(*view, view->materials.front().texture));
+		auto pl_descs    = get_pipeline_desc(ctx);
+
+		auto st       = std::make_shared<mapped_scene_state>();
+		st->width     = static_cast<float>(w);
+		st->height    = static_cast<float>(h);
+		st->view_proj = get_fly_projection(w, h, st->cam);
+
+		// Uploads copy straight from mapped pages, view is unmapped once setup returns
+		auto scn = sdl3::init_scene(
+			ctx,
+			pl_descs,
+			io::as_byte_span(view->vertices), static_cast<uint32_t>(view->vertices.size()),
+			io::as_byte_span(view->positions),
+			io::as_byte_span(view->indices), static_cast<uint32_t>(view->indices.size()),
+			io::as_byte_span(opaque), static_cast<uint32_t>(opaque.size()),
+			io::as_byte_span(transparent), static_cast<uint32_t>(transparent.size()),
+			texture);
+
+		scn.clear_color = { 0.55f, 0.65f, 0.8f, 1.0f };
+
+		auto fn = scenario::hooks{
+			.update = [st](const sdl3::context &ctx, sdl3::scene &scn, float dt) {
+				update_mapped_scene(ctx, scn, *st, dt);
+			},
+			.draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+				sdl3::draw(frm, scn, io::as_byte_span(st->view_proj));
+			},
+		};
+
+		return { std::move(scn), std::move(fn) };
+	}
+
+	// Imported geometry is uploaded over several frames, leaving rest of upload ring to frame's own uploads
+	constexpr auto GLTF_UPLOAD_BYTES_PER_FRAME = uint32_t{ 16 * 1024 * 1024 };
+
+	struct gltf_viewer_state
+	{
+		struct pending_upload
+		{
+			SDL_GPUBuffer *buffer;
+			io::byte_span data;
+			uint32_t offset;
+		};
+
+		float width;
+		float height;
+		float angle = 0.0f;
+		glm::vec3 centre;
+		float radius;
+
+		std::array<glm::mat4, 2> view_proj;
+		std::optional<glm::mat4> previous_view_projection;
+
+		// CPU copies are kept until their uploads are staged
+		std::vector<sfile::vertex> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<glm::mat4> instances;
+		std::deque<pending_upload> uploads;
+
+		std::vector<sdl3::pooled_draw> draws;
+		sdl3::gpu_buffer_ptr vertex_buffer;
+		sdl3::gpu_buffer_ptr index_buffer;
+		sdl3::gpu_buffer_ptr instance_buffer;
+	};
+
+	// Orbit around model's bounds, at a distance that fits it in view
+	auto get_orbit_projection(uint32_t width, uint32_t height, const glm::vec3 &centre, float radius, float angle) -> std::array<glm::mat4, 2>
+	{
+		auto fov          = glm::radians(60.0f);
+		auto aspect_ratio = static_cast<float>(width) / height;
+		auto distance     = 2.0f * radius;
+
+		auto eye        = centre + distance * glm::vec3{ std::cosf(angle), 0.4f, std::sinf(angle) };
+		auto projection = glm::perspective(fov, aspect_ratio, 0.01f * distance, 4.0f * distance);
+		auto view       = glm::lookAt(eye, centre, glm::vec3(0.f, 1.f, 0.f));
+
+		return { projection, view };
+	}
+
+	// Meshes are packed in to one vertex and one index buffer, instances of a mesh are contiguous,
+	// so each primitive is one instanced draw
+	void pack_gltf_asset(const gltf::asset &model, gltf_viewer_state &st)
+	{
+		auto per_mesh = std::vector<std::vector<glm::mat4>>(model.meshes.size());
+		for (auto &&inst : model.instances)
+			per_mesh[inst.mesh].push_back(glm::make_mat4(inst.transform.data()));
+
+		for (auto &&[msh, transforms] : std::views::zip(model.meshes, per_mesh))
+		{
+			if (transforms.empty())
+				continue;
+
+			auto instances = sdl3::instance_range{ static_cast<uint32_t>(st.instances.size()), static_cast<uint32_t>(transforms.size()) };
+			st.instances.insert(st.instances.end(), transforms.begin(), transforms.end());
+
+			for (auto &&prim : msh.primitives)
+			{
+				st.draws.push_back({
+				  .index_count   = static_cast<uint32_t>(prim.indices.size()),
+				  .first_index   = static_cast<uint32_t>(st.indices.size()),
+				  .vertex_offset = static_cast<int32_t>(st.vertices.size()),
+				  .instances     = instances,
+				});
+				st.vertices.insert(st.vertices.end(), prim.vertices.begin(), prim.vertices.end());
+				st.indices.insert(st.indices.end(), prim.indices.begin(), prim.indices.end());
+			}
+		}
+
+		auto bounds = std::optional<sfile::aabb>{};
+		for (auto &&inst : model.instances)
+		{
+			for (auto &&prim : model.meshes[inst.mesh].primitives)
+			{
+				auto box = sfile::transform_bounds(prim.bounds, inst.transform);
+				bounds   = bounds ? sfile::merge(*bounds, box) : box;
+			}
+		}
+		msg::error(bounds.has_value(), "Model has nothing to draw.");
+
+		auto min  = glm::make_vec3(bounds->min.data());
+		auto max  = glm::make_vec3(bounds->max.data());
+		st.centre = 0.5f * (min + max);
+		st.radius = std::max(0.5f * glm::length(max - min), 0.01f);
+	}
+
+	void update_gltf_viewer(const sdl3::context &ctx, sdl3::scene &scn, gltf_viewer_state &st, float dt)
+	{
+		st.angle += dt * glm::radians(20.0f);
+		st.view_proj = get_orbit_projection(static_cast<uint32_t>(st.width), static_cast<uint32_t>(st.height), st.centre, st.radius, st.angle);
+
+		auto budget = GLTF_UPLOAD_BYTES_PER_FRAME;
+		while (not st.uploads.empty() and budget > 0)
+		{
+			auto &upload = st.uploads.front();
+			auto size    = std::min<uint32_t>(budget, static_cast<uint32_t>(upload.data.size()));
+			if (not sdl3::stage_upload(ctx.gpu.get(), scn.uploads, upload.data.first(size), upload.buffer, upload.offset, false))
+				break;
+
+			budget -= size;
+			upload.data = upload.data.subspan(size);
+			upload.offset += size;
+			if (upload.data.empty())
+				st.uploads.pop_front();
+		}
+
+		// Drawn once every piece is staged, copies are recorded before this frame's draws
+		if (st.uploads.empty() and scn.pooled_draws.empty())
+		{
+			scn.pooled_draws = std::move(st.draws);
+			st.vertices      = {};
+			st.indices       = {};
+			st.instances     = {};
+		}
+
+		if (scn.temporal.enabled)
+		{
+			jitter_projection(ctx, scn, st.view_proj, st.previous_view_projection);
+		}
+		else
+		{
+			scn.temporal.valid = false;
+			st.previous_view_projection.reset();
+		}
+	}
+
+	auto setup_gltf_viewer(const sdl3::context &ctx) -> scenario::running
+	{
+		auto [w, h] = sdl3::render_size(ctx);
+		auto gpu    = ctx.gpu.get();
+
+		auto model = gltf::import_file(gltf_file);
+		msg::error(model.has_value(), "Failed to import glTF file.");
+
+		auto texture        = load_texture();
+		auto cube_mesh      = make_cube();
+		auto cube_positions = make_position_stream(cube_mesh);
+		auto pl_descs       = get_pipeline_desc(ctx);
+
+		auto st    = std::make_shared<gltf_viewer_state>();
+		st->width  = static_cast<float>(w);
+		st->height = static_cast<float>(h);
+		pack_gltf_asset(*model, *st);
+		st->view_proj = get_orbit_projection(w, h, st->centre, st->radius, st->angle);
+		model.reset();
+
+		// Scene's own cube is a flat plinth under model, there are no transparent instances
+		auto thickness = 0.05f * st->radius;
+		auto plinth    = std::array{
+			glm::translate(glm::mat4(1.0f), glm::vec3{ st->centre.x, st->centre.y - st->radius - 0.5f * thickness, st->centre.z })
+			  * glm::scale(glm::mat4(1.0f), glm::vec3{ 2.0f * st->radius, thickness, 2.0f * st->radius }),
+		};
+
+		auto scn = sdl3::init_scene(
+			ctx,
+			pl_descs,
+			io::as_byte_span(cube_mesh.vertices), static_cast<uint32_t>(cube_mesh.vertices.size()),
+			io::as_byte_span(cube_positions),
+			io::as_byte_span(cube_mesh.indices), static_cast<uint32_t>(cube_mesh.indices.size()),
+			io::as_byte_span(plinth), static_cast<uint32_t>(plinth.size()),
+			io::as_byte_span(plinth), 0,
+			texture);
+
+		scn.clear_color = { 0.4f, 0.4f, 0.4f, 1.0f };
+
+		auto vertex_bytes   = io::as_byte_span(st->vertices);
+		auto index_bytes    = io::as_byte_span(st->indices);
+		auto instance_bytes = io::as_byte_span(st->instances);
+
+		st->vertex_buffer   = sdl3::make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(vertex_bytes.size()), "glTF Vertex Buffer"sv);
+		st->index_buffer    = sdl3::make_buffer(gpu, SDL_GPU_BUFFERUSAGE_INDEX, static_cast<uint32_t>(index_bytes.size()), "glTF Index Buffer"sv);
+		st->instance_buffer = sdl3::make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(instance_bytes.size()), "glTF Instance Buffer"sv);
+		st->uploads         = {
+			{ st->vertex_buffer.get(), vertex_bytes, 0 },
+			{ st->index_buffer.get(), index_bytes, 0 },
+			{ st->instance_buffer.get(), instance_bytes, 0 },
+		};
+
+		scn.pooled_vertex_buffer   = st->vertex_buffer.get();
+		scn.pooled_index_buffer    = st->index_buffer.get();
+		scn.pooled_instance_buffer = st->instance_buffer.get();
+
+		auto fn = scenario::hooks{
+			.update = [st](const sdl3::context &ctx, sdl3::scene &scn, float dt) {
+				update_gltf_viewer(ctx, scn, *st, dt);
+			},
+			.draw = [st](sdl3::frame_context &frm, sdl3::scene &scn) {
+				sdl3::draw(frm, scn, io::as_byte_span(st->view_proj));
+			},
+		};
+
+		return { std::move(scn), std::move(fn) };
+	}
+
+	auto make_registry() -> scenario::registry
+	{
+		auto reg = scenario::registry{};
+		basic::add_scenarios(reg);
+
+		reg.push_back({
+		  .name        = "textured_mesh"sv,
+		  .description = "Instanced cubes with transparency, debug shapes and screen markers."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_textured_mesh(ctx, false); },
+		});
+		reg.push_back({
+		  .name        = "textured_mesh_stress"sv,
+		  .description = "Textured mesh scene plus 1M procedural grid instances."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_textured_mesh(ctx, true); },
+		});
+		reg.push_back({
+		  .name        = "world_streaming"sv,
+		  .description = "City of cells streamed from disk around a flying camera."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_world_streaming(ctx); },
+		});
+		reg.push_back({
+		  .name        = "geometry_streaming"sv,
+		  .description = "Field of unique tower meshes, levels of detail streamed under a memory budget."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_geometry_streaming(ctx, geo::encoding_t::codec); },
+		});
+		reg.push_back({
+		  .name        = "geometry_streaming_gpu"sv,
+		  .description = "Geometry streaming with quantized levels uploaded as stored and expanded by a compute pass."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_geometry_streaming(ctx, geo::encoding_t::quantized); },
+		});
+		reg.push_back({
+		  .name        = "mapped_scene"sv,
+		  .description = "Million cube scene file, memory mapped and uploaded without parsing."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_mapped_scene(ctx); },
+		});
+		reg.push_back({
+		  .name        = "gltf_viewer"sv,
+		  .description = "glTF 2.0 model given with --import, orbited on a plinth."sv,
+		  .setup       = [](const sdl3::context &ctx) { return setup_gltf_viewer(ctx); },
+		});
+
+		return reg;
+	}
+
+	// Keys every scenario shares, anything else goes to running scenario
+	void on_key_down(const SDL_KeyboardEvent &key, scenario::running &run, postfx::chain &fx, hud::overlay &ovl)
+	{
+		if (key.repeat)
+			return;
+
+		switch (key.key)
+		{
+		case SDLK_ESCAPE:
+			quit = true;
+			break;
+		case SDLK_B:
+			toggle(fx.config.bloom, "Bloom"sv);
+			break;
+		case SDLK_T:
+			toggle(fx.config.tonemap, "Tone mapping"sv);
+			break;
+		case SDLK_G:
+			toggle(fx.config.color_grading, "Color grading"sv);
+			break;
+		case SDLK_H:
+			toggle(ovl.visible, "Performance overlay"sv);
+			break;
+		case SDLK_N:
+			fx.config.antialiasing = postfx::next(fx.config.antialiasing);
+			msg::info(std::format("Anti-aliasing: {}", postfx::to_string(fx.config.antialiasing)));
+			break;
+		case SDLK_F12:
+			capture = true;
+			break;
+		default:
+			if (run.fn.on_key)
+				run.fn.on_key(key, run.scn);
+			break;
+		}
+	}
+
+	// Sample count for anti-aliasing mode, lowered to what device supports
+	auto select_msaa(const sdl3::context &ctx, postfx::antialiasing_t mode) -> SDL_GPUSampleCount
+	{
+		auto requested = postfx::sample_count(mode);
+		auto supported = sdl3::supported_msaa(ctx.gpu.get(), requested);
+		if (supported != requested)
+		{
+			msg::info(std::format("{}x MSAA isn't supported, using {}x.", 1u << requested, 1u << supported));
+		}
+		return supported;
+	}
+
+	// Scene targets and pipelines are made for one sample count, so changing it sets scenario up again.
+	// Scenario's own state, like camera, starts over.
+	void restart_scenario(sdl3::context &ctx, scenario::running &run, const scenario::entry &selected, SDL_GPUSampleCount msaa)
+	{
+		msg::info(std::format("Restarting scenario {} with {}x MSAA.", selected.name, 1u << msaa));
+
+		if (run.fn.shutdown)
+			run.fn.shutdown();
+		run.fn = {};
+
+		sdl3::destroy_scene(run.scn);
+
+		ctx.msaa = msaa;
+		run      = selected.setup(ctx);
+	}
+
+	// Scenario resources go before scene they were made for
+	void destroy_headless(sdl3::context &ctx, scenario::running &run, postfx::chain &fx)
+	{
+		if (run.fn.shutdown)
+			run.fn.shutdown();
+		run.fn = {};
+
+		postfx::destroy_chain(fx);
+
+		sdl3::destroy_scene(run.scn);
+
+		sdl3::destroy_context(ctx);
+	}
+
+	// Headless, renders orbit views of selected scenario in to image files
+	auto run_batch(const scenario::options &opts, const scenario::entry &selected, postfx::antialiasing_t aa, uint32_t width, uint32_t height) -> int
+	{
+		auto format = encode::parse_format(opts.image_format);
+		if (not format)
+		{
+			std::println("Unknown image format: {}, expected png or qoi", opts.image_format);
+			return 1;
+		}
+
+		auto directory = std::filesystem::path{ opts.output };
+		std::filesystem::create_directories(directory);
+
+		auto ctx = sdl3::init_headless_context(width, height);
+		ctx.msaa           = select_msaa(ctx, aa);
+		ctx.render_scale   = opts.render_scale;
+		ctx.half_precision = not opts.full_precision;
+
+		msg::info(std::format("Scenario: {}", selected.name));
+		auto run = selected.setup(ctx);
+
+		auto fx                = postfx::init_chain(ctx);
+		fx.config.antialiasing = aa;
+
+		auto jobs   = batch::orbit_jobs(opts.batch, directory, *format);
+		auto result = batch::render_jobs(ctx, run, fx, jobs, *format);
+
+		destroy_headless(ctx, run, fx);
+
+		return (result.failed == 0) ? 0 : 1;
+	}
+
+	// Headless, renders one image larger than a render target, tile by tile
+	auto run_export(const scenario::options &opts, const scenario::entry &selected, postfx::antialiasing_t aa) -> int
+	{
+		if (opts.export_height == 0 or opts.tile_size == 0)
+		{
+			std::println("Export needs --export <width>x<height>, and a non-zero --tile size");
+			return 1;
+		}
+
+		auto directory = std::filesystem::path{ opts.output };
+		std::filesystem::create_directories(directory);
+
+		auto desc = tiled::export_desc{
+			.width     = opts.export_width,
+			.height    = opts.export_height,
+			.tile_size = opts.tile_size,
+			.output    = directory / std::format("{}_{}x{}.pam", selected.name, opts.export_width, opts.export_height),
+		};
+
+		auto ctx = sdl3::init_headless_context(desc.tile_size, desc.tile_size);
+		ctx.msaa           = select_msaa(ctx, aa);
+		ctx.render_scale   = opts.render_scale;
+		ctx.half_precision = not opts.full_precision;
+
+		msg::info(std::format("Scenario: {}", selected.name));
+		auto run = selected.setup(ctx);
+
+		auto fx                = postfx::init_chain(ctx);
+		fx.config.antialiasing = aa;
+
+		auto ok = tiled::render(ctx, run, fx, desc);
+
+		destroy_headless(ctx, run, fx);
+
+		return ok ? 0 : 1;
+	}
+
+	// Headless, keeps selected scenario warm and renders views requested over local socket
+	auto run_service(const scenario::options &opts, const scenario::entry &selected, postfx::antialiasing_t aa, uint32_t width, uint32_t height) -> int
+	{
+		auto ctx = sdl3::init_headless_context(width, height);
+		ctx.msaa           = select_msaa(ctx, aa);
+		ctx.render_scale   = opts.render_scale;
+		ctx.half_precision = not opts.full_precision;
+
+		msg::info(std::format("Scenario: {}", selected.name));
+		auto run = selected.setup(ctx);
+
+		auto fx                = postfx::init_chain(ctx);
+		fx.config.antialiasing = aa;
+
+		auto ok = service::serve(ctx, run, fx, std::filesystem::path{ opts.serve });
+
+		destroy_headless(ctx, run, fx);
+
+		return ok ? 0 : 1;
+	}
+}
+
+auto main(int argc, char *argv[]) -> int
+{
+	constexpr auto app_title = "SDL3 GPU minimal example."sv;
+	constexpr auto width     = 1920;
+	constexpr auto height    = 1080;
+
+	// Below this temporal upscaler has too few samples per output pixel to converge before camera moves
+	constexpr auto MIN_RENDER_SCALE = 0.25f;
+
+	auto opts = scenario::parse_args(std::span<char *const>{ argv, static_cast<size_t>(argc) });
+	auto reg  = app::make_registry();
+
+	if (opts.list or not opts.valid)
+	{
+		std::println("Usage: sdl3gpu-min-app [--scenario <name>] [--frames <count>] [--list]\n"
+		             "                      [--batch <count>] [--output <directory>] [--format <png|qoi>]\n"
+		             "                      [--export <width>x<height>] [--tile <size>]\n"
+		             "                      [--serve <socket path>] [--aa <none|msaa2|msaa4|msaa8|fxaa|smaa|taa>]\n"
+		             "                      [--scale <0.25-1>] [--fp32] [--import <file.gltf|glb>]");
+		scenario::print_list(reg);
+		return opts.valid ? 0 : 1;
+	}
+
+	auto selected = scenario::find(reg, opts.scenario);
+	if (selected == nullptr)
+	{
+		std::println("Unknown scenario: {}", opts.scenario);
+		scenario::print_list(reg);
+		return 1;
+	}
+
+	auto aa = postfx::parse_antialiasing(opts.antialiasing);
+	if (not aa)
+	{
+		std::println("Unknown anti-aliasing: {}, expected none, msaa2, msaa4, msaa8, fxaa, smaa or taa", opts.antialiasing);
+		return 1;
+	}
+
+	if (opts.render_scale < MIN_RENDER_SCALE or opts.render_scale > 1.0f)
+	{
+		std::println("Invalid render scale: {}, expected {} to 1", opts.render_scale, MIN_RENDER_SCALE);
+		return 1;
+	}
+
+	if (not opts.import_file.empty())
+		app::gltf_file = opts.import_file;
+
+	if (opts.batch > 0)
+		return app::run_batch(opts, *selected, *aa, width, height);
+
+	if (opts.export_width > 0)
+		return app::run_export(opts, *selected, *aa);
+
+	if (not opts.serve.empty())
+		return app::run_service(opts, *selected, *aa, width, height);
+
+	auto ctx           = sdl3::init_context(width, height, app_title);
+	ctx.msaa           = app::select_msaa(ctx, *aa);
+	ctx.render_scale   = opts.render_scale;
+	ctx.half_precision = not opts.full_precision;
+
+	msg::info(std::format("Scenario: {}", selected->name));
+	auto run = selected->setup(ctx);
+
+	auto fx                = postfx::init_chain(ctx);
+	fx.config.antialiasing = *aa;
+	auto requested_msaa    = postfx::sample_count(*aa);
+
+	auto hud_ovl = hud::init_overlay(ctx);
+
+	auto screenshot = std::future<sdl3::readback>{};
+
+	auto frame_ms = std::vector<float>{};
+	frame_ms.reserve(opts.frames);
+
+	auto last_tick = SDL_GetTicksNS();
+	auto dt        = 0.0f;
+
+	auto e = SDL_Event{};
+	while (not app::quit)
+	{
+		while (SDL_PollEvent(&e))
+		{
+			if (e.type == SDL_EVENT_QUIT)
+			{
+				app::quit = true;
+			}
+			else if (e.type == SDL_EVENT_KEY_DOWN)
+			{
+				app::on_key_down(e.key, run, fx, hud_ovl);
+			}
+		}
+
+		// MSAA level changed by N key, only checked against device when request changes
+		if (postfx::sample_count(fx.config.antialiasing) != requested_msaa)
+		{
+			requested_msaa = postfx::sample_count(fx.config.antialiasing);
+
+			auto msaa = app::select_msaa(ctx, fx.config.antialiasing);
+			if (msaa != ctx.msaa)
+			{
+				app::restart_scenario(ctx, run, *selected, msaa);
+			}
+		}
+
+		// Scenario jitters it's projection while TAA is selected
+		run.scn.temporal.enabled = (fx.config.antialiasing == postfx::antialiasing_t::taa);
+
+		if (run.fn.update)
+			run.fn.update(ctx, run.scn, dt);
+		hud::prepare(ctx, hud_ovl, run.scn);
+
+		if (app::capture and not screenshot.valid())
+		{
+			auto region = SDL_GPUTextureRegion{
+				.texture = run.scn.color_texture.get(),
+				.w       = run.scn.width,
+				.h       = run.scn.height,
+				.d       = 1,
+			};
+			screenshot   = sdl3::readback_texture(ctx.gpu.get(), run.scn.downloads, region, sdl3::SCENE_COLOR_FORMAT);
+			app::capture = false;
+		}
+		if (screenshot.valid() and screenshot.wait_for(0s) == std::future_status::ready)
+		{
+			auto image = screenshot.get();
+			msg::info(std::format("Captured frame {}, {}x{}, {} bytes.", image.frame_index, image.width, image.height, image.data.size()));
+		}
+
+		auto frm = sdl3::begin_frame(ctx, run.scn);
+		run.fn.draw(frm, run.scn);
+		postfx::apply(frm, fx, run.scn);
+		if (run.fn.draw_overlay)
+			run.fn.draw_overlay(frm, run.scn);
+		hud::draw(frm, hud_ovl);
+		sdl3::end_frame(frm, run.scn);
+
+		auto tick = SDL_GetTicksNS();
+		auto ms   = static_cast<float>(tick - last_tick) / 1'000'000.0f;
+		last_tick = tick;
+		dt        = ms / 1000.0f;
+		hud::record_frame(hud_ovl, ms, run.scn);
+
+		if (opts.frames > 0)
+		{
+			frame_ms.push_back(ms);
+			if (frame_ms.size() >= opts.frames)
+				app::quit = true;
+		}
+	}
+
+	if (opts.frames > 0)
+		scenario::print_summary(selected->name, frame_ms);
+
+	// Scenario resources go before scene they were made for
+	if (run.fn.shutdown)
+		run.fn.shutdown();
+	run.fn = {};
+
+	hud::destroy_overlay(hud_ovl);
+
+	postfx::destroy_chain(fx);
+
+	sdl3::destroy_scene(run.scn);
+
+	sdl3::destroy_context(ctx);
+
+	return 0;
+}
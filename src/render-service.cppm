@@ -0,0 +1,581 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+// Sockets and shared memory, AF_UNIX is available on Windows 10 and later through afunix.h
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <afunix.h>
+#define SERVICE_WINSOCK 1
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define SERVICE_WINSOCK 0
+#endif
+
+export module render_service;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import sdl3_postfx;
+import scenario;
+import image_encode;
+import batch;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Long running render service on a local socket.
+ * Context, pipelines and scenario's assets are made once, and stay warm across requests from any number of clients.
+ * Clients are served round robin, one job each per turn, so a client with a deep queue can't starve others.
+ *
+ * Protocol is little-endian, every message is a fixed header followed by payload.
+ *   request: request_header, then render_request for request_kind::render
+ *   reply:   reply_header, then image bytes, or name of shared memory object holding them
+ */
+export namespace service
+{
+	constexpr auto MAGIC = uint32_t{ 0x3152'4753 }; // "SGR1"
+
+	// Jobs rendered together before socket is polled again
+	constexpr auto MAX_JOBS_PER_ROUND = 8u;
+	// Jobs a single client can have waiting, more are refused
+	constexpr auto MAX_QUEUED_PER_CLIENT = 64u;
+	// Largest request payload accepted
+	constexpr auto MAX_REQUEST_PAYLOAD = uint32_t{ 256 };
+	// Wait for socket activity when there is nothing to render
+	constexpr auto IDLE_POLL_MS = 100;
+	// Time given to clients to read their last replies at shutdown, clients that stop reading don't hold it up
+	constexpr auto SHUTDOWN_DRAIN_TIMEOUT = std::chrono::seconds{ 5 };
+
+	enum class request_kind : uint32_t
+	{
+		render   = 1,
+		shutdown = 2, // stop service, after jobs already queued are finished
+	};
+
+	enum class image_encoding : uint8_t
+	{
+		raw = 0, // RGBA8, tightly packed rows
+		png = 1,
+		qoi = 2,
+	};
+
+	enum class reply_mode : uint8_t
+	{
+		inline_bytes  = 0,
+		shared_memory = 1, // client maps named object, and unlinks it when done
+	};
+
+	enum class status_t : uint32_t
+	{
+		ok          = 0,
+		bad_request = 1,
+		unsupported = 2,
+		busy        = 3, // client's queue is full
+		failed      = 4,
+	};
+
+	struct request_header
+	{
+		uint32_t magic;
+		uint32_t id; // echoed back in reply
+		request_kind kind;
+		uint32_t size; // payload bytes after header
+	};
+	static_assert(sizeof(request_header) == 16);
+
+	struct render_request
+	{
+		scenario::camera cam;
+		image_encoding encoding;
+		reply_mode reply;
+		uint16_t reserved;
+	};
+	static_assert(sizeof(render_request) == 12);
+
+	struct reply_header
+	{
+		uint32_t magic;
+		uint32_t id;
+		status_t status;
+		uint32_t width;
+		uint32_t height;
+		image_encoding encoding;
+		reply_mode reply;
+		uint16_t reserved;
+		uint64_t size;       // payload bytes after header
+		uint64_t image_size; // encoded image bytes, in payload or shared memory
+	};
+	static_assert(sizeof(reply_header) == 40);
+
+#if SERVICE_WINSOCK
+	using socket_t               = SOCKET;
+	constexpr auto INVALID_FD    = INVALID_SOCKET;
+	constexpr auto SEND_FLAGS    = 0;
+	constexpr auto SHARED_MEMORY = false;
+
+	void close_socket(socket_t fd) { closesocket(fd); }
+	auto poll_sockets(std::span<WSAPOLLFD> fds, int timeout_ms) -> int { return WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeout_ms); }
+	void set_nonblocking(socket_t fd)
+	{
+		auto mode = u_long{ 1 };
+		ioctlsocket(fd, FIONBIO, &mode);
+	}
+	auto would_block() -> bool { return WSAGetLastError() == WSAEWOULDBLOCK; }
+	using pollfd_t = WSAPOLLFD;
+#else
+	using socket_t               = int;
+	constexpr auto INVALID_FD    = -1;
+	constexpr auto SHARED_MEMORY = true;
+#ifdef MSG_NOSIGNAL
+	constexpr auto SEND_FLAGS = MSG_NOSIGNAL; // closed client shouldn't raise SIGPIPE
+#else
+	constexpr auto SEND_FLAGS = 0;
+#endif
+
+	void close_socket(socket_t fd) { close(fd); }
+	auto poll_sockets(std::span<pollfd> fds, int timeout_ms) -> int { return poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms); }
+	void set_nonblocking(socket_t fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+	auto would_block() -> bool { return errno == EAGAIN or errno == EWOULDBLOCK; }
+	using pollfd_t = pollfd;
+#endif
+
+	struct job
+	{
+		uint32_t client;
+		uint32_t request_id;
+		render_request params;
+	};
+
+	struct client
+	{
+		socket_t fd;
+		uint32_t id;
+		io::byte_array inbox;  // bytes received, not yet parsed
+		io::byte_array outbox; // replies not yet sent
+		std::deque<job> queue;
+		bool closed = false;
+	};
+
+	struct server
+	{
+		socket_t listen_fd = INVALID_FD;
+		std::filesystem::path socket_path;
+		std::vector<client> clients;
+		uint32_t next_client_id = 1;
+		size_t next_turn        = 0; // client that picks first in next round
+		bool stopping           = false;
+
+		// Replies finished by encoder threads, moved to client outboxes by service thread
+		std::mutex reply_lock;
+		std::vector<std::pair<uint32_t, io::byte_array>> replies;
+	};
+
+	auto open_server(server &srv, const std::filesystem::path &socket_path) -> bool
+	{
+#if SERVICE_WINSOCK
+		auto wsa = WSADATA{};
+		msg::error(WSAStartup(MAKEWORD(2, 2), &wsa) == 0, "Failed to initialize Winsock.");
+#endif
+		auto addr       = sockaddr_un{};
+		addr.sun_family = AF_UNIX;
+
+		auto path = socket_path.string();
+		if (path.size() >= sizeof(addr.sun_path))
+		{
+			msg::info("Socket path is too long.");
+			return false;
+		}
+		std::ranges::copy(path, addr.sun_path);
+
+		// Left over from a service that didn't shut down cleanly
+		std::filesystem::remove(socket_path);
+
+		srv.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		msg::error(srv.listen_fd != INVALID_FD, "Failed to create socket.");
+		if (srv.listen_fd == INVALID_FD)
+			return false;
+
+		auto bound = bind(srv.listen_fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == 0
+		         and listen(srv.listen_fd, SOMAXCONN) == 0;
+		msg::error(bound, "Failed to bind and listen on socket.");
+		if (not bound)
+		{
+			close_socket(srv.listen_fd);
+			srv.listen_fd = INVALID_FD;
+			return false;
+		}
+
+		set_nonblocking(srv.listen_fd);
+		srv.socket_path = socket_path;
+
+		msg::info(std::format("Render service listening on {}", path));
+		return true;
+	}
+
+	void close_server(server &srv)
+	{
+		for (auto &&c : srv.clients)
+			close_socket(c.fd);
+		srv.clients.clear();
+
+		if (srv.listen_fd != INVALID_FD)
+		{
+			close_socket(srv.listen_fd);
+			std::filesystem::remove(srv.socket_path);
+		}
+		srv.listen_fd = INVALID_FD;
+
+#if SERVICE_WINSOCK
+		WSACleanup();
+#endif
+	}
+
+	auto make_reply(const reply_header &header, io::byte_span payload) -> io::byte_array
+	{
+		auto bytes = io::byte_array(sizeof(reply_header) + payload.size());
+		std::memcpy(bytes.data(), &header, sizeof(reply_header));
+		std::ranges::copy(payload, bytes.begin() + sizeof(reply_header));
+		return bytes;
+	}
+
+	void reply_status(client &c, uint32_t request_id, status_t status)
+	{
+		auto reply = make_reply({ .magic = MAGIC, .id = request_id, .status = status }, {});
+		c.outbox.insert(c.outbox.end(), reply.begin(), reply.end());
+	}
+
+	// Parse every complete request in client's inbox. Malformed stream closes client, it can't be resynchronised.
+	void parse_requests(server &srv, client &c)
+	{
+		auto consumed = size_t{ 0 };
+		while (c.inbox.size() - consumed >= sizeof(request_header))
+		{
+			auto header = request_header{};
+			std::memcpy(&header, c.inbox.data() + consumed, sizeof(header));
+
+			if (header.magic != MAGIC or header.size > MAX_REQUEST_PAYLOAD)
+			{
+				c.closed = true;
+				return;
+			}
+			if (c.inbox.size() - consumed < sizeof(header) + header.size)
+				break;
+
+			auto payload = std::span{ c.inbox }.subspan(consumed + sizeof(header), header.size);
+			consumed += sizeof(header) + header.size;
+
+			switch (header.kind)
+			{
+			case request_kind::render:
+			{
+				if (payload.size() != sizeof(render_request))
+				{
+					reply_status(c, header.id, status_t::bad_request);
+					break;
+				}
+
+				auto params = render_request{};
+				std::memcpy(&params, payload.data(), sizeof(params));
+
+				if (params.encoding > image_encoding::qoi or params.reply > reply_mode::shared_memory)
+					reply_status(c, header.id, status_t::bad_request);
+				else if (params.reply == reply_mode::shared_memory and not SHARED_MEMORY)
+					reply_status(c, header.id, status_t::unsupported);
+				else if (c.queue.size() >= MAX_QUEUED_PER_CLIENT)
+					reply_status(c, header.id, status_t::busy);
+				else
+					c.queue.push_back({ c.id, header.id, params });
+				break;
+			}
+			case request_kind::shutdown:
+				srv.stopping = true;
+				break;
+			default:
+				reply_status(c, header.id, status_t::bad_request);
+				break;
+			}
+		}
+		c.inbox.erase(c.inbox.begin(), c.inbox.begin() + consumed);
+	}
+
+	// Accept, receive and send, without blocking longer than timeout_ms
+	void pump_sockets(server &srv, int timeout_ms)
+	{
+		auto fds = std::vector<pollfd_t>{};
+		fds.push_back({ .fd = srv.listen_fd, .events = POLLIN });
+		for (auto &&c : srv.clients)
+		{
+			fds.push_back({
+			  .fd     = c.fd,
+			  .events = static_cast<short>(POLLIN | (c.outbox.empty() ? 0 : POLLOUT)),
+			});
+		}
+
+		if (poll_sockets(fds, timeout_ms) <= 0)
+			return;
+
+		for (auto &&[c, pfd] : std::views::zip(srv.clients, fds | std::views::drop(1)))
+		{
+			if (pfd.revents & (POLLERR | POLLHUP))
+				c.closed = true;
+
+			if (pfd.revents & POLLIN)
+			{
+				auto buffer   = std::array<char, 4096>{};
+				auto received = recv(c.fd, buffer.data(), static_cast<int>(buffer.size()), 0);
+				if (received > 0)
+				{
+					auto bytes = std::as_bytes(std::span{ buffer }.first(static_cast<size_t>(received)));
+					c.inbox.insert(c.inbox.end(), bytes.begin(), bytes.end());
+					parse_requests(srv, c);
+				}
+				else if (received == 0 or not would_block())
+				{
+					c.closed = true;
+				}
+			}
+
+			if ((pfd.revents & POLLOUT) and not c.outbox.empty())
+			{
+				auto sent = send(c.fd, reinterpret_cast<const char *>(c.outbox.data()), static_cast<int>(c.outbox.size()), SEND_FLAGS);
+				if (sent > 0)
+					c.outbox.erase(c.outbox.begin(), c.outbox.begin() + sent);
+				else if (not would_block())
+					c.closed = true;
+			}
+		}
+
+		if (fds.front().revents & POLLIN)
+		{
+			auto fd = accept(srv.listen_fd, nullptr, nullptr);
+			if (fd != INVALID_FD)
+			{
+				set_nonblocking(fd);
+				srv.clients.push_back({ .fd = fd, .id = srv.next_client_id++ });
+				msg::info(std::format("Render service: client {} connected.", srv.clients.back().id));
+			}
+		}
+
+		// Dropped clients lose queued jobs, replies still being encoded for them are discarded
+		std::erase_if(srv.clients, [](const client &c) {
+			if (c.closed)
+			{
+				close_socket(c.fd);
+				msg::info(std::format("Render service: client {} disconnected.", c.id));
+			}
+			return c.closed;
+		});
+	}
+
+	// Move replies finished by encoders in to their client's outbox
+	void collect_replies(server &srv)
+	{
+		auto ready = std::vector<std::pair<uint32_t, io::byte_array>>{};
+		{
+			auto lk = std::scoped_lock{ srv.reply_lock };
+			std::swap(ready, srv.replies);
+		}
+
+		for (auto &&[client_id, bytes] : ready)
+		{
+			auto it = std::ranges::find(srv.clients, client_id, &client::id);
+			if (it != srv.clients.end())
+				it->outbox.insert(it->outbox.end(), bytes.begin(), bytes.end());
+		}
+	}
+
+	// Up to MAX_JOBS_PER_ROUND jobs, one per client per turn, starting after client that went first last time
+	auto take_round(server &srv) -> std::vector<job>
+	{
+		auto round = std::vector<job>{};
+		auto count = srv.clients.size();
+		if (count == 0)
+			return round;
+
+		auto start = srv.next_turn % count;
+		auto took  = true;
+		while (took and round.size() < MAX_JOBS_PER_ROUND)
+		{
+			took = false;
+			for (auto i = 0u; i < count and round.size() < MAX_JOBS_PER_ROUND; ++i)
+			{
+				auto &c = srv.clients[(start + i) % count];
+				if (c.queue.empty())
+					continue;
+
+				round.push_back(c.queue.front());
+				c.queue.pop_front();
+				took = true;
+			}
+		}
+
+		srv.next_turn = start + 1;
+		return round;
+	}
+
+	// Put encoded image in named shared memory object, returns it's name
+	auto to_shared_memory([[maybe_unused]] const job &jb, [[maybe_unused]] io::byte_span image) -> std::optional<std::string>
+	{
+#if SERVICE_WINSOCK
+		return std::nullopt;
+#else
+		auto name = std::format("/sdl3gpu-{}-{}-{}", getpid(), jb.client, jb.request_id);
+
+		auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (fd < 0)
+			return std::nullopt;
+
+		auto ok = ftruncate(fd, static_cast<off_t>(image.size())) == 0;
+		if (ok and not image.empty())
+		{
+			auto mapped = mmap(nullptr, image.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+			ok          = (mapped != MAP_FAILED);
+			if (ok)
+			{
+				std::memcpy(mapped, image.data(), image.size());
+				munmap(mapped, image.size());
+			}
+		}
+		close(fd);
+
+		if (not ok)
+		{
+			shm_unlink(name.c_str());
+			return std::nullopt;
+		}
+		return name;
+#endif
+	}
+
+	// Encode read back image as job asked, and build it's reply
+	auto build_reply(const job &jb, const sdl3::readback &image) -> io::byte_array
+	{
+		auto encoded = io::byte_array{};
+		switch (jb.params.encoding)
+		{
+		case image_encoding::png:
+			encoded = encode::png(image.data, image.width, image.height);
+			break;
+		case image_encoding::qoi:
+			encoded = encode::qoi(image.data, image.width, image.height);
+			break;
+		default:
+			break;
+		}
+		auto bytes = (jb.params.encoding == image_encoding::raw) ? io::byte_span{ image.data } : io::byte_span{ encoded };
+
+		auto header = reply_header{
+			.magic      = MAGIC,
+			.id         = jb.request_id,
+			.status     = status_t::ok,
+			.width      = image.width,
+			.height     = image.height,
+			.encoding   = jb.params.encoding,
+			.reply      = jb.params.reply,
+			.size       = bytes.size(),
+			.image_size = bytes.size(),
+		};
+
+		if (jb.params.reply == reply_mode::inline_bytes)
+			return make_reply(header, bytes);
+
+		auto name = to_shared_memory(jb, bytes);
+		if (not name)
+			return make_reply({ .magic = MAGIC, .id = jb.request_id, .status = status_t::failed }, {});
+
+		header.size = name->size();
+		return make_reply(header, std::as_bytes(std::span{ *name }));
+	}
+
+	// Serve render requests until a client asks for shutdown
+	auto serve(const sdl3::context &ctx, scenario::running &run, postfx::chain &fx, const std::filesystem::path &socket_path) -> bool
+	{
+		auto srv = server{};
+		if (not open_server(srv, socket_path))
+			return false;
+
+		auto worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		auto max_queued   = worker_count * batch::MAX_QUEUED_PER_WORKER;
+
+		auto pool = batch::worker_pool{};
+		batch::start_workers(pool, worker_count);
+
+		auto jobs_served = uint64_t{ 0 };
+
+		while (true)
+		{
+			auto has_jobs = std::ranges::any_of(srv.clients, [](const client &c) { return not c.queue.empty(); });
+			if (srv.stopping and not has_jobs)
+				break;
+
+			pump_sockets(srv, has_jobs ? 0 : IDLE_POLL_MS);
+			collect_replies(srv);
+
+			auto round = take_round(srv);
+			if (round.empty())
+				continue;
+
+			auto setup = [&](size_t i) {
+				if (run.fn.set_camera)
+					run.fn.set_camera(round[i].params.cam);
+			};
+
+			auto delivered = std::vector<bool>(round.size(), false);
+			auto deliver   = [&](size_t i, sdl3::readback &&image) {
+				delivered[i] = true;
+				auto reply_task = [&srv, jb = round[i], image = std::move(image)] {
+					auto bytes = build_reply(jb, image);
+
+					auto lk = std::scoped_lock{ srv.reply_lock };
+					srv.replies.emplace_back(jb.client, std::move(bytes));
+				};
+				batch::submit(pool, std::move(reply_task), max_queued);
+			};
+
+			auto failed = batch::render_offscreen(ctx, run, fx, round.size(), setup, deliver);
+			jobs_served += round.size() - failed;
+
+			// Jobs whose readback couldn't be queued still get a reply, so their clients don't wait forever
+			if (failed > 0)
+			{
+				auto lk = std::scoped_lock{ srv.reply_lock };
+				for (auto &&[jb, done] : std::views::zip(round, delivered))
+				{
+					if (not done)
+						srv.replies.emplace_back(jb.client, make_reply({ .magic = MAGIC, .id = jb.request_id, .status = status_t::failed }, {}));
+				}
+			}
+		}
+
+		// Send what's left, to clients that are still connected and reading, until deadline
+		batch::wait_idle(pool);
+		batch::stop_workers(pool);
+		collect_replies(srv);
+
+		auto pending  = [&] { return std::ranges::any_of(srv.clients, [](const client &c) { return not c.outbox.empty(); }); };
+		auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_DRAIN_TIMEOUT;
+		while (pending() and std::chrono::steady_clock::now() < deadline)
+		{
+			pump_sockets(srv, IDLE_POLL_MS);
+		}
+		if (pending())
+			msg::info("Render service: some replies weren't read before shutdown, they're dropped.");
+
+		close_server(srv);
+
+		msg::info(std::format("Render service: stopped, {} jobs served.", jobs_served));
+		return true;
+	}
+}
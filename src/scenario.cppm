@@ -0,0 +1,235 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module scenario;
+
+import std;
+import logs;
+import sdl3_init;
+import sdl3_scene;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Registry of selectable scenes, so benchmarks can isolate one rendering cost at a time.
+ * Each scenario makes it's own scene, and per-frame hooks that own any other state it needs.
+ */
+export namespace scenario
+{
+	constexpr auto DEFAULT_SCENARIO = "textured_mesh"sv;
+
+	// Frames excluded from benchmark summary, while pipelines and caches warm up
+	constexpr auto WARMUP_FRAMES = uint64_t{ 10 };
+
+	// Orbit camera position, degrees around scene and height, used to place batch mode views
+	struct camera
+	{
+		float angle = 0.0f;
+		float cam_y = 0.0f;
+	};
+
+	// Part of a larger output image a frame renders, for tiled export.
+	// Pixels from top left, tiles on right and bottom edges can extend past image.
+	struct tile_view
+	{
+		uint32_t image_width;
+		uint32_t image_height;
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	struct hooks
+	{
+		// Before sdl3::begin_frame, stage uploads here
+		std::function<void(const sdl3::context &ctx, sdl3::scene &scn, float dt)> update;
+		// Record draws in to scene color texture, before post processing
+		std::function<void(sdl3::frame_context &frm, sdl3::scene &scn)> draw;
+		// Optional, draws on top of swapchain image after post processing
+		std::function<void(sdl3::frame_context &frm, sdl3::scene &scn)> draw_overlay;
+		// Optional, key presses main doesn't handle
+		std::function<void(const SDL_KeyboardEvent &key, sdl3::scene &scn)> on_key;
+		// Optional, move camera to batch job's view, update is called after it
+		std::function<void(const camera &cam)> set_camera;
+		// Optional, crop projection to tile of a larger image, update is called after it
+		std::function<void(const tile_view &tile)> set_tile;
+		// Optional, release GPU resources hooks own, called before scene is destroyed
+		std::function<void()> shutdown;
+	};
+
+	// Scenario that has been set up, and is ready to run
+	struct running
+	{
+		sdl3::scene scn;
+		hooks fn;
+	};
+
+	struct entry
+	{
+		std::string_view name;
+		std::string_view description;
+		std::function<running(const sdl3::context &ctx)> setup;
+	};
+
+	using registry = std::vector<entry>;
+
+	auto find(const registry &reg, std::string_view name) -> const entry *
+	{
+		auto it = std::ranges::find(reg, name, &entry::name);
+		return (it == reg.end()) ? nullptr : &*it;
+	}
+
+	void print_list(const registry &reg)
+	{
+		auto width = std::ranges::max(reg | std::views::transform([](const entry &e) { return e.name.size(); }));
+		for (auto &&e : reg)
+		{
+			std::println("  {:<{}}  {}", e.name, width, e.description);
+		}
+	}
+
+	// Command line flags
+	struct options
+	{
+		std::string_view scenario = DEFAULT_SCENARIO;
+		uint64_t frames           = 0; // quit after this many frames, 0 runs until window is closed
+		bool list                 = false;
+		bool valid                = true;
+
+		// Batch mode, renders this many orbit views headless and writes them to output directory
+		uint32_t batch                = 0;
+		std::string_view output       = "batch_output"sv;
+		std::string_view image_format = "png"sv;
+
+		// Tiled export, renders one image of this size in tiles, written to output directory
+		uint32_t export_width  = 0;
+		uint32_t export_height = 0;
+		uint32_t tile_size     = 2048;
+
+		// Anti-aliasing, none, msaa2, msaa4, msaa8, fxaa, smaa or taa
+		std::string_view antialiasing = "none"sv;
+
+		// Fraction of window size scene is drawn at, upscaled by post processing
+		float render_scale = 1.0f;
+
+		// Skip half precision shader variants, to compare against full precision
+		bool full_precision = false;
+
+		// Render service, serves render requests on this local socket until a client asks it to stop
+		std::string_view serve = {};
+
+		// glTF file for gltf_viewer scenario
+		std::string_view import_file = {};
+	};
+
+	// Parse number argument, marks options invalid if it isn't one
+	void parse_count(std::string_view value, std::string_view name, auto &count, options &opts)
+	{
+		auto result = std::from_chars(value.data(), value.data() + value.size(), count);
+		if (result.ec != std::errc{})
+		{
+			std::println("Invalid {}: {}", name, value);
+			opts.valid = false;
+		}
+	}
+
+	// --scenario <name>, --frames <count>, --list, --fp32
+	// --batch <count>, --output <directory>, --format <png|qoi>
+	// --export <width>x<height>, --tile <size>
+	// --serve <socket path>, --aa <mode>, --scale <fraction>
+	auto parse_args(std::span<char *const> args) -> options
+	{
+		auto opts = options{};
+
+		for (auto it = args.begin() + std::min<std::ptrdiff_t>(1, std::ssize(args)); it != args.end(); ++it)
+		{
+			auto arg      = std::string_view{ *it };
+			auto has_next = std::next(it) != args.end();
+
+			if (arg == "--list"sv)
+			{
+				opts.list = true;
+			}
+			else if (arg == "--fp32"sv)
+			{
+				opts.full_precision = true;
+			}
+			else if (arg == "--scenario"sv and has_next)
+			{
+				opts.scenario = *++it;
+			}
+			else if (arg == "--frames"sv and has_next)
+			{
+				parse_count(*++it, "frame count"sv, opts.frames, opts);
+			}
+			else if (arg == "--batch"sv and has_next)
+			{
+				parse_count(*++it, "batch count"sv, opts.batch, opts);
+			}
+			else if (arg == "--output"sv and has_next)
+			{
+				opts.output = *++it;
+			}
+			else if (arg == "--format"sv and has_next)
+			{
+				opts.image_format = *++it;
+			}
+			else if (arg == "--export"sv and has_next)
+			{
+				auto value = std::string_view{ *++it };
+				auto x     = value.find('x');
+				parse_count(value.substr(0, x), "export width"sv, opts.export_width, opts);
+				parse_count((x == value.npos) ? ""sv : value.substr(x + 1), "export height"sv, opts.export_height, opts);
+			}
+			else if (arg == "--tile"sv and has_next)
+			{
+				parse_count(*++it, "tile size"sv, opts.tile_size, opts);
+			}
+			else if (arg == "--aa"sv and has_next)
+			{
+				opts.antialiasing = *++it;
+			}
+			else if (arg == "--scale"sv and has_next)
+			{
+				parse_count(*++it, "render scale"sv, opts.render_scale, opts);
+			}
+			else if (arg == "--serve"sv and has_next)
+			{
+				opts.serve = *++it;
+			}
+			else if (arg == "--import"sv and has_next)
+			{
+				opts.import_file = *++it;
+			}
+			else
+			{
+				std::println("Unknown argument: {}", arg);
+				opts.valid = false;
+			}
+		}
+
+		return opts;
+	}
+
+	// Frame time statistics printed at end of a --frames run
+	void print_summary(std::string_view name, std::span<const float> frame_ms)
+	{
+		auto samples = frame_ms | std::views::drop(WARMUP_FRAMES) | std::ranges::to<std::vector>();
+		if (samples.empty())
+			return;
+
+		std::ranges::sort(samples);
+		auto rank = [&](float p) {
+			auto idx = static_cast<size_t>(std::ceil(p * samples.size())) - 1;
+			return samples[std::min(idx, samples.size() - 1)];
+		};
+		auto mean = std::reduce(samples.begin(), samples.end()) / samples.size();
+
+		msg::info(std::format("Scenario {}: {} frames, mean {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms",
+		                      name, samples.size(), mean, rank(0.50f), rank(0.95f), rank(0.99f)));
+	}
+}
@@ -0,0 +1,417 @@
+module;
+
+// Memory mapped files
+#if defined(_WIN32)
+#include <windows.h>
+#define SCENE_FILE_WIN32 1
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCENE_FILE_WIN32 0
+#endif
+
+export module scene_file;
+
+import std;
+import logs;
+import io;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Binary scene whose in-file layout is the runtime layout.
+ * Header holds offsets, from start of file, to aligned arrays of vertices, indices, instances, etc.
+ * Opening maps file in to memory and turns offsets in to spans, no element is parsed or copied,
+ * so init_scene uploads straight from mapped pages.
+ */
+export namespace sfile
+{
+	constexpr auto MAGIC     = uint32_t{ 0x3153'4753 }; // "SGS1"
+	constexpr auto VERSION   = uint32_t{ 1 };
+	constexpr auto ALIGNMENT = uint64_t{ 16 }; // every array starts on this boundary
+
+	// Same layout as app::vertex and glm::mat4, so arrays go to GPU as they are
+	struct vertex
+	{
+		std::array<float, 3> pos;
+		std::array<float, 2> uv;
+	};
+	static_assert(sizeof(vertex) == 20);
+
+	using position  = std::array<float, 3>;
+	using transform = std::array<float, 16>; // column major
+
+	struct aabb
+	{
+		std::array<float, 3> min;
+		std::array<float, 3> max;
+	};
+	static_assert(sizeof(aabb) == 24);
+
+	enum class blend_t : uint32_t
+	{
+		opaque      = 0,
+		transparent = 1,
+	};
+
+	// Instances are ordered by material, each material owns a contiguous run of them
+	struct material
+	{
+		uint32_t texture; // index in to textures
+		blend_t blend;
+		uint32_t first_instance;
+		uint32_t instance_count;
+	};
+	static_assert(sizeof(material) == 16);
+
+	// Path of texture file, bytes are in strings array
+	struct texture_ref
+	{
+		uint64_t path_offset; // from start of strings
+		uint32_t path_size;
+		uint32_t reserved;
+	};
+	static_assert(sizeof(texture_ref) == 16);
+
+	struct array_ref
+	{
+		uint64_t offset; // from start of file
+		uint64_t count;  // elements, not bytes
+	};
+
+	struct file_header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t file_size;
+
+		array_ref vertices;
+		array_ref positions; // depth only stream, pos of every vertex
+		array_ref indices;
+		array_ref instances;
+		array_ref bounds; // world space box of every instance
+		array_ref materials;
+		array_ref textures;
+		array_ref strings;
+
+		aabb scene_bounds;
+	};
+	static_assert(sizeof(file_header) == 168);
+
+	// Everything that goes in to a scene file, positions and bounds are derived from these
+	struct scene_source
+	{
+		std::span<const vertex> vertices;
+		std::span<const uint32_t> indices;
+		std::span<const transform> instances;
+		std::span<const material> materials;
+		std::span<const std::string> textures;
+	};
+
+	// Unmaps view when released, mapping and file handles are already closed by then
+	struct unmap_deleter
+	{
+		size_t size = 0;
+
+		void operator()(const std::byte *data) const
+		{
+#if SCENE_FILE_WIN32
+			UnmapViewOfFile(data);
+#else
+			munmap(const_cast<std::byte *>(data), size);
+#endif
+		}
+	};
+	using mapped_ptr = std::unique_ptr<const std::byte, unmap_deleter>;
+
+	// Read only view of whole file, empty if it can't be mapped
+	auto map_file(const std::filesystem::path &filename) -> mapped_ptr
+	{
+#if SCENE_FILE_WIN32
+		auto file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return {};
+
+		auto size = LARGE_INTEGER{};
+		auto view = (void *)nullptr;
+		if (GetFileSizeEx(file, &size) and size.QuadPart > 0)
+		{
+			auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+
+		if (view == nullptr)
+			return {};
+		return mapped_ptr{ static_cast<const std::byte *>(view), unmap_deleter{ static_cast<size_t>(size.QuadPart) } };
+#else
+		auto fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return {};
+
+		struct stat info = {};
+		auto view = MAP_FAILED;
+		if (fstat(fd, &info) == 0 and info.st_size > 0)
+			view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (view == MAP_FAILED)
+			return {};
+		return mapped_ptr{ static_cast<const std::byte *>(view), unmap_deleter{ static_cast<size_t>(info.st_size) } };
+#endif
+	}
+
+	// Open scene file, spans point in to mapped file and live as long as it does
+	struct scene_view
+	{
+		mapped_ptr file;
+		file_header header;
+
+		std::span<const vertex> vertices;
+		std::span<const position> positions;
+		std::span<const uint32_t> indices;
+		std::span<const transform> instances;
+		std::span<const aabb> bounds;
+		std::span<const material> materials;
+		std::span<const texture_ref> textures;
+		std::span<const char> strings;
+	};
+
+	// First and one past last instance of every material with this blend, empty if it has none
+	auto blend_extent(std::span<const material> materials, blend_t blend) -> std::pair<uint32_t, uint32_t>
+	{
+		auto runs = materials
+		          | std::views::filter([&](const material &mat) { return mat.blend == blend and mat.instance_count > 0; });
+		if (runs.empty())
+			return { 0u, 0u };
+
+		auto first = std::ranges::min(runs | std::views::transform(&material::first_instance));
+		auto last  = std::ranges::max(runs | std::views::transform([](const material &mat) {
+			return mat.first_instance + mat.instance_count;
+		}));
+		return { first, last };
+	}
+
+	// Runs don't overlap, and each blend's runs fill it's extent, so no other blend's instances are inside it
+	auto blend_runs_contiguous(std::span<const material> materials) -> bool
+	{
+		auto runs = materials
+		          | std::views::filter([](const material &mat) { return mat.instance_count > 0; })
+		          | std::ranges::to<std::vector>();
+		std::ranges::sort(runs, {}, &material::first_instance);
+
+		auto overlaps = std::ranges::adjacent_find(runs, [](const material &a, const material &b) {
+			return a.first_instance + a.instance_count > b.first_instance;
+		});
+		if (overlaps != runs.end())
+			return false;
+
+		return std::ranges::all_of(std::array{ blend_t::opaque, blend_t::transparent }, [&](blend_t blend) {
+			auto [first, last] = blend_extent(materials, blend);
+			auto count = std::ranges::fold_left(runs
+			                                      | std::views::filter([&](const material &mat) { return mat.blend == blend; })
+			                                      | std::views::transform(&material::instance_count),
+			                                    0ull, std::plus{});
+			return count == last - first;
+		});
+	}
+
+	// Pointer fixup, array has to lie inside file and be aligned for it's type
+	template <typename T>
+	auto to_span(const mapped_ptr &file, const array_ref &ref) -> std::optional<std::span<const T>>
+	{
+		auto size = file.get_deleter().size;
+		if (ref.offset % ALIGNMENT != 0 or ref.offset > size or ref.count > (size - ref.offset) / sizeof(T))
+			return std::nullopt;
+
+		return std::span{ reinterpret_cast<const T *>(file.get() + ref.offset), static_cast<size_t>(ref.count) };
+	}
+
+	// Checks header, array bounds and material ranges, never individual vertices or instances.
+	// Materials of one blend have to own one contiguous run of instances, as instances_of returns a single span.
+	auto open_scene(const std::filesystem::path &filename) -> std::optional<scene_view>
+	{
+		auto file = map_file(filename);
+		if (not file or file.get_deleter().size < sizeof(file_header))
+		{
+			msg::info(std::format("Scene file {} couldn't be mapped.", filename.string()));
+			return std::nullopt;
+		}
+
+		auto header = file_header{};
+		std::memcpy(&header, file.get(), sizeof(header));
+		if (header.magic != MAGIC or header.version != VERSION or header.file_size != file.get_deleter().size)
+		{
+			msg::info(std::format("Scene file {} has wrong magic, version or size.", filename.string()));
+			return std::nullopt;
+		}
+
+		auto vertices  = to_span<vertex>(file, header.vertices);
+		auto positions = to_span<position>(file, header.positions);
+		auto indices   = to_span<uint32_t>(file, header.indices);
+		auto instances = to_span<transform>(file, header.instances);
+		auto bounds    = to_span<aabb>(file, header.bounds);
+		auto materials = to_span<material>(file, header.materials);
+		auto textures  = to_span<texture_ref>(file, header.textures);
+		auto strings   = to_span<char>(file, header.strings);
+
+		auto arrays_ok = vertices and positions and indices and instances and bounds and materials and textures and strings
+		             and positions->size() == vertices->size()
+		             and bounds->size() == instances->size();
+		auto materials_ok = arrays_ok and std::ranges::all_of(*materials, [&](const material &mat) {
+			return mat.texture < textures->size()
+			   and mat.first_instance <= instances->size()
+			   and mat.instance_count <= instances->size() - mat.first_instance;
+		});
+		if (not materials_ok)
+		{
+			msg::info(std::format("Scene file {} has arrays outside of file.", filename.string()));
+			return std::nullopt;
+		}
+
+		if (not blend_runs_contiguous(*materials))
+		{
+			msg::info(std::format("Scene file {} has instances of different blends interleaved.", filename.string()));
+			return std::nullopt;
+		}
+
+		return scene_view{
+			.file      = std::move(file),
+			.header    = header,
+			.vertices  = *vertices,
+			.positions = *positions,
+			.indices   = *indices,
+			.instances = *instances,
+			.bounds    = *bounds,
+			.materials = *materials,
+			.textures  = *textures,
+			.strings   = *strings,
+		};
+	}
+
+	auto texture_path(const scene_view &scn, uint32_t texture) -> std::filesystem::path
+	{
+		auto &ref = scn.textures[texture];
+		msg::error(ref.path_offset <= scn.strings.size() and ref.path_size <= scn.strings.size() - ref.path_offset,
+		           "Texture path is outside of scene file's strings.");
+
+		auto path = scn.strings.subspan(ref.path_offset, ref.path_size);
+		return std::filesystem::path{ std::string_view{ path.data(), path.size() } };
+	}
+
+	// Instances of every material with this blend, open_scene checked they're contiguous
+	auto instances_of(const scene_view &scn, blend_t blend) -> std::span<const transform>
+	{
+		auto [first, last] = blend_extent(scn.materials, blend);
+		return scn.instances.subspan(first, last - first);
+	}
+
+	// Box around mesh's positions, moved by transform
+	auto transform_bounds(const aabb &box, const transform &t) -> aabb
+	{
+		auto result = aabb{
+			.min = { t[12], t[13], t[14] },
+			.max = { t[12], t[13], t[14] },
+		};
+
+		// Arvo's method, each matrix element adds whichever box extent makes it smaller or larger
+		for (auto row : std::views::iota(0u, 3u))
+		{
+			for (auto column : std::views::iota(0u, 3u))
+			{
+				auto a = t[column * 4 + row] * box.min[column];
+				auto b = t[column * 4 + row] * box.max[column];
+				result.min[row] += std::min(a, b);
+				result.max[row] += std::max(a, b);
+			}
+		}
+		return result;
+	}
+
+	auto merge(const aabb &a, const aabb &b) -> aabb
+	{
+		return {
+			.min = { std::min(a.min[0], b.min[0]), std::min(a.min[1], b.min[1]), std::min(a.min[2], b.min[2]) },
+			.max = { std::max(a.max[0], b.max[0]), std::max(a.max[1], b.max[1]), std::max(a.max[2], b.max[2]) },
+		};
+	}
+
+	// Lay out arrays in file order, writing is the only place elements are looked at
+	auto write_scene(const std::filesystem::path &filename, const scene_source &src) -> bool
+	{
+		msg::error(not src.vertices.empty() and not src.indices.empty(), "Scene needs a mesh.");
+
+		auto positions = src.vertices
+		               | std::views::transform(&vertex::pos)
+		               | std::ranges::to<std::vector>();
+
+		auto mesh_bounds = aabb{ .min = positions.front(), .max = positions.front() };
+		for (auto &&pos : positions)
+			mesh_bounds = merge(mesh_bounds, { .min = pos, .max = pos });
+
+		auto bounds = src.instances
+		            | std::views::transform([&](const transform &t) { return transform_bounds(mesh_bounds, t); })
+		            | std::ranges::to<std::vector>();
+		auto scene_bounds = bounds.empty() ? mesh_bounds : std::ranges::fold_left(bounds, bounds.front(), merge);
+
+		auto strings    = std::string{};
+		auto references = std::vector<texture_ref>{};
+		for (auto &&path : src.textures)
+		{
+			references.push_back({ .path_offset = strings.size(), .path_size = static_cast<uint32_t>(path.size()) });
+			strings += path;
+		}
+
+		auto header = file_header{
+			.magic        = MAGIC,
+			.version      = VERSION,
+			.scene_bounds = scene_bounds,
+		};
+
+		// Arrays follow header in order, each padded to alignment
+		auto arrays = std::vector<std::pair<array_ref *, io::byte_span>>{
+			{ &header.vertices, io::as_byte_span(src.vertices) },
+			{ &header.positions, io::as_byte_span(positions) },
+			{ &header.indices, io::as_byte_span(src.indices) },
+			{ &header.instances, io::as_byte_span(src.instances) },
+			{ &header.bounds, io::as_byte_span(bounds) },
+			{ &header.materials, io::as_byte_span(src.materials) },
+			{ &header.textures, io::as_byte_span(references) },
+			{ &header.strings, io::as_byte_span(strings) },
+		};
+		auto counts = std::array{ src.vertices.size(), positions.size(), src.indices.size(), src.instances.size(),
+			                      bounds.size(), src.materials.size(), references.size(), strings.size() };
+
+		auto aligned = [](uint64_t offset) { return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; };
+
+		auto offset = aligned(sizeof(file_header));
+		for (auto &&[array, count] : std::views::zip(arrays, counts))
+		{
+			*array.first = { .offset = offset, .count = count };
+			offset       = aligned(offset + array.second.size());
+		}
+		header.file_size = offset;
+
+		auto file = std::ofstream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (not file.good())
+			return false;
+
+		auto padding = std::array<char, ALIGNMENT>{};
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(padding.data(), static_cast<std::streamsize>(aligned(sizeof(header)) - sizeof(header)));
+		for (auto &&[ref, bytes] : arrays)
+		{
+			file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			file.write(padding.data(), static_cast<std::streamsize>(aligned(bytes.size()) - bytes.size()));
+		}
+
+		return file.good();
+	}
+}
@@ -11,7 +11,11 @@ import logs;
 export namespace sdl3
 {
 	// Compilation mode
-	constexpr auto IS_DEBUG = bool{ _DEBUG };
+#ifdef _DEBUG
+	constexpr auto IS_DEBUG = true;
+#else
+	constexpr auto IS_DEBUG = false;
+#endif
 
 	// Deleter template, for use with SDL objects.
 	// Allows use of SDL Objects with C++'s smart pointers, using SDL's destroy function
@@ -32,6 +36,20 @@ export namespace sdl3
 	{
 		window_ptr window;
 		gpu_ptr gpu;
+
+		// Render size of headless context, which has no window to ask
+		uint32_t width  = 0;
+		uint32_t height = 0;
+
+		// Samples per pixel of scene color and depth, pipelines drawing in to them are made to match
+		SDL_GPUSampleCount msaa = SDL_GPU_SAMPLECOUNT_1;
+
+		// Fraction of render size scene is drawn at, post processing scales it back up
+		float render_scale = 1.0f;
+
+		// Load half precision shader variants where they were built.
+		// They use min precision types, so they're valid on every device, and only run at 16 bits where hardware can.
+		bool half_precision = true;
 	};
 
 	// Initialize SDL with GPU
@@ -62,12 +80,82 @@ export namespace sdl3
 		};
 	}
 
+	// Initialize SDL with GPU, but no window or swapchain.
+	// Frames render in to offscreen targets, for batch and export modes.
+	auto init_headless_context(uint32_t width, uint32_t height) -> context
+	{
+		msg::info("Initialize SDL and GPU, headless");
+
+		// No subsystems, so servers without a display work, Vulkan and D3D12 devices don't need video
+		auto result = SDL_Init(0);
+		msg::error(result == true, "SDL could not initialize.");
+
+		auto gpu = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_DXIL | SDL_GPU_SHADERFORMAT_SPIRV, IS_DEBUG, NULL);
+
+		// Some GPU drivers load their libraries through video subsystem, offscreen video driver needs no display
+		if (gpu == nullptr)
+		{
+			msg::info("GPU device needs video subsystem, using offscreen video driver.");
+			SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+			result = SDL_InitSubSystem(SDL_INIT_VIDEO);
+			msg::error(result == true, "SDL video could not initialize.");
+
+			gpu = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_DXIL | SDL_GPU_SHADERFORMAT_SPIRV, IS_DEBUG, NULL);
+		}
+		msg::error(gpu != nullptr, "Could not get GPU device.");
+
+		auto gpu_driver_name = std::string_view{ SDL_GetGPUDeviceDriver(gpu) };
+		msg::info(std::format("GPU Driver Name: {}", gpu_driver_name));
+
+		return {
+			.gpu    = gpu_ptr(gpu),
+			.width  = width,
+			.height = height,
+		};
+	}
+
+	// Size in pixels frames are rendered at, window's size or headless context's fixed size
+	auto render_size(const context &ctx) -> std::array<uint32_t, 2>
+	{
+		if (ctx.window == nullptr)
+			return { ctx.width, ctx.height };
+
+		auto w = 0, h = 0;
+		SDL_GetWindowSizeInPixels(ctx.window.get(), &w, &h);
+		return { static_cast<uint32_t>(w), static_cast<uint32_t>(h) };
+	}
+
+	// Size scene's color and depth targets are made at
+	auto scene_size(const context &ctx) -> std::array<uint32_t, 2>
+	{
+		auto [w, h] = render_size(ctx);
+		auto scale  = [&](uint32_t size) {
+			return std::max(static_cast<uint32_t>(std::lround(size * ctx.render_scale)), 1u);
+		};
+		return { scale(w), scale(h) };
+	}
+
+	// Compiled shader to load, half precision variant if context asks for one and it was built
+	auto shader_file(const context &ctx, std::string_view name, std::string_view profile) -> std::filesystem::path
+	{
+		if (ctx.half_precision)
+		{
+			auto half = std::filesystem::path{ std::format("shaders/{}_fp16.{}.cso", name, profile) };
+			if (std::filesystem::exists(half))
+				return half;
+		}
+		return std::format("shaders/{}.{}.cso", name, profile);
+	}
+
 	// Destroy/Clean up SDL objects, especially cases not captured by custom deleter
 	auto destroy_context(context &ctx)
 	{
 		msg::info("Destroy Window, GPU and SDL");
 
-		SDL_ReleaseWindowFromGPUDevice(ctx.gpu.get(), ctx.window.get());
+		if (ctx.window != nullptr)
+		{
+			SDL_ReleaseWindowFromGPUDevice(ctx.gpu.get(), ctx.window.get());
+		}
 
 		ctx = {};
 		SDL_Quit();
@@ -0,0 +1,541 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module sdl3_postfx;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Post processing chain, resolves scene's HDR color texture in to swapchain
+ */
+export namespace postfx
+{
+	constexpr auto LDR_FORMAT   = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+	constexpr auto BLOOM_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+	// Temporal upscaler's output, still HDR, bloom and tone map run on it
+	constexpr auto HISTORY_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+
+	// Transient targets not requested for this many frames are released
+	constexpr auto MAX_IDLE_FRAMES = uint64_t{ 3 };
+
+	// Fraction of output resolution an effect runs at
+	enum class resolution_t : uint8_t
+	{
+		full    = 1,
+		half    = 2,
+		quarter = 4,
+	};
+
+	// Anti-aliasing method.
+	// MSAA modes are carried by scene's targets and pipelines, made with context's sample count.
+	// FXAA and SMAA are passes here, on tone mapped image, at a fraction of MSAA's bandwidth.
+	// TAA accumulates jittered frames before tone mapping, and upscales scenes drawn below output size.
+	enum class antialiasing_t : uint8_t
+	{
+		none,
+		msaa_2x,
+		msaa_4x,
+		msaa_8x,
+		fxaa,
+		smaa, // luma edges and search based blend, without SMAA's area and search textures
+		taa,  // needs scenario to jitter it's projection, see sdl3::temporal_view
+	};
+
+	constexpr auto ANTIALIASING_NAMES = std::array{ "none"sv, "msaa2"sv, "msaa4"sv, "msaa8"sv, "fxaa"sv, "smaa"sv, "taa"sv };
+
+	auto to_string(antialiasing_t mode) -> std::string_view
+	{
+		return ANTIALIASING_NAMES.at(std::to_underlying(mode));
+	}
+
+	auto parse_antialiasing(std::string_view name) -> std::optional<antialiasing_t>
+	{
+		auto it = std::ranges::find(ANTIALIASING_NAMES, name);
+		if (it == ANTIALIASING_NAMES.end())
+			return std::nullopt;
+
+		return static_cast<antialiasing_t>(std::distance(ANTIALIASING_NAMES.begin(), it));
+	}
+
+	// Mode after this one, wrapping around
+	auto next(antialiasing_t mode) -> antialiasing_t
+	{
+		return static_cast<antialiasing_t>((std::to_underlying(mode) + 1) % ANTIALIASING_NAMES.size());
+	}
+
+	// Scene sample count mode asks for, before device support is checked
+	auto sample_count(antialiasing_t mode) -> SDL_GPUSampleCount
+	{
+		switch (mode)
+		{
+		case antialiasing_t::msaa_2x:
+			return SDL_GPU_SAMPLECOUNT_2;
+		case antialiasing_t::msaa_4x:
+			return SDL_GPU_SAMPLECOUNT_4;
+		case antialiasing_t::msaa_8x:
+			return SDL_GPU_SAMPLECOUNT_8;
+		default:
+			return SDL_GPU_SAMPLECOUNT_1;
+		}
+	}
+
+	auto is_post_process(antialiasing_t mode) -> bool
+	{
+		return mode == antialiasing_t::fxaa or mode == antialiasing_t::smaa;
+	}
+
+	// Transient render targets, handed out every frame.
+	// Texture with matching description is reused, instead of creating a new one.
+	struct target_pool
+	{
+		struct entry
+		{
+			sdl3::texture_desc desc;
+			sdl3::gpu_texture_ptr texture;
+			uint64_t last_used;
+			bool in_use;
+		};
+
+		std::vector<entry> entries;
+		uint64_t frame_index = 0;
+	};
+
+	// Get unused target matching description, or make a new one
+	auto acquire_target(SDL_GPUDevice *gpu, target_pool &pool, const sdl3::texture_desc &desc) -> SDL_GPUTexture *
+	{
+		auto it = std::ranges::find_if(pool.entries, [&](const auto &e) {
+			return not e.in_use and e.desc == desc;
+		});
+
+		if (it == pool.entries.end())
+		{
+			pool.entries.push_back({
+			  .desc    = desc,
+			  .texture = sdl3::make_texture(gpu, desc, "Post Process Target"sv),
+			});
+			it = std::prev(pool.entries.end());
+		}
+
+		it->in_use    = true;
+		it->last_used = pool.frame_index;
+		return it->texture.get();
+	}
+
+	// Return all targets to pool at end of frame, and release ones that have been idle too long
+	void recycle_targets(target_pool &pool)
+	{
+		std::erase_if(pool.entries, [&](const auto &e) {
+			return pool.frame_index - e.last_used > MAX_IDLE_FRAMES;
+		});
+
+		for (auto &e : pool.entries)
+		{
+			e.in_use = false;
+		}
+
+		++pool.frame_index;
+	}
+
+	// Runtime adjustable effect settings
+	struct settings
+	{
+		bool bloom         = true;
+		bool tonemap       = true;
+		bool color_grading = true;
+
+		float exposure        = 1.0f;
+		float bloom_threshold = 0.8f;
+		float bloom_knee      = 0.2f;
+		float bloom_intensity = 0.6f;
+		float saturation      = 1.1f;
+		float contrast        = 1.05f;
+
+		antialiasing_t antialiasing   = antialiasing_t::none;
+		float fxaa_edge_threshold     = 0.166f;
+		float fxaa_edge_threshold_min = 0.0833f;
+		float fxaa_subpixel           = 0.75f;
+		float smaa_threshold          = 0.1f;
+		float taa_current_weight      = 0.1f; // share of new frame, lower is smoother but ghosts longer
+	};
+
+	// Uniform buffers, layouts match HLSL
+	struct bloom_params
+	{
+		float threshold;
+		float knee;
+		std::array<float, 2> direction;
+	};
+
+	struct tone_params
+	{
+		float exposure;
+		float bloom_intensity;
+		float saturation;
+		float contrast;
+		uint32_t tonemap;
+		uint32_t grade;
+		std::array<float, 2> padding;
+	};
+
+	struct antialias_params
+	{
+		float fxaa_edge_threshold;
+		float fxaa_edge_threshold_min;
+		float fxaa_subpixel;
+		float smaa_threshold;
+	};
+
+	struct temporal_params
+	{
+		std::array<float, 2> jitter;
+		float current_weight;
+		uint32_t history_valid;
+	};
+
+	// Temporal upscaler's results, at output size, kept from frame to frame.
+	// Not from target pool, last frame's has to survive until this frame reads it.
+	struct temporal_history
+	{
+		std::array<sdl3::gpu_texture_ptr, 2> textures;
+		sdl3::texture_desc desc;
+		uint32_t current = 0; // written this frame, other one is read
+		bool valid       = false;
+	};
+
+	struct chain
+	{
+		settings config;
+
+		sdl3::cmp_pipeline_ptr bloom_prefilter;
+		sdl3::cmp_pipeline_ptr bloom_blur;
+		sdl3::cmp_pipeline_ptr tonemap_grade;
+		sdl3::cmp_pipeline_ptr fxaa;
+		sdl3::cmp_pipeline_ptr smaa_edges;
+		sdl3::cmp_pipeline_ptr smaa_blend;
+		sdl3::cmp_pipeline_ptr temporal_resolve;
+		sdl3::gpu_sampler_ptr linear_sampler;
+
+		target_pool targets;
+		temporal_history history;
+	};
+
+	auto init_chain(const sdl3::context &ctx) -> chain
+	{
+		auto gpu = ctx.gpu.get();
+
+		msg::info("Create Post Processing Chain.");
+
+		auto fx = chain{};
+
+		auto prefilter_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/bloom_prefilter.cs_6_4.cso"),
+			.sampler_count                   = 1,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.bloom_prefilter = sdl3::make_cmp_pipeline(gpu, prefilter_desc);
+
+		auto blur_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/bloom_blur.cs_6_4.cso"),
+			.sampler_count                   = 1,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.bloom_blur = sdl3::make_cmp_pipeline(gpu, blur_desc);
+
+		auto tonemap_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file(sdl3::shader_file(ctx, "tonemap_grade"sv, "cs_6_4"sv)),
+			.sampler_count                   = 2,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.tonemap_grade = sdl3::make_cmp_pipeline(gpu, tonemap_desc);
+
+		auto fxaa_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/fxaa.cs_6_4.cso"),
+			.sampler_count                   = 1,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.fxaa = sdl3::make_cmp_pipeline(gpu, fxaa_desc);
+
+		auto smaa_edges_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/smaa_edges.cs_6_4.cso"),
+			.sampler_count                   = 1,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.smaa_edges = sdl3::make_cmp_pipeline(gpu, smaa_edges_desc);
+
+		auto smaa_blend_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/smaa_blend.cs_6_4.cso"),
+			.sampler_count                   = 2,
+			.readwrite_storage_texture_count = 1,
+		};
+		fx.smaa_blend = sdl3::make_cmp_pipeline(gpu, smaa_blend_desc);
+
+		auto temporal_desc = sdl3::compute_desc{
+			.shader_binary                   = io::read_file("shaders/temporal_resolve.cs_6_4.cso"),
+			.sampler_count                   = 3,
+			.readwrite_storage_texture_count = 1,
+			.uniform_buffer_count            = 1,
+		};
+		fx.temporal_resolve = sdl3::make_cmp_pipeline(gpu, temporal_desc);
+
+		fx.linear_sampler = sdl3::make_sampler(gpu, sdl3::sampler_type::linear_clamp);
+
+		return fx;
+	}
+
+	void destroy_chain(chain &fx)
+	{
+		msg::info("Destroy Post Processing Chain.");
+
+		fx = {};
+	}
+
+	// Description for a target at fraction of output size, that compute shaders can write to
+	auto target_desc(const sdl3::frame_context &frm, SDL_GPUTextureFormat format, resolution_t res) -> sdl3::texture_desc
+	{
+		auto scale = static_cast<uint32_t>(res);
+
+		return {
+			.usage        = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE,
+			.format       = format,
+			.width        = std::max(frm.width / scale, 1u),
+			.height       = std::max(frm.height / scale, 1u),
+			.depth        = 1,
+			.mip_levels   = 1,
+			.sample_count = SDL_GPU_SAMPLECOUNT_1,
+		};
+	}
+
+	// Run compute shader over every texel of output, sampling all inputs with same sampler
+	void run_compute(SDL_GPUCommandBuffer *cmd_buf,
+	                 SDL_GPUComputePipeline *pipeline,
+	                 SDL_GPUSampler *sampler,
+	                 std::span<SDL_GPUTexture *const> inputs,
+	                 SDL_GPUTexture *output, const sdl3::texture_desc &output_desc,
+	                 io::byte_span uniforms)
+	{
+		constexpr auto GROUP_SIZE = 8u;
+
+		auto output_binding = SDL_GPUStorageTextureReadWriteBinding{
+			.texture = output,
+			.cycle   = true,
+		};
+
+		auto compute_pass = SDL_BeginGPUComputePass(cmd_buf, &output_binding, 1, nullptr, 0);
+		{
+			auto sampler_bindings = inputs
+			                      | std::views::transform([&](SDL_GPUTexture *input) {
+										return SDL_GPUTextureSamplerBinding{
+											.texture = input,
+											.sampler = sampler,
+										};
+									})
+			                      | std::ranges::to<std::vector>();
+
+			SDL_BindGPUComputePipeline(compute_pass, pipeline);
+			SDL_BindGPUComputeSamplers(compute_pass, 0, sampler_bindings.data(), static_cast<uint32_t>(sampler_bindings.size()));
+
+			if (not uniforms.empty())
+			{
+				SDL_PushGPUComputeUniformData(cmd_buf, 0, uniforms.data(), static_cast<uint32_t>(uniforms.size()));
+			}
+
+			SDL_DispatchGPUCompute(compute_pass,
+			                       (output_desc.width + GROUP_SIZE - 1) / GROUP_SIZE,
+			                       (output_desc.height + GROUP_SIZE - 1) / GROUP_SIZE,
+			                       1);
+		}
+		SDL_EndGPUComputePass(compute_pass);
+	}
+
+	// Scale source texture on to whole swapchain image
+	void blit_to_swapchain(const sdl3::frame_context &frm, SDL_GPUTexture *source, uint32_t width, uint32_t height)
+	{
+		auto blit_info = SDL_GPUBlitInfo{
+			.source = {
+			  .texture = source,
+			  .w       = width,
+			  .h       = height,
+			},
+			.destination = {
+			  .texture = frm.swapchain,
+			  .w       = frm.width,
+			  .h       = frm.height,
+			},
+			.load_op = SDL_GPU_LOADOP_DONT_CARE,
+			.filter  = SDL_GPU_FILTER_LINEAR,
+		};
+		SDL_BlitGPUTexture(frm.cmd_buf, &blit_info);
+	}
+
+	// Bright parts of scene, downsampled and blurred at half and quarter resolution
+	auto apply_bloom(sdl3::frame_context &frm, chain &fx, SDL_GPUTexture *scene_color) -> SDL_GPUTexture *
+	{
+		auto half_desc    = target_desc(frm, BLOOM_FORMAT, resolution_t::half);
+		auto quarter_desc = target_desc(frm, BLOOM_FORMAT, resolution_t::quarter);
+
+		auto half      = acquire_target(frm.gpu, fx.targets, half_desc);
+		auto quarter_h = acquire_target(frm.gpu, fx.targets, quarter_desc);
+		auto quarter_v = acquire_target(frm.gpu, fx.targets, quarter_desc);
+
+		auto params = bloom_params{
+			.threshold = fx.config.bloom_threshold,
+			.knee      = fx.config.bloom_knee,
+		};
+
+		// Threshold + downsample to half
+		run_compute(frm.cmd_buf, fx.bloom_prefilter.get(), fx.linear_sampler.get(),
+		            std::array{ scene_color }, half, half_desc, io::as_byte_span(params));
+
+		// Downsample to quarter merged with horizontal blur
+		params.direction = { 1.0f, 0.0f };
+		run_compute(frm.cmd_buf, fx.bloom_blur.get(), fx.linear_sampler.get(),
+		            std::array{ half }, quarter_h, quarter_desc, io::as_byte_span(params));
+
+		// Vertical blur
+		params.direction = { 0.0f, 1.0f };
+		run_compute(frm.cmd_buf, fx.bloom_blur.get(), fx.linear_sampler.get(),
+		            std::array{ quarter_h }, quarter_v, quarter_desc, io::as_byte_span(params));
+
+		return quarter_v;
+	}
+
+	// FXAA, or SMAA edge detection then blend, on tone mapped image
+	auto apply_antialiasing(sdl3::frame_context &frm, chain &fx, SDL_GPUTexture *ldr, const sdl3::texture_desc &ldr_desc) -> SDL_GPUTexture *
+	{
+		auto &cfg   = fx.config;
+		auto output = acquire_target(frm.gpu, fx.targets, ldr_desc);
+
+		auto params = antialias_params{
+			.fxaa_edge_threshold     = cfg.fxaa_edge_threshold,
+			.fxaa_edge_threshold_min = cfg.fxaa_edge_threshold_min,
+			.fxaa_subpixel           = cfg.fxaa_subpixel,
+			.smaa_threshold          = cfg.smaa_threshold,
+		};
+
+		if (cfg.antialiasing == antialiasing_t::fxaa)
+		{
+			run_compute(frm.cmd_buf, fx.fxaa.get(), fx.linear_sampler.get(),
+			            std::array{ ldr }, output, ldr_desc, io::as_byte_span(params));
+			return output;
+		}
+
+		auto edges = acquire_target(frm.gpu, fx.targets, ldr_desc);
+		run_compute(frm.cmd_buf, fx.smaa_edges.get(), fx.linear_sampler.get(),
+		            std::array{ ldr }, edges, ldr_desc, io::as_byte_span(params));
+		run_compute(frm.cmd_buf, fx.smaa_blend.get(), fx.linear_sampler.get(),
+		            std::array{ ldr, edges }, output, ldr_desc, {});
+		return output;
+	}
+
+	// Jittered scene and it's motion, blended with reprojected history, in to output size HDR image
+	auto apply_temporal(sdl3::frame_context &frm, chain &fx, const sdl3::scene &scn) -> SDL_GPUTexture *
+	{
+		auto &hist = fx.history;
+
+		// Made again when output size changes, old results don't line up with new pixels
+		auto desc = target_desc(frm, HISTORY_FORMAT, resolution_t::full);
+		if (hist.textures[0] == nullptr or hist.desc != desc)
+		{
+			hist.desc        = desc;
+			hist.textures[0] = sdl3::make_texture(frm.gpu, desc, "Temporal History Texture"sv);
+			hist.textures[1] = sdl3::make_texture(frm.gpu, desc, "Temporal History Texture"sv);
+			hist.valid       = false;
+		}
+
+		hist.current  = 1 - hist.current;
+		auto output   = hist.textures[hist.current].get();
+		auto previous = hist.textures[1 - hist.current].get();
+
+		auto params = temporal_params{
+			.jitter         = scn.temporal.jitter,
+			.current_weight = fx.config.taa_current_weight,
+			.history_valid  = hist.valid ? 1u : 0u,
+		};
+		run_compute(frm.cmd_buf, fx.temporal_resolve.get(), fx.linear_sampler.get(),
+		            std::array{ scn.color_texture.get(), scn.motion_texture.get(), previous },
+		            output, desc, io::as_byte_span(params));
+
+		hist.valid = true;
+		return output;
+	}
+
+	// Run all enabled effects on scene color, and write result in to swapchain image
+	void apply(sdl3::frame_context &frm, chain &fx, const sdl3::scene &scn)
+	{
+		auto &cfg = fx.config;
+
+		auto post_aa = is_post_process(cfg.antialiasing);
+
+		// Temporal upscaling brings scene to output size, otherwise tone map or blit stretch it there
+		auto scene_color = scn.color_texture.get();
+		auto scene_w     = scn.width;
+		auto scene_h     = scn.height;
+		auto temporal    = cfg.antialiasing == antialiasing_t::taa
+		              and scn.temporal.enabled and scn.temporal.valid
+		              and scn.motion_texture != nullptr;
+		if (temporal)
+		{
+			scene_color = apply_temporal(frm, fx, scn);
+			scene_w     = frm.width;
+			scene_h     = frm.height;
+		}
+		else
+		{
+			fx.history.valid = false;
+		}
+
+		// Anti-aliasing runs on tone mapped image, so it still needs tone map pass to clamp scene color
+		if (not(cfg.bloom or cfg.tonemap or cfg.color_grading or post_aa))
+		{
+			blit_to_swapchain(frm, scene_color, scene_w, scene_h);
+			recycle_targets(fx.targets);
+			return;
+		}
+
+		// Tone map pass always needs a bloom input, scene color with zero intensity when bloom is off
+		auto bloom           = scene_color;
+		auto bloom_intensity = 0.0f;
+		if (cfg.bloom)
+		{
+			bloom           = apply_bloom(frm, fx, scene_color);
+			bloom_intensity = cfg.bloom_intensity;
+		}
+
+		auto ldr_desc = target_desc(frm, LDR_FORMAT, resolution_t::full);
+		auto ldr      = acquire_target(frm.gpu, fx.targets, ldr_desc);
+
+		auto params = tone_params{
+			.exposure        = cfg.exposure,
+			.bloom_intensity = bloom_intensity,
+			.saturation      = cfg.saturation,
+			.contrast        = cfg.contrast,
+			.tonemap         = cfg.tonemap ? 1u : 0u,
+			.grade           = cfg.color_grading ? 1u : 0u,
+		};
+		run_compute(frm.cmd_buf, fx.tonemap_grade.get(), fx.linear_sampler.get(),
+		            std::array{ scene_color, bloom }, ldr, ldr_desc, io::as_byte_span(params));
+
+		if (post_aa)
+		{
+			ldr = apply_antialiasing(frm, fx, ldr, ldr_desc);
+		}
+
+		blit_to_swapchain(frm, ldr, ldr_desc.width, ldr_desc.height);
+
+		recycle_targets(fx.targets);
+	}
+}
@@ -17,7 +17,34 @@ export namespace sdl3
 {
 	constexpr auto DEPTH_FORMAT   = SDL_GPU_TEXTUREFORMAT_D24_UNORM_S8_UINT;
 	constexpr auto MAX_ANISOTROPY = float{ 16 };
-	constexpr auto MSAA           = SDL_GPU_SAMPLECOUNT_1;
+
+	// Scene is drawn in to HDR target, post processing resolves it to swapchain
+	constexpr auto SCENE_COLOR_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+	// Pipeline color format placeholder, for pipelines that draw directly in to swapchain
+	constexpr auto SWAPCHAIN_FORMAT = SDL_GPU_TEXTUREFORMAT_INVALID;
+	// Stands in for swapchain in headless contexts, 8 bit RGBA so read back images can be encoded directly
+	constexpr auto OFFSCREEN_FORMAT = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+
+	// Weighted blended order-independent transparency targets
+	constexpr auto OIT_ACCUMULATION_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+	constexpr auto OIT_REVEALAGE_FORMAT    = SDL_GPU_TEXTUREFORMAT_R16_FLOAT;
+
+	// Screen space motion since last frame, in UV units, read by temporal upscaler
+	constexpr auto MOTION_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT;
+
+	// Staging memory available for per-frame uploads, sized for a full sprite batch plus scene data
+	constexpr auto UPLOAD_RING_CAPACITY  = uint32_t{ 32 * 1024 * 1024 };
+	constexpr auto UPLOAD_RING_ALIGNMENT = uint32_t{ 16 };
+
+	// Readbacks that can be waiting on GPU at once, each holds one download transfer buffer
+	constexpr auto DOWNLOAD_RING_SLOTS = uint32_t{ 8 };
+
+	// Per-draw constants, one slot of draws per frame, slots are reused once their frame is off GPU
+	constexpr auto MAX_DRAWS_PER_FRAME = uint32_t{ 16384 };
+	constexpr auto DRAW_RING_SLOTS     = uint32_t{ 3 };
+
+	// Bytes held by GPU buffers and textures created through this module, shown by performance overlay
+	auto gpu_memory_bytes = std::atomic<uint64_t>{ 0 };
 
 	// Deleter template, for use with SDL objects.
 	// Allows use of SDL Objects with C++'s smart pointers, using SDL's destroy function
@@ -26,14 +53,18 @@ export namespace sdl3
 	struct gpu_deleter
 	{
 		SDL_GPUDevice *gpu = nullptr;
-		constexpr void operator()(auto *arg)
+		uint64_t size      = 0; // bytes counted in gpu_memory_bytes, given back on release
+		void operator()(auto *arg)
 		{
+			gpu_memory_bytes -= size;
 			fn(gpu, arg);
 		}
 	};
 	// Typedefs for SDL objects that need GPU Device to properly destruct
 	using free_gfx_pipeline = gpu_deleter<SDL_ReleaseGPUGraphicsPipeline>;
 	using gfx_pipeline_ptr  = std::unique_ptr<SDL_GPUGraphicsPipeline, free_gfx_pipeline>;
+	using free_cmp_pipeline = gpu_deleter<SDL_ReleaseGPUComputePipeline>;
+	using cmp_pipeline_ptr  = std::unique_ptr<SDL_GPUComputePipeline, free_cmp_pipeline>;
 	using free_gfx_shader   = gpu_deleter<SDL_ReleaseGPUShader>;
 	using gpu_shader_ptr    = std::unique_ptr<SDL_GPUShader, free_gfx_shader>;
 	using free_buffer       = gpu_deleter<SDL_ReleaseGPUBuffer>;
@@ -42,6 +73,8 @@ export namespace sdl3
 	using gpu_texture_ptr   = std::unique_ptr<SDL_GPUTexture, free_texture>;
 	using free_sampler      = gpu_deleter<SDL_ReleaseGPUSampler>;
 	using gpu_sampler_ptr   = std::unique_ptr<SDL_GPUSampler, free_sampler>;
+	using free_transfer_buf = gpu_deleter<SDL_ReleaseGPUTransferBuffer>;
+	using gpu_transfer_ptr  = std::unique_ptr<SDL_GPUTransferBuffer, free_transfer_buf>;
 
 	struct shader_desc
 	{
@@ -53,16 +86,20 @@ export namespace sdl3
 		uint32_t storage_texture_count = 0;
 	};
 
-	auto make_gpu_shader(SDL_GPUDevice *gpu, const shader_desc &desc) -> gpu_shader_ptr
+	// Shader bytecode format GPU backend wants
+	auto get_shader_format(SDL_GPUDevice *gpu) -> SDL_GPUShaderFormat
 	{
-		auto shader_format = [&]() -> SDL_GPUShaderFormat {
-			auto backend_formats = SDL_GetGPUShaderFormats(gpu);
+		auto backend_formats = SDL_GetGPUShaderFormats(gpu);
 
-			if (backend_formats & SDL_GPU_SHADERFORMAT_DXIL)
-				return SDL_GPU_SHADERFORMAT_DXIL;
-			else
-				return SDL_GPU_SHADERFORMAT_SPIRV;
-		}();
+		if (backend_formats & SDL_GPU_SHADERFORMAT_DXIL)
+			return SDL_GPU_SHADERFORMAT_DXIL;
+		else
+			return SDL_GPU_SHADERFORMAT_SPIRV;
+	}
+
+	auto make_gpu_shader(SDL_GPUDevice *gpu, const shader_desc &desc) -> gpu_shader_ptr
+	{
+		auto shader_format = get_shader_format(gpu);
 
 		auto shader_info = SDL_GPUShaderCreateInfo{
 			.code_size            = desc.shader_binary.size(),
@@ -82,6 +119,46 @@ export namespace sdl3
 		return { shader, { gpu } };
 	}
 
+	struct compute_desc
+	{
+		io::byte_array shader_binary;
+		uint32_t sampler_count                   = 0;
+		uint32_t readonly_storage_texture_count  = 0;
+		uint32_t readonly_storage_buffer_count   = 0;
+		uint32_t readwrite_storage_texture_count = 0;
+		uint32_t readwrite_storage_buffer_count  = 0;
+		uint32_t uniform_buffer_count            = 0;
+		uint32_t threadcount_x                   = 8;
+		uint32_t threadcount_y                   = 8;
+		uint32_t threadcount_z                   = 1;
+	};
+
+	auto make_cmp_pipeline(SDL_GPUDevice *gpu, const compute_desc &desc) -> cmp_pipeline_ptr
+	{
+		msg::info("Creating Compute Pipeline.");
+
+		auto pipeline_info = SDL_GPUComputePipelineCreateInfo{
+			.code_size                      = desc.shader_binary.size(),
+			.code                           = reinterpret_cast<const uint8_t *>(desc.shader_binary.data()),
+			.entrypoint                     = "main",
+			.format                         = get_shader_format(gpu),
+			.num_samplers                   = desc.sampler_count,
+			.num_readonly_storage_textures  = desc.readonly_storage_texture_count,
+			.num_readonly_storage_buffers   = desc.readonly_storage_buffer_count,
+			.num_readwrite_storage_textures = desc.readwrite_storage_texture_count,
+			.num_readwrite_storage_buffers  = desc.readwrite_storage_buffer_count,
+			.num_uniform_buffers            = desc.uniform_buffer_count,
+			.threadcount_x                  = desc.threadcount_x,
+			.threadcount_y                  = desc.threadcount_y,
+			.threadcount_z                  = desc.threadcount_z,
+		};
+
+		auto pl = SDL_CreateGPUComputePipeline(gpu, &pipeline_info);
+		msg::error(pl != nullptr, "Failed to create compute pipeline.");
+
+		return { pl, { gpu } };
+	}
+
 	enum class cull_mode_t
 	{
 		none,
@@ -91,6 +168,20 @@ export namespace sdl3
 		back_cw,
 	};
 
+	enum class blend_mode_t
+	{
+		none,         // opaque, no framebuffer read
+		alpha,        // src_alpha, one_minus_src_alpha
+		weighted_oit, // writes accumulation and revealage targets, instead of color target
+	};
+
+	// Opaque draws go first front-to-back, transparent draws after sorted back-to-front
+	enum class render_queue_t
+	{
+		opaque,
+		transparent,
+	};
+
 	struct pipeline_desc
 	{
 		shader_desc vertex;
@@ -101,6 +192,44 @@ export namespace sdl3
 
 		bool depth_test;
 		cull_mode_t cull_mode = cull_mode_t::back_ccw;
+
+		// Depth state, main pass uses EQUAL without writes when depth prepass is enabled
+		SDL_GPUCompareOp depth_compare = SDL_GPU_COMPAREOP_LESS;
+		bool depth_write               = true;
+
+		// Pipeline only writes depth, color writes are masked off
+		bool depth_only = false;
+
+		// Transparent queue never writes depth, so it doesn't hide what's behind it
+		blend_mode_t blend_mode = blend_mode_t::none;
+		render_queue_t queue    = render_queue_t::opaque;
+
+		// Format of color target pipeline draws in to
+		SDL_GPUTextureFormat color_format = SCENE_COLOR_FORMAT;
+
+		SDL_GPUPrimitiveType primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+	};
+
+	// Order of pipelines in scene::pipelines, pipeline_desc list must be in same order
+	enum class pipeline_id : uint8_t
+	{
+		textured_mesh,
+		grid,
+		depth_prepass,
+		textured_mesh_depth_equal,
+		transparent_mesh,
+		transparent_mesh_oit,
+		oit_composite,
+		procedural_mesh,
+		camera_motion,
+		procedural_motion,
+	};
+
+	// How transparent queue is drawn
+	enum class transparency_mode_t
+	{
+		sorted,       // back-to-front sorted, alpha blended
+		weighted_oit, // unsorted, weighted blended order-independent transparency
 	};
 
 	auto make_gfx_pipeline(const context &ctx, const pipeline_desc &desc) -> gfx_pipeline_ptr
@@ -162,30 +291,91 @@ export namespace sdl3
 		if (desc.depth_test)
 		{
 			depth_stencil_state = SDL_GPUDepthStencilState{
-				.compare_op          = SDL_GPU_COMPAREOP_LESS,
+				.compare_op          = desc.depth_compare,
 				.write_mask          = std::numeric_limits<uint8_t>::max(),
 				.enable_depth_test   = true,
-				.enable_depth_write  = true,
+				.enable_depth_write  = desc.depth_write and desc.queue == render_queue_t::opaque,
 				.enable_stencil_test = false,
 			};
 		}
 
-		auto blend_state = SDL_GPUColorTargetBlendState{
-			.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
-			.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
-			.color_blend_op        = SDL_GPU_BLENDOP_ADD,
-			.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
-			.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO,
-			.alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
-			.enable_blend          = true,
-		};
+		auto blend_state = [&]() -> SDL_GPUColorTargetBlendState {
+			switch (desc.blend_mode)
+			{
+				using bm = blend_mode_t;
+			case bm::none:
+				return {
+					.enable_blend = false,
+				};
+			case bm::alpha:
+				return {
+					.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+					.color_blend_op        = SDL_GPU_BLENDOP_ADD,
+					.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+					.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO,
+					.alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
+					.enable_blend          = true,
+				};
+			case bm::weighted_oit: // for accumulation target
+				return {
+					.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+					.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+					.color_blend_op        = SDL_GPU_BLENDOP_ADD,
+					.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+					.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+					.alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
+					.enable_blend          = true,
+				};
+			}
+			msg::error(false, "Unhandled Blend Mode case.");
+			return {};
+		}();
+
+		// Depth only pipelines keep the color target, so they are compatible with the render pass,
+		// but do not write to it
+		if (desc.depth_only)
+		{
+			blend_state = SDL_GPUColorTargetBlendState{
+				.color_write_mask        = 0,
+				.enable_blend            = false,
+				.enable_color_write_mask = true,
+			};
+		}
+
+		auto color_targets = std::vector<SDL_GPUColorTargetDescription>{};
+		if (desc.blend_mode == blend_mode_t::weighted_oit)
+		{
+			// revealage is multiplied by (1 - alpha) of every fragment
+			auto revealage_blend_state = SDL_GPUColorTargetBlendState{
+				.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ZERO,
+				.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_COLOR,
+				.color_blend_op        = SDL_GPU_BLENDOP_ADD,
+				.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO,
+				.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+				.alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
+				.enable_blend          = true,
+			};
 
-		auto color_targets = std::array{
-			SDL_GPUColorTargetDescription{
-			  .format      = SDL_GetGPUSwapchainTextureFormat(gpu, wnd),
+			color_targets.push_back({
+			  .format      = OIT_ACCUMULATION_FORMAT,
 			  .blend_state = blend_state,
-			},
-		};
+			});
+			color_targets.push_back({
+			  .format      = OIT_REVEALAGE_FORMAT,
+			  .blend_state = revealage_blend_state,
+			});
+		}
+		else
+		{
+			auto swapchain_format = (wnd != nullptr) ? SDL_GetGPUSwapchainTextureFormat(gpu, wnd) : OFFSCREEN_FORMAT;
+			auto color_format     = (desc.color_format == SWAPCHAIN_FORMAT) ? swapchain_format : desc.color_format;
+
+			color_targets.push_back({
+			  .format      = color_format,
+			  .blend_state = blend_state,
+			});
+		}
 
 		auto target_info = SDL_GPUGraphicsPipelineTargetInfo{
 			.color_target_descriptions = color_targets.data(),
@@ -194,12 +384,18 @@ export namespace sdl3
 			.has_depth_stencil_target  = desc.depth_test,
 		};
 
+		// Scene targets are multisampled when context asks for MSAA, swapchain never is
+		auto multisample_state = SDL_GPUMultisampleState{
+			.sample_count = (desc.color_format == SWAPCHAIN_FORMAT) ? SDL_GPU_SAMPLECOUNT_1 : ctx.msaa,
+		};
+
 		auto pipeline_info = SDL_GPUGraphicsPipelineCreateInfo{
 			.vertex_shader       = vs_shdr.get(),
 			.fragment_shader     = fs_shdr.get(),
 			.vertex_input_state  = vertex_input_state,
-			.primitive_type      = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+			.primitive_type      = desc.primitive_type,
 			.rasterizer_state    = rasterizer_state,
+			.multisample_state   = multisample_state,
 			.depth_stencil_state = depth_stencil_state,
 			.target_info         = target_info,
 		};
@@ -226,7 +422,354 @@ export namespace sdl3
 			SDL_SetGPUBufferName(gpu, buffer, name.data());
 		}
 
-		return { buffer, { gpu } };
+		gpu_memory_bytes += size;
+		return { buffer, { gpu, size } };
+	}
+
+	// Per-frame staging memory for buffer uploads.
+	// Transfer buffer is mapped with cycling, so SDL swaps in a fresh one while previous frame is still in flight.
+	struct upload_ring
+	{
+		struct pending_copy
+		{
+			uint32_t src_offset;
+			SDL_GPUBuffer *buffer;
+			uint32_t dst_offset;
+			uint32_t size;
+			bool cycle;
+		};
+
+		gpu_transfer_ptr transfer_buffer;
+		uint32_t capacity = 0;
+		uint32_t head     = 0;
+		std::byte *mapped = nullptr;
+		std::vector<pending_copy> copies;
+	};
+
+	auto make_upload_ring(SDL_GPUDevice *gpu, uint32_t capacity) -> upload_ring
+	{
+		msg::info(std::format("Create upload ring. {}", capacity));
+
+		auto transfer_info = SDL_GPUTransferBufferCreateInfo{
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size  = capacity,
+		};
+		auto transfer_buffer = SDL_CreateGPUTransferBuffer(gpu, &transfer_info);
+		msg::error(transfer_buffer != nullptr, "Failed to create upload ring transfer buffer.");
+
+		gpu_memory_bytes += capacity;
+		return {
+			.transfer_buffer = { transfer_buffer, { gpu, capacity } },
+			.capacity        = capacity,
+		};
+	}
+
+	// Reserve space in this frame's staging memory, and queue a copy of it to destination buffer.
+	// Caller writes directly in to returned span, it is empty if ring is out of space.
+	// cycle should be true when whole buffer is rewritten every frame.
+	auto reserve_upload(SDL_GPUDevice *gpu, upload_ring &ring, uint32_t size, SDL_GPUBuffer *buffer, uint32_t dst_offset, bool cycle) -> std::span<std::byte>
+	{
+		auto offset = (ring.head + UPLOAD_RING_ALIGNMENT - 1) & ~(UPLOAD_RING_ALIGNMENT - 1);
+		if (size == 0 or offset + size > ring.capacity)
+		{
+			msg::error(size == 0, "Upload ring is out of space this frame.");
+			return {};
+		}
+
+		if (ring.mapped == nullptr)
+		{
+			ring.mapped = static_cast<std::byte *>(SDL_MapGPUTransferBuffer(gpu, ring.transfer_buffer.get(), true));
+			msg::error(ring.mapped != nullptr, "Failed to map upload ring.");
+		}
+
+		ring.copies.push_back({
+		  .src_offset = offset,
+		  .buffer     = buffer,
+		  .dst_offset = dst_offset,
+		  .size       = size,
+		  .cycle      = cycle,
+		});
+		ring.head = offset + size;
+
+		return { ring.mapped + offset, size };
+	}
+
+	// Copy data in to this frame's staging memory, and queue a copy to destination buffer
+	auto stage_upload(SDL_GPUDevice *gpu, upload_ring &ring, io::byte_span data, SDL_GPUBuffer *buffer, uint32_t dst_offset, bool cycle) -> bool
+	{
+		auto dst = reserve_upload(gpu, ring, static_cast<uint32_t>(data.size()), buffer, dst_offset, cycle);
+		if (dst.empty())
+			return false;
+
+		std::memcpy(dst.data(), data.data(), data.size());
+		return true;
+	}
+
+	// Record all queued copies in to copy pass, and reset ring for next frame
+	void flush_uploads(SDL_GPUDevice *gpu, upload_ring &ring, SDL_GPUCopyPass *copy_pass)
+	{
+		if (ring.mapped != nullptr)
+		{
+			SDL_UnmapGPUTransferBuffer(gpu, ring.transfer_buffer.get());
+		}
+
+		for (auto &&copy : ring.copies)
+		{
+			auto src = SDL_GPUTransferBufferLocation{
+				.transfer_buffer = ring.transfer_buffer.get(),
+				.offset          = copy.src_offset,
+			};
+			auto dst = SDL_GPUBufferRegion{
+				.buffer = copy.buffer,
+				.offset = copy.dst_offset,
+				.size   = copy.size,
+			};
+			SDL_UploadToGPUBuffer(copy_pass, &src, &dst, copy.cycle);
+		}
+
+		ring.copies.clear();
+		ring.head   = 0;
+		ring.mapped = nullptr;
+	}
+
+	// Constants of one draw, layout matches DrawData in HLSL
+	struct draw_data
+	{
+		std::array<float, 16> transform; // column major
+		uint32_t material;
+		uint32_t lod; // level of detail picked on CPU, for shaders that have more than one
+		std::array<uint32_t, 2> padding;
+	};
+
+	// Per-draw constants in a storage buffer, indexed in vertex shader by draw id, so draws need no uniform pushes.
+	// SV_InstanceID restarts at 0 for every draw on D3D12, so draw id comes from first_instance instead,
+	// through an instance rate vertex buffer holding 0, 1, 2... which is read starting at first_instance.
+	struct draw_ring
+	{
+		gpu_buffer_ptr buffer;   // DRAW_RING_SLOTS * MAX_DRAWS_PER_FRAME draw_data
+		gpu_buffer_ptr draw_ids; // uint32 per draw, it's own index
+		uint32_t slot = 0;       // slot next frame's draws go in to
+	};
+
+	// This frame's draws, draw i is drawn with first_instance of first_draw + i
+	struct draw_batch
+	{
+		std::span<draw_data> draws;
+		uint32_t first_draw;
+	};
+
+	auto make_draw_ring(SDL_GPUDevice *gpu, upload_ring &uploads) -> draw_ring
+	{
+		constexpr auto DRAW_COUNT = DRAW_RING_SLOTS * MAX_DRAWS_PER_FRAME;
+
+		auto ring = draw_ring{
+			.buffer   = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, DRAW_COUNT * sizeof(draw_data), "Draw Ring Buffer"sv),
+			.draw_ids = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, DRAW_COUNT * sizeof(uint32_t), "Draw Id Buffer"sv),
+		};
+
+		auto ids = std::views::iota(0u, DRAW_COUNT) | std::ranges::to<std::vector>();
+		stage_upload(gpu, uploads, io::as_byte_span(ids), ring.draw_ids.get(), 0, false);
+
+		return ring;
+	}
+
+	// Reserve this frame's draws in next ring slot, caller fills returned span in place.
+	// Copy to storage buffer goes with rest of frame's uploads.
+	// Span is shorter than count, or empty, when slot or upload ring can't hold them all, so draw only what it holds.
+	auto reserve_draws(SDL_GPUDevice *gpu, upload_ring &uploads, draw_ring &ring, uint32_t count) -> draw_batch
+	{
+		msg::error(count <= MAX_DRAWS_PER_FRAME, "Too many draws for draw ring.");
+		count = std::min(count, MAX_DRAWS_PER_FRAME);
+
+		auto first_draw = ring.slot * MAX_DRAWS_PER_FRAME;
+		ring.slot       = (ring.slot + 1) % DRAW_RING_SLOTS;
+
+		// Slot isn't read by frames still in flight, so no cycle
+		auto dst = reserve_upload(gpu, uploads, count * sizeof(draw_data), ring.buffer.get(), first_draw * sizeof(draw_data), false);
+		return {
+			.draws      = { reinterpret_cast<draw_data *>(dst.data()), dst.size() / sizeof(draw_data) },
+			.first_draw = first_draw,
+		};
+	}
+
+	// Bind draw ring for pipelines that read draw ids from vertex buffer slot and draw data from vertex storage buffer 0
+	void bind_draw_ring(SDL_GPURenderPass *render_pass, const draw_ring &ring, uint32_t id_slot)
+	{
+		auto id_binding = SDL_GPUBufferBinding{
+			.buffer = ring.draw_ids.get(),
+			.offset = 0,
+		};
+		SDL_BindGPUVertexBuffers(render_pass, id_slot, &id_binding, 1);
+
+		auto storage = ring.buffer.get();
+		SDL_BindGPUVertexStorageBuffers(render_pass, 0, &storage, 1);
+	}
+
+	// Data copied back from GPU, for screenshots, feedback buffers and statistics
+	struct readback
+	{
+		uint64_t frame_index;        // frame whose commands produced this data
+		SDL_GPUTextureFormat format; // SDL_GPU_TEXTUREFORMAT_INVALID for buffer readbacks
+		uint32_t width;
+		uint32_t height;
+		io::byte_array data; // tightly packed rows for textures
+	};
+
+	// Reusable download transfer buffers.
+	// Copies are recorded at end of frame, after all draws, and results are delivered once that frame's fence signals.
+	struct download_ring
+	{
+		struct slot
+		{
+			gpu_transfer_ptr transfer_buffer;
+			uint32_t capacity = 0;
+			bool busy         = false;
+		};
+
+		struct request
+		{
+			uint32_t slot;
+			uint32_t size;
+			uint64_t frame_index;
+			SDL_GPUTextureRegion texture_region; // texture is null for buffer readbacks
+			SDL_GPUBufferRegion buffer_region;
+			SDL_GPUTextureFormat format;
+			std::promise<readback> result;
+		};
+
+		std::array<slot, DOWNLOAD_RING_SLOTS> slots;
+		std::vector<request> queued;   // recorded by end of this frame
+		std::deque<request> in_flight; // waiting on frame fence, oldest first
+	};
+
+	// Free slot that fits size, growing one if none do. Empty if all slots are waiting on GPU.
+	auto acquire_download_slot(SDL_GPUDevice *gpu, download_ring &ring, uint32_t size) -> std::optional<uint32_t>
+	{
+		auto is_free = [](const download_ring::slot &s) { return not s.busy; };
+		auto fits    = [&](const download_ring::slot &s) { return not s.busy and s.capacity >= size; };
+
+		auto it = std::ranges::find_if(ring.slots, fits);
+		if (it == ring.slots.end())
+		{
+			it = std::ranges::find_if(ring.slots, is_free);
+			if (it == ring.slots.end())
+				return std::nullopt;
+
+			auto capacity      = std::bit_ceil(size);
+			auto transfer_info = SDL_GPUTransferBufferCreateInfo{
+				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
+				.size  = capacity,
+			};
+			auto transfer_buffer = SDL_CreateGPUTransferBuffer(gpu, &transfer_info);
+			msg::error(transfer_buffer != nullptr, "Failed to create download transfer buffer.");
+			if (transfer_buffer == nullptr)
+				return std::nullopt;
+
+			gpu_memory_bytes += capacity;
+			it->transfer_buffer = { transfer_buffer, { gpu, capacity } };
+			it->capacity        = capacity;
+		}
+
+		it->busy = true;
+		return static_cast<uint32_t>(std::distance(ring.slots.begin(), it));
+	}
+
+	// Queue copy of texture region, it's contents at end of current frame are returned.
+	// Returned future is not valid if every slot is still waiting on GPU.
+	auto readback_texture(SDL_GPUDevice *gpu, download_ring &ring, const SDL_GPUTextureRegion &region, SDL_GPUTextureFormat format) -> std::future<readback>
+	{
+		auto size = SDL_CalculateGPUTextureFormatSize(format, region.w, region.h, std::max(region.d, 1u));
+		auto slot = acquire_download_slot(gpu, ring, size);
+		msg::error(slot.has_value(), "Download ring is out of slots.");
+		if (not slot)
+			return {};
+
+		auto &req = ring.queued.emplace_back(download_ring::request{
+		  .slot           = *slot,
+		  .size           = size,
+		  .texture_region = region,
+		  .format         = format,
+		});
+		return req.result.get_future();
+	}
+
+	// Queue copy of buffer region, it's contents at end of current frame are returned.
+	// Returned future is not valid if every slot is still waiting on GPU.
+	auto readback_buffer(SDL_GPUDevice *gpu, download_ring &ring, const SDL_GPUBufferRegion &region) -> std::future<readback>
+	{
+		auto slot = acquire_download_slot(gpu, ring, region.size);
+		msg::error(slot.has_value(), "Download ring is out of slots.");
+		if (not slot)
+			return {};
+
+		auto &req = ring.queued.emplace_back(download_ring::request{
+		  .slot          = *slot,
+		  .size          = region.size,
+		  .buffer_region = region,
+		  .format        = SDL_GPU_TEXTUREFORMAT_INVALID,
+		});
+		return req.result.get_future();
+	}
+
+	// Record queued downloads in to copy pass, they wait on frame_index's fence from here
+	void record_downloads(download_ring &ring, SDL_GPUCopyPass *copy_pass, uint64_t frame_index)
+	{
+		for (auto &&req : ring.queued)
+		{
+			auto dst_buffer = ring.slots.at(req.slot).transfer_buffer.get();
+
+			if (req.texture_region.texture != nullptr)
+			{
+				auto dst = SDL_GPUTextureTransferInfo{
+					.transfer_buffer = dst_buffer,
+					.offset          = 0,
+				};
+				SDL_DownloadFromGPUTexture(copy_pass, &req.texture_region, &dst);
+			}
+			else
+			{
+				auto dst = SDL_GPUTransferBufferLocation{
+					.transfer_buffer = dst_buffer,
+					.offset          = 0,
+				};
+				SDL_DownloadFromGPUBuffer(copy_pass, &req.buffer_region, &dst);
+			}
+
+			req.frame_index = frame_index;
+			ring.in_flight.push_back(std::move(req));
+		}
+		ring.queued.clear();
+	}
+
+	// Deliver downloads of frames that finished on GPU, never waits.
+	// completed_count comes from frame_timeline, so call after poll_timeline.
+	void resolve_downloads(SDL_GPUDevice *gpu, download_ring &ring, uint64_t completed_count)
+	{
+		while (not ring.in_flight.empty() and ring.in_flight.front().frame_index < completed_count)
+		{
+			auto &req  = ring.in_flight.front();
+			auto &slot = ring.slots.at(req.slot);
+
+			auto result = readback{
+				.frame_index = req.frame_index,
+				.format      = req.format,
+				.width       = (req.texture_region.texture != nullptr) ? req.texture_region.w : req.size,
+				.height      = (req.texture_region.texture != nullptr) ? req.texture_region.h : 1,
+				.data        = io::byte_array(req.size),
+			};
+
+			auto mapped = SDL_MapGPUTransferBuffer(gpu, slot.transfer_buffer.get(), false);
+			msg::error(mapped != nullptr, "Failed to map download transfer buffer.");
+			if (mapped != nullptr)
+			{
+				std::memcpy(result.data.data(), mapped, req.size);
+				SDL_UnmapGPUTransferBuffer(gpu, slot.transfer_buffer.get());
+			}
+
+			req.result.set_value(std::move(result));
+			slot.busy = false;
+			ring.in_flight.pop_front();
+		}
 	}
 
 	struct texture_desc
@@ -237,7 +780,9 @@ export namespace sdl3
 		uint32_t height;
 		uint32_t depth;
 		uint32_t mip_levels;
-		SDL_GPUSampleCount sample_count = MSAA;
+		SDL_GPUSampleCount sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+		auto operator==(const texture_desc &) const -> bool = default;
 	};
 
 	auto make_texture(SDL_GPUDevice *gpu, const texture_desc &desc, std::string_view name = ""sv) -> gpu_texture_ptr
@@ -263,7 +808,115 @@ export namespace sdl3
 			SDL_SetGPUTextureName(gpu, texture, name.data());
 		}
 
-		return { texture, { gpu } };
+		// Every mip level, times samples per texel
+		auto size = uint64_t{ 0 };
+		for (auto mip : std::views::iota(0u, desc.mip_levels))
+		{
+			size += SDL_CalculateGPUTextureFormatSize(desc.format,
+			                                          std::max(desc.width >> mip, 1u),
+			                                          std::max(desc.height >> mip, 1u),
+			                                          desc.depth);
+		}
+		size <<= static_cast<uint32_t>(desc.sample_count);
+
+		gpu_memory_bytes += size;
+		return { texture, { gpu, size } };
+	}
+
+	// Highest sample count, up to requested, that every multisampled scene target format supports
+	auto supported_msaa(SDL_GPUDevice *gpu, SDL_GPUSampleCount requested) -> SDL_GPUSampleCount
+	{
+		constexpr auto FORMATS = std::array{ SCENE_COLOR_FORMAT, DEPTH_FORMAT, OIT_ACCUMULATION_FORMAT, OIT_REVEALAGE_FORMAT };
+
+		auto count = requested;
+		while (count != SDL_GPU_SAMPLECOUNT_1)
+		{
+			auto supported = std::ranges::all_of(FORMATS, [&](auto format) {
+				return SDL_GPUTextureSupportsSampleCount(gpu, format, count);
+			});
+			if (supported)
+				break;
+
+			count = static_cast<SDL_GPUSampleCount>(count - 1);
+		}
+		return count;
+	}
+
+	// Copy pixels in to first mip level of 2D texture, using a one off transfer buffer
+	void upload_texture(SDL_GPUDevice *gpu, SDL_GPUTexture *texture, io::byte_span pixels, uint32_t width, uint32_t height)
+	{
+		msg::info(std::format("Upload texture. {}x{}", width, height));
+
+		auto transfer_info = SDL_GPUTransferBufferCreateInfo{
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size  = static_cast<uint32_t>(pixels.size()),
+		};
+		auto transfer_buffer = SDL_CreateGPUTransferBuffer(gpu, &transfer_info);
+		msg::error(transfer_buffer != nullptr, "Failed to create gpu transfer buffer.");
+
+		auto data = SDL_MapGPUTransferBuffer(gpu, transfer_buffer, false);
+		std::memcpy(data, pixels.data(), pixels.size());
+		SDL_UnmapGPUTransferBuffer(gpu, transfer_buffer);
+
+		auto copy_cmd  = SDL_AcquireGPUCommandBuffer(gpu);
+		auto copy_pass = SDL_BeginGPUCopyPass(copy_cmd);
+		{
+			auto src = SDL_GPUTextureTransferInfo{
+				.transfer_buffer = transfer_buffer,
+				.offset          = 0,
+			};
+			auto dst = SDL_GPUTextureRegion{
+				.texture = texture,
+				.w       = width,
+				.h       = height,
+				.d       = 1,
+			};
+			SDL_UploadToGPUTexture(copy_pass, &src, &dst, false);
+		}
+		SDL_EndGPUCopyPass(copy_pass);
+		SDL_SubmitGPUCommandBuffer(copy_cmd);
+		SDL_ReleaseGPUTransferBuffer(gpu, transfer_buffer);
+	}
+
+	// Copy every layer and mip level of image in to texture, using a one off transfer buffer
+	void upload_image(SDL_GPUDevice *gpu, SDL_GPUTexture *texture, const io::image_data &image)
+	{
+		msg::info(std::format("Upload image. {}x{}", image.header.width, image.header.height));
+
+		auto transfer_info = SDL_GPUTransferBufferCreateInfo{
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size  = static_cast<uint32_t>(image.data.size()),
+		};
+		auto transfer_buffer = SDL_CreateGPUTransferBuffer(gpu, &transfer_info);
+		msg::error(transfer_buffer != nullptr, "Failed to create gpu transfer buffer.");
+
+		auto data = SDL_MapGPUTransferBuffer(gpu, transfer_buffer, false);
+		std::memcpy(data, image.data.data(), image.data.size());
+		SDL_UnmapGPUTransferBuffer(gpu, transfer_buffer);
+
+		auto copy_cmd  = SDL_AcquireGPUCommandBuffer(gpu);
+		auto copy_pass = SDL_BeginGPUCopyPass(copy_cmd);
+		for (auto &&sub_image : image.sub_images)
+		{
+			auto src = SDL_GPUTextureTransferInfo{
+				.transfer_buffer = transfer_buffer,
+				.offset          = static_cast<uint32_t>(sub_image.offset),
+			};
+
+			auto dst = SDL_GPUTextureRegion{
+				.texture   = texture,
+				.mip_level = sub_image.mipmap_index,
+				.layer     = sub_image.layer_index,
+				.w         = sub_image.width,
+				.h         = sub_image.height,
+				.d         = 1,
+			};
+
+			SDL_UploadToGPUTexture(copy_pass, &src, &dst, false);
+		}
+		SDL_EndGPUCopyPass(copy_pass);
+		SDL_SubmitGPUCommandBuffer(copy_cmd);
+		SDL_ReleaseGPUTransferBuffer(gpu, transfer_buffer);
 	}
 
 	enum class sampler_type
@@ -374,28 +1027,244 @@ export namespace sdl3
 		return { sampler, { gpu } };
 	}
 
+	// Instance placement computed in vertex shader from instance id, see procedural_instance.vs.hlsl
+	enum class layout_t : uint32_t
+	{
+		grid,
+		ring,
+		scatter,
+		noise,
+	};
+
+	// Parameter block for procedural instances, layout matches HLSL.
+	// Instances need no instance buffer or upload, count of 0 disables them.
+	struct procedural_params
+	{
+		layout_t layout = layout_t::grid;
+		uint32_t count   = 0;
+		uint32_t columns = 1; // grid and noise, instances per row
+		uint32_t seed    = 0;
+
+		std::array<float, 3> origin = {};
+		float spacing               = 1.0f; // grid cell size, ring and scatter radius
+
+		float scale     = 1.0f;
+		float amplitude = 0.0f; // noise height
+		float time      = 0.0f; // seconds, animates noise
+		float padding   = 0.0f;
+	};
+
+	// Camera data temporal upscaler needs each frame, filled by scenarios that jitter their projection.
+	// Matrices are column major, layout matches HLSL.
+	struct temporal_view
+	{
+		bool enabled = false; // temporal anti-aliasing selected, scenario should jitter
+		bool valid   = false; // scenario filled in this frame's data
+
+		std::array<float, 2> jitter = {}; // sample offset from pixel centre, in scene pixels, y down
+
+		std::array<float, 16> view_projection          = {}; // without jitter
+		std::array<float, 16> previous_view_projection = {}; // without jitter, last frame
+		std::array<float, 16> reprojection             = {}; // this frame's clip space to last frame's, without jitter
+	};
+
+	// Halton (2, 3) sample offset for frame, -0.5 to 0.5 pixels.
+	// Sequence is longer when scene is drawn below output size, so every output pixel gets samples near it.
+	auto temporal_jitter(uint64_t frame_index, float render_scale) -> std::array<float, 2>
+	{
+		auto halton = [](uint64_t index, uint64_t base) {
+			auto fraction = 1.0f;
+			auto result   = 0.0f;
+			for (; index > 0; index /= base)
+			{
+				fraction /= static_cast<float>(base);
+				result += fraction * static_cast<float>(index % base);
+			}
+			return result;
+		};
+
+		auto phases = static_cast<uint64_t>(std::ceil(8.0f / (render_scale * render_scale)));
+		auto index  = frame_index % phases + 1; // Halton sequence starts at 1, 0 would be at pixel corner
+		return { halton(index, 2) - 0.5f, halton(index, 3) - 0.5f };
+	}
+
+	// Frames submitted to GPU, with fence that signals when each one finishes.
+	// Polled without blocking at start of every frame.
+	struct frame_timeline
+	{
+		struct in_flight
+		{
+			SDL_GPUFence *fence;
+			uint64_t frame_index;
+			uint64_t submit_ns;
+		};
+
+		SDL_GPUDevice *gpu = nullptr;
+		std::deque<in_flight> frames;
+		uint64_t frame_index     = 0; // index given to next frame
+		uint64_t completed_count = 0; // all frames before this index have finished on GPU
+		uint64_t last_signal_ns  = 0;
+
+		// GPU time of last finished frame, from submit (or previous frame's completion) to fence signal.
+		// Fences are only polled once per frame, so this is an upper bound, not a timestamp query.
+		float gpu_ms = 0.0f;
+	};
+
+	// Collect frames whose fence has signalled, oldest first
+	void poll_timeline(frame_timeline &tl)
+	{
+		while (not tl.frames.empty() and SDL_QueryGPUFence(tl.gpu, tl.frames.front().fence))
+		{
+			auto frame     = tl.frames.front();
+			auto signal_ns = SDL_GetTicksNS();
+			auto start_ns  = std::max(frame.submit_ns, tl.last_signal_ns);
+
+			tl.gpu_ms          = static_cast<float>(signal_ns - start_ns) / 1'000'000.0f;
+			tl.last_signal_ns  = signal_ns;
+			tl.completed_count = frame.frame_index + 1;
+
+			SDL_ReleaseGPUFence(tl.gpu, frame.fence);
+			tl.frames.pop_front();
+		}
+	}
+
+	// Wait for every frame in flight, and release their fences
+	void drain_timeline(frame_timeline &tl)
+	{
+		for (auto &&frame : tl.frames)
+		{
+			SDL_WaitForGPUFences(tl.gpu, true, &frame.fence, 1);
+		}
+		poll_timeline(tl);
+	}
+
+	// Run of instances in a buffer, first is an instance index, not a byte offset
+	struct instance_range
+	{
+		uint32_t first;
+		uint32_t count;
+	};
+
+	// Indexed draw of a mesh in shared geometry pool buffers, offsets are in indices and vertices, not bytes
+	struct pooled_draw
+	{
+		uint32_t index_count;
+		uint32_t first_index;
+		int32_t vertex_offset;
+		instance_range instances;
+	};
+
 	struct scene
 	{
 		SDL_FColor clear_color;
 
 		std::vector<gfx_pipeline_ptr> pipelines;
 
+		// Size of color and depth targets, smaller than render size when upscaled
+		uint32_t width;
+		uint32_t height;
+
 		gpu_buffer_ptr vertex_buffer;
+		gpu_buffer_ptr position_buffer;
 		gpu_buffer_ptr index_buffer;
 		gpu_buffer_ptr instance_buffer;
+		gpu_buffer_ptr transparent_instance_buffer;
 		uint32_t vertex_count;
 		uint32_t index_count;
 		uint32_t instance_count;
+		uint32_t transparent_instance_count;
+		SDL_FColor transparent_tint = { 1.0f, 1.0f, 1.0f, 0.5f };
+
+		upload_ring uploads;
+		download_ring downloads;
+		frame_timeline timeline;
 
+		gpu_texture_ptr color_texture;
 		gpu_texture_ptr depth_texture;
+		gpu_texture_ptr msaa_color_texture; // drawn in to when context is multisampled, resolves in to color_texture
 		gpu_texture_ptr uv_texture;
 		gpu_sampler_ptr uv_sampler;
 
+		transparency_mode_t transparency = transparency_mode_t::sorted;
+		gpu_texture_ptr oit_accumulation_texture;
+		gpu_texture_ptr oit_revealage_texture;
+		gpu_texture_ptr oit_msaa_accumulation_texture; // multisampled, resolve in to textures above
+		gpu_texture_ptr oit_msaa_revealage_texture;
+		gpu_sampler_ptr oit_sampler;
+
+		// Temporal upscaling, motion is only drawn when scene isn't multisampled
+		temporal_view temporal;
+		gpu_texture_ptr motion_texture;
+		gpu_sampler_ptr depth_sampler;
+
 		io::byte_span view_projection;
+
+		// Lay down depth with position only stream first, then shade with EQUAL depth test
+		bool depth_prepass = false;
+
+		// Instances in a shared pool buffer, in ranges streaming adds and removes, drawn like instance_buffer's
+		SDL_GPUBuffer *streamed_instance_buffer = nullptr;
+		std::vector<instance_range> streamed_instances;
+
+		// Meshes in shared geometry pool buffers, that geometry residency streams in and out
+		SDL_GPUBuffer *pooled_vertex_buffer   = nullptr;
+		SDL_GPUBuffer *pooled_index_buffer    = nullptr;
+		SDL_GPUBuffer *pooled_instance_buffer = nullptr;
+		std::vector<pooled_draw> pooled_draws;
+
+		// Mesh instances placed by vertex shader
+		procedural_params procedural;
+		procedural_params previous_procedural; // last frame's, for motion of animated instances
 	};
 
+	// Queue per-frame instance data for upload, it's copied at start of next draw.
+	// Opaque instances should be sorted front-to-back, transparent instances back-to-front.
+	void update_instances(const context &ctx, scene &scn, const io::byte_span opaque, const io::byte_span transparent)
+	{
+		auto gpu = ctx.gpu.get();
+
+		stage_upload(gpu, scn.uploads, opaque, scn.instance_buffer.get(), 0, true);
+		stage_upload(gpu, scn.uploads, transparent, scn.transparent_instance_buffer.get(), 0, true);
+	}
+
+	// Get pipeline from scene using it's id
+	auto get_pipeline(const scene &scn, pipeline_id id) -> SDL_GPUGraphicsPipeline *
+	{
+		return scn.pipelines.at(std::to_underlying(id)).get();
+	}
+
+	// Color target for a pass drawing in to scene color.
+	// Multisampled scene draws in to MSAA texture and resolves at end of every pass, so color_texture is always current.
+	// Samples are kept as well, for passes that load them after this one.
+	auto scene_color_target(const scene &scn, SDL_GPULoadOp load_op) -> SDL_GPUColorTargetInfo
+	{
+		auto cycle = (load_op != SDL_GPU_LOADOP_LOAD);
+
+		if (scn.msaa_color_texture == nullptr)
+		{
+			return {
+				.texture     = scn.color_texture.get(),
+				.clear_color = scn.clear_color,
+				.load_op     = load_op,
+				.store_op    = SDL_GPU_STOREOP_STORE,
+				.cycle       = cycle,
+			};
+		}
+
+		return {
+			.texture               = scn.msaa_color_texture.get(),
+			.clear_color           = scn.clear_color,
+			.load_op               = load_op,
+			.store_op              = SDL_GPU_STOREOP_RESOLVE_AND_STORE,
+			.resolve_texture       = scn.color_texture.get(),
+			.cycle                 = cycle,
+			.cycle_resolve_texture = cycle,
+		};
+	}
+
 	void upload_to_gpu(SDL_GPUDevice *gpu,
 	                   const io::byte_span vertices,
+	                   const io::byte_span positions,
 	                   const io::byte_span indices,
 	                   const io::byte_span instances,
 	                   const io::image_data &texture,
@@ -403,7 +1272,7 @@ export namespace sdl3
 	{
 		msg::info("Upload to gpu memory.");
 
-		auto tb_size = static_cast<uint32_t>(vertices.size() + indices.size() + instances.size() + texture.data.size());
+		auto tb_size = static_cast<uint32_t>(vertices.size() + positions.size() + indices.size() + instances.size() + texture.data.size());
 
 		auto transfer_info = SDL_GPUTransferBufferCreateInfo{
 			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
@@ -416,8 +1285,11 @@ export namespace sdl3
 
 		// vertices
 		std::memcpy(data, vertices.data(), vertices.size());
-		// indicies
+		// positions
 		data = io::offset_ptr(data, vertices.size());
+		std::memcpy(data, positions.data(), positions.size());
+		// indicies
+		data = io::offset_ptr(data, positions.size());
 		std::memcpy(data, indices.data(), indices.size());
 		// instances
 		data = io::offset_ptr(data, indices.size());
@@ -448,6 +1320,18 @@ export namespace sdl3
 			SDL_UploadToGPUBuffer(copy_pass, &src_b, &dst, false);
 			offset += dst.size;
 		}
+		// positions
+		{
+			src_b.offset = offset;
+
+			auto dst = SDL_GPUBufferRegion{
+				.buffer = scn.position_buffer.get(),
+				.offset = 0,
+				.size   = static_cast<uint32_t>(positions.size()),
+			};
+			SDL_UploadToGPUBuffer(copy_pass, &src_b, &dst, false);
+			offset += dst.size;
+		}
 		// indices
 		{
 			src_b.offset = offset;
@@ -500,41 +1384,118 @@ export namespace sdl3
 		SDL_ReleaseGPUTransferBuffer(gpu, transfer_buffer);
 	}
 
-	auto init_scene(const context &ctx,
-	                const std::span<const pipeline_desc> pipelines,
-	                const io::byte_span vertices, uint32_t vertex_count,
-	                const io::byte_span indices, uint32_t index_count,
-	                const io::byte_span instances, uint32_t instance_count,
-	                const io::image_data &texture) -> scene
+	// Pipelines, color and depth targets, and per-frame resources only.
+	// Scenarios that bring their own geometry start from this.
+	auto init_scene(const context &ctx, const std::span<const pipeline_desc> pipelines) -> scene
 	{
 		auto gpu = ctx.gpu.get();
-		auto w = 0, h = 0;
-		SDL_GetWindowSizeInPixels(ctx.window.get(), &w, &h);
+		auto [w, h] = scene_size(ctx);
 
 		msg::info("Create Scene.");
 
 		auto scn = scene{
-			.vertex_count   = vertex_count,
-			.index_count    = index_count,
-			.instance_count = instance_count,
+			.width  = w,
+			.height = h,
 		};
 
 		std::ranges::transform(pipelines, std::back_inserter(scn.pipelines), [&](const auto &pipeline) {
 			return make_gfx_pipeline(ctx, pipeline);
 		});
+		scn.uploads      = make_upload_ring(gpu, UPLOAD_RING_CAPACITY);
+		scn.timeline.gpu = gpu;
+
+		// Multisampled textures can only be render targets
+		auto multisampled = (ctx.msaa != SDL_GPU_SAMPLECOUNT_1);
+		auto sampler_use  = multisampled ? SDL_GPUTextureUsageFlags{} : SDL_GPU_TEXTUREUSAGE_SAMPLER;
+
+		auto td = texture_desc{
+			.usage        = sampler_use | SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET,
+			.format       = DEPTH_FORMAT,
+			.width        = w,
+			.height       = h,
+			.depth        = 1,
+			.mip_levels   = 1,
+			.sample_count = ctx.msaa,
+		};
+		scn.depth_texture = make_texture(gpu, td, "Depth Texture"sv);
+
+		auto color_td = texture_desc{
+			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+			.format     = SCENE_COLOR_FORMAT,
+			.width      = w,
+			.height     = h,
+			.depth      = 1,
+			.mip_levels = 1,
+		};
+		scn.color_texture = make_texture(gpu, color_td, "Scene Color Texture"sv);
+
+		if (multisampled)
+		{
+			color_td.usage        = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+			color_td.sample_count = ctx.msaa;
+			scn.msaa_color_texture = make_texture(gpu, color_td, "Scene MSAA Color Texture"sv);
+		}
+		else
+		{
+			// Camera motion is reprojected from depth, so it needs single sampled depth to read
+			color_td.format    = MOTION_FORMAT;
+			scn.motion_texture = make_texture(gpu, color_td, "Motion Texture"sv);
+			scn.depth_sampler  = make_sampler(gpu, sampler_type::point_clamp);
+		}
+
+		return scn;
+	}
+
+	auto init_scene(const context &ctx,
+	                const std::span<const pipeline_desc> pipelines,
+	                const io::byte_span vertices, uint32_t vertex_count,
+	                const io::byte_span positions,
+	                const io::byte_span indices, uint32_t index_count,
+	                const io::byte_span instances, uint32_t instance_count,
+	                const io::byte_span transparent_instances, uint32_t transparent_instance_count,
+	                const io::image_data &texture) -> scene
+	{
+		auto gpu = ctx.gpu.get();
+		auto [w, h] = scene_size(ctx);
+
+		auto scn = init_scene(ctx, pipelines);
+
+		scn.vertex_count               = vertex_count;
+		scn.index_count                = index_count;
+		scn.instance_count             = instance_count;
+		scn.transparent_instance_count = transparent_instance_count;
+
 		scn.vertex_buffer   = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(vertices.size()), "Vertex Buffer"sv);
+		scn.position_buffer = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(positions.size()), "Position Buffer"sv);
 		scn.index_buffer    = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_INDEX, static_cast<uint32_t>(indices.size()), "Index Buffer"sv);
 		scn.instance_buffer = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(instances.size()), "Instance Buffer"sv);
+		scn.transparent_instance_buffer = make_buffer(gpu, SDL_GPU_BUFFERUSAGE_VERTEX, static_cast<uint32_t>(transparent_instances.size()), "Transparent Instance Buffer"sv);
 
-		auto td = texture_desc{
-			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET,
-			.format     = DEPTH_FORMAT,
-			.width      = static_cast<uint32_t>(w),
-			.height     = static_cast<uint32_t>(h),
+		auto oit_td = texture_desc{
+			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+			.format     = OIT_ACCUMULATION_FORMAT,
+			.width      = w,
+			.height     = h,
 			.depth      = 1,
 			.mip_levels = 1,
 		};
-		scn.depth_texture = make_texture(gpu, td, "Depth Texture"sv);
+		scn.oit_accumulation_texture = make_texture(gpu, oit_td, "OIT Accumulation Texture"sv);
+
+		oit_td.format             = OIT_REVEALAGE_FORMAT;
+		scn.oit_revealage_texture = make_texture(gpu, oit_td, "OIT Revealage Texture"sv);
+		scn.oit_sampler           = make_sampler(gpu, sampler_type::point_clamp);
+
+		// Accumulation is depth tested against multisampled scene depth, so it's targets have to match
+		if (ctx.msaa != SDL_GPU_SAMPLECOUNT_1)
+		{
+			oit_td.usage        = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+			oit_td.sample_count = ctx.msaa;
+
+			oit_td.format                     = OIT_ACCUMULATION_FORMAT;
+			scn.oit_msaa_accumulation_texture = make_texture(gpu, oit_td, "OIT MSAA Accumulation Texture"sv);
+			oit_td.format                     = OIT_REVEALAGE_FORMAT;
+			scn.oit_msaa_revealage_texture    = make_texture(gpu, oit_td, "OIT MSAA Revealage Texture"sv);
+		}
 
 		auto td2 = texture_desc{
 			.usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER,
@@ -547,7 +1508,10 @@ export namespace sdl3
 		scn.uv_texture = make_texture(gpu, td2, "UV texture"sv);
 		scn.uv_sampler = make_sampler(gpu, sampler_type::anisotropic_clamp);
 
-		upload_to_gpu(gpu, vertices, indices, instances, texture, scn);
+		upload_to_gpu(gpu, vertices, positions, indices, instances, texture, scn);
+
+		// Transparent instances are re-sorted every frame, so they only ever go through upload ring
+		stage_upload(gpu, scn.uploads, transparent_instances, scn.transparent_instance_buffer.get(), 0, true);
 
 		return scn;
 	}
@@ -556,9 +1520,23 @@ export namespace sdl3
 	{
 		msg::info("Destroy Scene.");
 
+		drain_timeline(scn.timeline);
+		resolve_downloads(scn.timeline.gpu, scn.downloads, scn.timeline.completed_count);
 		scn = {};
 	}
 
+	// Per-frame command buffer and swapchain image
+	struct frame_context
+	{
+		SDL_GPUDevice *gpu;
+		SDL_GPUCommandBuffer *cmd_buf;
+		SDL_GPUTexture *swapchain; // or offscreen target
+		uint32_t width;
+		uint32_t height;
+		uint64_t frame_index;
+		uint32_t draw_calls = 0; // recorded so far this frame
+	};
+
 	// Get Swapchain Image/Texture, wait if none is available
 	// Does not use smart pointer as lifetime of swapchain texture is managed by SDL
 	auto get_swapchain_texture(SDL_Window *wnd, SDL_GPUCommandBuffer *cmd_buf) -> SDL_GPUTexture *
@@ -572,60 +1550,397 @@ export namespace sdl3
 		return sc_tex;
 	}
 
-	void draw(const context &ctx, const scene &scn, const io::byte_span view_proj)
+	// Bind vertex and instance streams, and draw mesh instances with pipeline.
+	// Returns number of draw calls recorded.
+	auto draw_instanced(SDL_GPURenderPass *render_pass,
+	                    const scene &scn,
+	                    pipeline_id pipeline,
+	                    SDL_GPUBuffer *vertices,
+	                    SDL_GPUBuffer *instances,
+	                    uint32_t instance_count) -> uint32_t
+	{
+		if (instance_count == 0)
+			return 0;
+
+		// Vertex and Instance buffer
+		auto vertex_bindings = std::array{
+			SDL_GPUBufferBinding{
+			  .buffer = vertices,
+			  .offset = 0,
+			},
+			SDL_GPUBufferBinding{
+			  .buffer = instances,
+			  .offset = 0,
+			},
+		};
+		SDL_BindGPUVertexBuffers(render_pass, 0, vertex_bindings.data(), static_cast<uint32_t>(vertex_bindings.size()));
+
+		// Index Buffer
+		auto index_binding = SDL_GPUBufferBinding{
+			.buffer = scn.index_buffer.get(),
+			.offset = 0,
+		};
+		SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+		// Graphics Pipeline
+		SDL_BindGPUGraphicsPipeline(render_pass, get_pipeline(scn, pipeline));
+
+		// Draw Indexed
+		SDL_DrawGPUIndexedPrimitives(render_pass, scn.index_count, instance_count, 0, 0, 0);
+		return 1;
+	}
+
+	// One draw per range, instances are read starting at range's first through first_instance
+	auto draw_instance_ranges(SDL_GPURenderPass *render_pass,
+	                          const scene &scn,
+	                          pipeline_id pipeline,
+	                          SDL_GPUBuffer *instances,
+	                          std::span<const instance_range> ranges) -> uint32_t
+	{
+		if (instances == nullptr or ranges.empty())
+			return 0;
+
+		auto vertex_bindings = std::array{
+			SDL_GPUBufferBinding{
+			  .buffer = scn.vertex_buffer.get(),
+			  .offset = 0,
+			},
+			SDL_GPUBufferBinding{
+			  .buffer = instances,
+			  .offset = 0,
+			},
+		};
+		SDL_BindGPUVertexBuffers(render_pass, 0, vertex_bindings.data(), static_cast<uint32_t>(vertex_bindings.size()));
+
+		auto index_binding = SDL_GPUBufferBinding{
+			.buffer = scn.index_buffer.get(),
+			.offset = 0,
+		};
+		SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+		SDL_BindGPUGraphicsPipeline(render_pass, get_pipeline(scn, pipeline));
+
+		for (auto &&rng : ranges)
+		{
+			SDL_DrawGPUIndexedPrimitives(render_pass, scn.index_count, rng.count, 0, 0, rng.first);
+		}
+		return static_cast<uint32_t>(ranges.size());
+	}
+
+	// Meshes from geometry pool, one draw each, vertex and index buffers are bound once for all of them
+	auto draw_pooled_meshes(SDL_GPURenderPass *render_pass, const scene &scn, pipeline_id pipeline) -> uint32_t
+	{
+		if (scn.pooled_vertex_buffer == nullptr or scn.pooled_draws.empty())
+			return 0;
+
+		auto vertex_bindings = std::array{
+			SDL_GPUBufferBinding{
+			  .buffer = scn.pooled_vertex_buffer,
+			  .offset = 0,
+			},
+			SDL_GPUBufferBinding{
+			  .buffer = scn.pooled_instance_buffer,
+			  .offset = 0,
+			},
+		};
+		SDL_BindGPUVertexBuffers(render_pass, 0, vertex_bindings.data(), static_cast<uint32_t>(vertex_bindings.size()));
+
+		auto index_binding = SDL_GPUBufferBinding{
+			.buffer = scn.pooled_index_buffer,
+			.offset = 0,
+		};
+		SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+		SDL_BindGPUGraphicsPipeline(render_pass, get_pipeline(scn, pipeline));
+
+		for (auto &&draw : scn.pooled_draws)
+		{
+			SDL_DrawGPUIndexedPrimitives(render_pass, draw.index_count, draw.instances.count,
+			                             draw.first_index, draw.vertex_offset, draw.instances.first);
+		}
+		return static_cast<uint32_t>(scn.pooled_draws.size());
+	}
+
+	// Unsorted transparent draws in to accumulation and revealage targets,
+	// then full screen composite on top of opaque result in scene color.
+	// Returns number of draw calls recorded.
+	auto draw_weighted_oit(SDL_GPUCommandBuffer *cmd_buf, const scene &scn) -> uint32_t
+	{
+		auto draw_calls = uint32_t{ 0 };
+
+		// Multisampled accumulation resolves in to single sampled targets, which composite reads
+		auto oit_target = [](SDL_GPUTexture *texture, SDL_GPUTexture *msaa_texture, SDL_FColor clear) {
+			if (msaa_texture == nullptr)
+			{
+				return SDL_GPUColorTargetInfo{
+					.texture     = texture,
+					.clear_color = clear,
+					.load_op     = SDL_GPU_LOADOP_CLEAR,
+					.store_op    = SDL_GPU_STOREOP_STORE,
+					.cycle       = true,
+				};
+			}
+			return SDL_GPUColorTargetInfo{
+				.texture               = msaa_texture,
+				.clear_color           = clear,
+				.load_op               = SDL_GPU_LOADOP_CLEAR,
+				.store_op              = SDL_GPU_STOREOP_RESOLVE,
+				.resolve_texture       = texture,
+				.cycle                 = true,
+				.cycle_resolve_texture = true,
+			};
+		};
+
+		auto oit_targets = std::array{
+			oit_target(scn.oit_accumulation_texture.get(), scn.oit_msaa_accumulation_texture.get(), { 0.0f, 0.0f, 0.0f, 0.0f }),
+			oit_target(scn.oit_revealage_texture.get(), scn.oit_msaa_revealage_texture.get(), { 1.0f, 1.0f, 1.0f, 1.0f }),
+		};
+
+		// Depth from opaque pass, tested but not written
+		auto depth_target = SDL_GPUDepthStencilTargetInfo{
+			.texture          = scn.depth_texture.get(),
+			.load_op          = SDL_GPU_LOADOP_LOAD,
+			.store_op         = SDL_GPU_STOREOP_STORE,
+			.stencil_load_op  = SDL_GPU_LOADOP_LOAD,
+			.stencil_store_op = SDL_GPU_STOREOP_STORE,
+			.cycle            = false,
+		};
+
+		auto accumulate_pass = SDL_BeginGPURenderPass(cmd_buf, oit_targets.data(), static_cast<uint32_t>(oit_targets.size()), &depth_target);
+		{
+			auto sampler_binding = SDL_GPUTextureSamplerBinding{
+				.texture = scn.uv_texture.get(),
+				.sampler = scn.uv_sampler.get(),
+			};
+			SDL_BindGPUFragmentSamplers(accumulate_pass, 0, &sampler_binding, 1);
+
+			SDL_PushGPUFragmentUniformData(cmd_buf, 0, &scn.transparent_tint, sizeof(SDL_FColor));
+
+			draw_calls += draw_instanced(accumulate_pass, scn, pipeline_id::transparent_mesh_oit,
+			                             scn.vertex_buffer.get(), scn.transparent_instance_buffer.get(), scn.transparent_instance_count);
+		}
+		SDL_EndGPURenderPass(accumulate_pass);
+
+		auto color_target = scene_color_target(scn, SDL_GPU_LOADOP_LOAD);
+
+		auto composite_pass = SDL_BeginGPURenderPass(cmd_buf, &color_target, 1, nullptr);
+		{
+			auto sampler_bindings = std::array{
+				SDL_GPUTextureSamplerBinding{
+				  .texture = scn.oit_accumulation_texture.get(),
+				  .sampler = scn.oit_sampler.get(),
+				},
+				SDL_GPUTextureSamplerBinding{
+				  .texture = scn.oit_revealage_texture.get(),
+				  .sampler = scn.oit_sampler.get(),
+				},
+			};
+			SDL_BindGPUFragmentSamplers(composite_pass, 0, sampler_bindings.data(), static_cast<uint32_t>(sampler_bindings.size()));
+
+			SDL_BindGPUGraphicsPipeline(composite_pass, get_pipeline(scn, pipeline_id::oit_composite));
+
+			// Full screen triangle
+			SDL_DrawGPUPrimitives(composite_pass, 3, 1, 0, 0);
+			++draw_calls;
+		}
+		SDL_EndGPURenderPass(composite_pass);
+
+		return draw_calls;
+	}
+
+	// Acquire command buffer and swapchain image for this frame.
+	// Uploads staged before this call are copied before any draws.
+	// Passing target renders frame in to that texture instead of swapchain, headless contexts must pass one.
+	auto begin_frame(const context &ctx, scene &scn, SDL_GPUTexture *target = nullptr) -> frame_context
 	{
 		auto gpu = ctx.gpu.get();
 		auto wnd = ctx.window.get();
 
+		// Finished frames and their readbacks, before CPU possibly waits on swapchain
+		poll_timeline(scn.timeline);
+		resolve_downloads(gpu, scn.downloads, scn.timeline.completed_count);
+
 		auto cmd_buf = SDL_AcquireGPUCommandBuffer(gpu);
 		msg::error(cmd_buf != nullptr, "Failed to acquire command buffer");
 
-		// Push Uniform buffer
-		SDL_PushGPUVertexUniformData(cmd_buf, 0, view_proj.data(), static_cast<uint32_t>(view_proj.size()));
+		// Copy this frame's staged data before any draws use it
+		if (not scn.uploads.copies.empty())
+		{
+			auto copy_pass = SDL_BeginGPUCopyPass(cmd_buf);
+			flush_uploads(gpu, scn.uploads, copy_pass);
+			SDL_EndGPUCopyPass(copy_pass);
+		}
 
-		// Swapchain image
-		auto sc_img = get_swapchain_texture(wnd, cmd_buf);
+		// Swapchain image, unless frame has it's own target
+		auto sc_img = (target != nullptr) ? target : get_swapchain_texture(wnd, cmd_buf);
 
-		auto color_target = SDL_GPUColorTargetInfo{
-			.texture     = sc_img,
-			.clear_color = scn.clear_color,
-			.load_op     = SDL_GPU_LOADOP_CLEAR,
-			.store_op    = SDL_GPU_STOREOP_STORE,
+		auto [w, h] = render_size(ctx);
+
+		return {
+			.gpu         = gpu,
+			.cmd_buf     = cmd_buf,
+			.swapchain   = sc_img,
+			.width       = w,
+			.height      = h,
+			.frame_index = scn.timeline.frame_index++,
 		};
+	}
+
+	// Submit all the work recorded for this frame, and track it's fence
+	void end_frame(frame_context &frm, scene &scn)
+	{
+		// Readbacks see everything drawn this frame
+		if (not scn.downloads.queued.empty())
+		{
+			auto copy_pass = SDL_BeginGPUCopyPass(frm.cmd_buf);
+			record_downloads(scn.downloads, copy_pass, frm.frame_index);
+			SDL_EndGPUCopyPass(copy_pass);
+		}
+
+		auto fence = SDL_SubmitGPUCommandBufferAndAcquireFence(frm.cmd_buf);
+		msg::error(fence != nullptr, "Failed to submit command buffer.");
 
+		if (fence != nullptr)
+		{
+			scn.timeline.frames.push_back({
+			  .fence       = fence,
+			  .frame_index = frm.frame_index,
+			  .submit_ns   = SDL_GetTicksNS(),
+			});
+		}
+		frm = {};
+	}
+
+	// Block until frame_index has finished on GPU, then deliver it's readbacks.
+	// For batch work that must bound frames in flight, interactive loop never calls this.
+	void wait_for_frame(scene &scn, uint64_t frame_index)
+	{
+		auto &tl = scn.timeline;
+		for (auto &&frame : tl.frames)
+		{
+			if (frame.frame_index > frame_index)
+				break;
+			SDL_WaitForGPUFences(tl.gpu, true, &frame.fence, 1);
+		}
+		poll_timeline(tl);
+		resolve_downloads(tl.gpu, scn.downloads, tl.completed_count);
+	}
+
+	// Uniforms of camera motion pass, layout matches camera_motion.fs.hlsl
+	struct camera_motion_params
+	{
+		std::array<float, 16> reprojection;
+		std::array<float, 2> jitter_uv;
+		std::array<float, 2> padding;
+	};
+
+	// Screen space motion of everything drawn opaque this frame, for temporal upscaler.
+	// Camera motion is reprojected from depth over whole screen, static instances need nothing more.
+	// Animated procedural instances then write their own, placed at this and last frame's time.
+	auto draw_motion(SDL_GPUCommandBuffer *cmd_buf, const scene &scn, const io::byte_span view_proj) -> uint32_t
+	{
+		auto draw_calls = uint32_t{ 0 };
+		auto &tv        = scn.temporal;
+
+		auto motion_target = SDL_GPUColorTargetInfo{
+			.texture  = scn.motion_texture.get(),
+			.load_op  = SDL_GPU_LOADOP_DONT_CARE,
+			.store_op = SDL_GPU_STOREOP_STORE,
+			.cycle    = true,
+		};
+
+		auto camera_pass = SDL_BeginGPURenderPass(cmd_buf, &motion_target, 1, nullptr);
+		{
+			auto params = camera_motion_params{
+				.reprojection = tv.reprojection,
+				.jitter_uv    = { tv.jitter[0] / static_cast<float>(scn.width),
+				                  tv.jitter[1] / static_cast<float>(scn.height) },
+			};
+			SDL_PushGPUFragmentUniformData(cmd_buf, 0, &params, sizeof(camera_motion_params));
+
+			auto depth_binding = SDL_GPUTextureSamplerBinding{
+				.texture = scn.depth_texture.get(),
+				.sampler = scn.depth_sampler.get(),
+			};
+			SDL_BindGPUFragmentSamplers(camera_pass, 0, &depth_binding, 1);
+
+			SDL_BindGPUGraphicsPipeline(camera_pass, get_pipeline(scn, pipeline_id::camera_motion));
+			SDL_DrawGPUPrimitives(camera_pass, 3, 1, 0, 0);
+			++draw_calls;
+		}
+		SDL_EndGPURenderPass(camera_pass);
+
+		// Instances are matched to last frame's by id, which only holds while layout stays the same
+		auto &now  = scn.procedural;
+		auto &prev = scn.previous_procedural;
+		if (now.count == 0 or now.layout != prev.layout or now.count != prev.count or now.seed != prev.seed)
+			return draw_calls;
+
+		motion_target.load_op = SDL_GPU_LOADOP_LOAD;
+		motion_target.cycle   = false;
+
+		// Depth tested against scene's own depth, without writes, so only visible surfaces overwrite camera motion
 		auto depth_target = SDL_GPUDepthStencilTargetInfo{
 			.texture          = scn.depth_texture.get(),
-			.clear_depth      = 1.0f,
-			.load_op          = SDL_GPU_LOADOP_CLEAR,
+			.load_op          = SDL_GPU_LOADOP_LOAD,
 			.store_op         = SDL_GPU_STOREOP_STORE,
-			.stencil_load_op  = SDL_GPU_LOADOP_CLEAR,
+			.stencil_load_op  = SDL_GPU_LOADOP_LOAD,
 			.stencil_store_op = SDL_GPU_STOREOP_STORE,
-			.cycle            = true,
-			.clear_stencil    = 0,
 		};
 
-		auto render_pass = SDL_BeginGPURenderPass(cmd_buf, &color_target, 1, &depth_target);
+		auto object_pass = SDL_BeginGPURenderPass(cmd_buf, &motion_target, 1, &depth_target);
 		{
-			// Vertex and Instance buffer
-			auto vertex_bindings = std::array{
-				SDL_GPUBufferBinding{
-				  .buffer = scn.vertex_buffer.get(),
-				  .offset = 0,
-				},
-				SDL_GPUBufferBinding{
-				  .buffer = scn.instance_buffer.get(),
-				  .offset = 0,
-				},
+			auto matrices = std::array{ tv.view_projection, tv.previous_view_projection };
+
+			SDL_PushGPUVertexUniformData(cmd_buf, 0, view_proj.data(), static_cast<uint32_t>(view_proj.size()));
+			SDL_PushGPUVertexUniformData(cmd_buf, 1, &now, sizeof(procedural_params));
+			SDL_PushGPUVertexUniformData(cmd_buf, 2, &prev, sizeof(procedural_params));
+			SDL_PushGPUVertexUniformData(cmd_buf, 3, matrices.data(), sizeof(matrices));
+
+			auto vertex_binding = SDL_GPUBufferBinding{
+				.buffer = scn.vertex_buffer.get(),
+				.offset = 0,
 			};
-			SDL_BindGPUVertexBuffers(render_pass, 0, vertex_bindings.data(), static_cast<uint32_t>(vertex_bindings.size()));
+			SDL_BindGPUVertexBuffers(object_pass, 0, &vertex_binding, 1);
 
-			// Index Buffer
 			auto index_binding = SDL_GPUBufferBinding{
 				.buffer = scn.index_buffer.get(),
 				.offset = 0,
 			};
-			SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+			SDL_BindGPUIndexBuffer(object_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
+			SDL_BindGPUGraphicsPipeline(object_pass, get_pipeline(scn, pipeline_id::procedural_motion));
+			SDL_DrawGPUIndexedPrimitives(object_pass, scn.index_count, now.count, 0, 0, 0);
+			++draw_calls;
+		}
+		SDL_EndGPURenderPass(object_pass);
+
+		return draw_calls;
+	}
+
+	// Draw scene in to scene's HDR color texture
+	void draw(frame_context &frm, scene &scn, const io::byte_span view_proj)
+	{
+		auto cmd_buf = frm.cmd_buf;
+
+		// Push Uniform buffer
+		SDL_PushGPUVertexUniformData(cmd_buf, 0, view_proj.data(), static_cast<uint32_t>(view_proj.size()));
+
+		auto color_target = scene_color_target(scn, SDL_GPU_LOADOP_CLEAR);
+
+		auto depth_target = SDL_GPUDepthStencilTargetInfo{
+			.texture          = scn.depth_texture.get(),
+			.clear_depth      = 1.0f,
+			.load_op          = SDL_GPU_LOADOP_CLEAR,
+			.store_op         = SDL_GPU_STOREOP_STORE,
+			.stencil_load_op  = SDL_GPU_LOADOP_CLEAR,
+			.stencil_store_op = SDL_GPU_STOREOP_STORE,
+			.cycle            = true,
+			.clear_stencil    = 0,
+		};
+
+		auto render_pass = SDL_BeginGPURenderPass(cmd_buf, &color_target, 1, &depth_target);
+		{
 			// UV Texture and Sampler
 			auto sampler_binding = SDL_GPUTextureSamplerBinding{
 				.texture = scn.uv_texture.get(),
@@ -633,67 +1948,79 @@ export namespace sdl3
 			};
 			SDL_BindGPUFragmentSamplers(render_pass, 0, &sampler_binding, 1);
 
-			// Graphics Pipeline
-			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.at(0).get());
+			// For Depth Prepass ---------------------------------------------------------------------------------------------------------------
+			if (scn.depth_prepass)
+			{
+				frm.draw_calls += draw_instanced(render_pass, scn, pipeline_id::depth_prepass,
+				                                 scn.position_buffer.get(), scn.instance_buffer.get(), scn.instance_count);
+			}
 
-			// Draw Indexed
-			SDL_DrawGPUIndexedPrimitives(render_pass, scn.index_count, scn.instance_count, 0, 0, 0);
+			// For Textured Mesh, instances are sorted front-to-back ---------------------------------------------------------------------------
+			// EQUAL depth test without writes if depth is already laid down
+			auto mesh_pipeline = scn.depth_prepass ? pipeline_id::textured_mesh_depth_equal : pipeline_id::textured_mesh;
+			frm.draw_calls += draw_instanced(render_pass, scn, mesh_pipeline,
+			                                 scn.vertex_buffer.get(), scn.instance_buffer.get(), scn.instance_count);
 
-			// For Grid Plan -----------------------------------------------------------------------------------------------------------------------
-			// Graphics Pipeline
-			SDL_BindGPUGraphicsPipeline(render_pass, scn.pipelines.at(1).get());
+			// Streamed instances aren't in depth prepass, so they always test and write depth themselves
+			frm.draw_calls += draw_instance_ranges(render_pass, scn, pipeline_id::textured_mesh,
+			                                       scn.streamed_instance_buffer, scn.streamed_instances);
+			frm.draw_calls += draw_pooled_meshes(render_pass, scn, pipeline_id::textured_mesh);
 
-			// Draw Indexed
-			SDL_DrawGPUPrimitives(render_pass, 6, 1, 0, 0);
-		}
-		SDL_EndGPURenderPass(render_pass);
+			// For Procedural Instances, no instance buffer ----------------------------------------------------------------------------------------
+			if (scn.procedural.count > 0)
+			{
+				SDL_PushGPUVertexUniformData(cmd_buf, 1, &scn.procedural, sizeof(procedural_params));
 
-		SDL_SubmitGPUCommandBuffer(cmd_buf);
-	}
-}
+				auto vertex_binding = SDL_GPUBufferBinding{
+					.buffer = scn.vertex_buffer.get(),
+					.offset = 0,
+				};
+				SDL_BindGPUVertexBuffers(render_pass, 0, &vertex_binding, 1);
 
-/*
- * SDL functions called every frame
- */
-namespace frame
-{
+				auto index_binding = SDL_GPUBufferBinding{
+					.buffer = scn.index_buffer.get(),
+					.offset = 0,
+				};
+				SDL_BindGPUIndexBuffer(render_pass, &index_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
-	void update_instance_buffer(const sdl3::context &ctx, const io::byte_span instances, sdl3::scene &rndr)
-	{
-		auto device = ctx.gpu.get();
+				SDL_BindGPUGraphicsPipeline(render_pass, get_pipeline(scn, pipeline_id::procedural_mesh));
+				SDL_DrawGPUIndexedPrimitives(render_pass, scn.index_count, scn.procedural.count, 0, 0, 0);
+				++frm.draw_calls;
+			}
 
-		msg::info("Update instance buffer");
+			// For Grid Plan -----------------------------------------------------------------------------------------------------------------------
+			// Grid fragment shader needs view projection to compute it's depth
+			SDL_PushGPUFragmentUniformData(cmd_buf, 0, view_proj.data(), static_cast<uint32_t>(view_proj.size()));
 
-		auto ib_size = static_cast<uint32_t>(instances.size());
+			// Graphics Pipeline
+			SDL_BindGPUGraphicsPipeline(render_pass, get_pipeline(scn, pipeline_id::grid));
 
-		auto tb_info = SDL_GPUTransferBufferCreateInfo{
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size  = ib_size,
-		};
-		auto transfer_buffer = SDL_CreateGPUTransferBuffer(device, &tb_info);
-		msg::error(transfer_buffer != nullptr, "Failed to create transfer buffer for instance data.");
+			// Draw Indexed
+			SDL_DrawGPUPrimitives(render_pass, 6, 1, 0, 0);
+			++frm.draw_calls;
 
-		auto *data = SDL_MapGPUTransferBuffer(device, transfer_buffer, false);
-		std::memcpy(data, instances.data(), ib_size);
-		SDL_UnmapGPUTransferBuffer(device, transfer_buffer);
+			// For Transparent Meshes, instances are sorted back-to-front --------------------------------------------------------------------------
+			if (scn.transparency == transparency_mode_t::sorted)
+			{
+				SDL_PushGPUFragmentUniformData(cmd_buf, 0, &scn.transparent_tint, sizeof(SDL_FColor));
 
-		auto copy_cmd = SDL_AcquireGPUCommandBuffer(device);
-		auto copypass = SDL_BeginGPUCopyPass(copy_cmd);
+				frm.draw_calls += draw_instanced(render_pass, scn, pipeline_id::transparent_mesh,
+				                                 scn.vertex_buffer.get(), scn.transparent_instance_buffer.get(), scn.transparent_instance_count);
+			}
+		}
+		SDL_EndGPURenderPass(render_pass);
 
-		auto src = SDL_GPUTransferBufferLocation{
-			.transfer_buffer = transfer_buffer,
-			.offset          = 0,
-		};
-		auto dst = SDL_GPUBufferRegion{
-			.buffer = rndr.instance_buffer.get(),
-			.offset = 0,
-			.size   = ib_size,
-		};
-		SDL_UploadToGPUBuffer(copypass, &src, &dst, false);
+		// For Temporal Upscaling, motion of opaque surfaces ------------------------------------------------------------------------------------
+		if (scn.temporal.enabled and scn.temporal.valid and scn.motion_texture != nullptr)
+		{
+			frm.draw_calls += draw_motion(cmd_buf, scn, view_proj);
+		}
+		scn.previous_procedural = scn.procedural;
 
-		SDL_EndGPUCopyPass(copypass);
-		SDL_SubmitGPUCommandBuffer(copy_cmd);
-		SDL_ReleaseGPUTransferBuffer(device, transfer_buffer);
+		// For Transparent Meshes, instances are unsorted ---------------------------------------------------------------------------------------
+		if (scn.transparency == transparency_mode_t::weighted_oit and scn.transparent_instance_count > 0)
+		{
+			frm.draw_calls += draw_weighted_oit(cmd_buf, scn);
+		}
 	}
-
-}
\ No newline at end of file
+}
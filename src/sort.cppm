@@ -0,0 +1,128 @@
+export module sort;
+
+import std;
+
+/*
+ * Parallel LSD radix sort, used to order draws and instances on CPU every frame
+ */
+export namespace sort
+{
+	// Below this many keys, threads cost more than they save
+	constexpr auto MIN_KEYS_PER_THREAD = 16'384u;
+
+	// Map float to uint32, so unsigned integer order matches float order
+	// Flips all bits for negative values, only sign bit for positive values
+	constexpr auto float_key(float value) -> uint32_t
+	{
+		auto bits = std::bit_cast<uint32_t>(value);
+		auto mask = (bits & 0x8000'0000u) ? 0xFFFF'FFFFu : 0x8000'0000u;
+		return bits ^ mask;
+	}
+
+	// Returns permutation of indices that sorts keys in ascending order, sort is stable.
+	// 4 passes of 8 bits each, keys are split in contiguous chunks, one per thread.
+	// Each thread builds histogram for it's chunk, then scatters it's chunk in to place.
+	auto radix_sort(std::span<const uint32_t> keys) -> std::vector<uint32_t>
+	{
+		constexpr auto RADIX_BITS  = 8u;
+		constexpr auto BUCKETS     = 1u << RADIX_BITS;
+		constexpr auto BUCKET_MASK = BUCKETS - 1;
+		constexpr auto PASSES      = 32u / RADIX_BITS;
+
+		using histogram = std::array<uint32_t, BUCKETS>;
+
+		auto count = static_cast<uint32_t>(keys.size());
+
+		auto indices_a = std::vector<uint32_t>(count);
+		auto indices_b = std::vector<uint32_t>(count);
+		auto keys_a    = std::vector<uint32_t>(keys.begin(), keys.end());
+		auto keys_b    = std::vector<uint32_t>(count);
+		std::iota(indices_a.begin(), indices_a.end(), 0u);
+
+		auto max_threads  = std::max(std::thread::hardware_concurrency(), 1u);
+		auto thread_count = std::clamp(count / MIN_KEYS_PER_THREAD, 1u, max_threads);
+		auto chunk_size   = (count + thread_count - 1) / thread_count;
+
+		auto histograms = std::vector<histogram>(thread_count);
+
+		// Source and destination flip after every scatter
+		struct buffers
+		{
+			uint32_t *src_keys;
+			uint32_t *src_indices;
+			uint32_t *dst_keys;
+			uint32_t *dst_indices;
+		};
+		auto bufs = buffers{ keys_a.data(), indices_a.data(), keys_b.data(), indices_b.data() };
+
+		// Runs once, on one thread, when all threads finish a phase
+		// Even phases built histograms, odd phases scattered keys
+		auto phase    = 0u;
+		auto on_phase = [&]() noexcept {
+			if (phase % 2 == 0)
+			{
+				// Convert per-thread counts in to per-thread write offsets
+				auto offset = 0u;
+				for (auto bucket : std::views::iota(0u, BUCKETS))
+				{
+					for (auto &hist : histograms)
+					{
+						auto bucket_count = hist[bucket];
+						hist[bucket]      = offset;
+						offset += bucket_count;
+					}
+				}
+			}
+			else
+			{
+				std::swap(bufs.src_keys, bufs.dst_keys);
+				std::swap(bufs.src_indices, bufs.dst_indices);
+			}
+			++phase;
+		};
+		auto sync = std::barrier(static_cast<std::ptrdiff_t>(thread_count), on_phase);
+
+		auto worker = [&](uint32_t thread_idx) {
+			auto first = std::min(thread_idx * chunk_size, count);
+			auto last  = std::min(first + chunk_size, count);
+			auto &hist = histograms[thread_idx];
+
+			for (auto pass : std::views::iota(0u, PASSES))
+			{
+				auto shift = pass * RADIX_BITS;
+
+				hist.fill(0);
+				for (auto i = first; i < last; ++i)
+				{
+					++hist[(bufs.src_keys[i] >> shift) & BUCKET_MASK];
+				}
+				sync.arrive_and_wait();
+
+				for (auto i = first; i < last; ++i)
+				{
+					auto key = bufs.src_keys[i];
+					auto pos = hist[(key >> shift) & BUCKET_MASK]++;
+
+					bufs.dst_keys[pos]    = key;
+					bufs.dst_indices[pos] = bufs.src_indices[i];
+				}
+				sync.arrive_and_wait();
+			}
+		};
+
+		{
+			// Calling thread is worker 0, jthreads join at end of scope
+			auto threads = std::vector<std::jthread>{};
+			threads.reserve(thread_count - 1);
+			for (auto t : std::views::iota(1u, thread_count))
+			{
+				threads.emplace_back(worker, t);
+			}
+			worker(0);
+		}
+
+		// Even number of passes, so result ends up back in first buffer
+		static_assert(PASSES % 2 == 0);
+		return indices_a;
+	}
+}
@@ -0,0 +1,429 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+// offsetof, macros aren't exported by std module
+#include <cstddef>
+
+// SSE2 is baseline on x64, other targets use scalar packing
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPRITE_SSE2 1
+#else
+#define SPRITE_SSE2 0
+#endif
+
+export module sprite_batch;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import sort;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * 2D sprite batch renderer, in screen pixel coordinates.
+ * Sprites are sorted by layer and texture, packed in to an instance stream,
+ * and drawn with one instanced draw per run of same layer and texture.
+ */
+export namespace sprites
+{
+	constexpr auto MAX_SPRITES = uint32_t{ 512 * 1024 };
+
+	// What callers add every frame
+	struct sprite
+	{
+		std::array<float, 2> position; // center, in pixels, origin top-left
+		float rotation;                // radians, clockwise on screen
+		std::array<float, 2> scale;    // size in pixels
+		std::array<float, 4> uv;       // u0, v0, u1, v1
+		uint32_t color;                // RGBA8 tint
+		uint16_t layer;                // lower layers are drawn first
+		uint16_t texture;              // id from add_texture
+	};
+
+	// What GPU reads, layout matches sprite.vs.hlsl.
+	// Rotation and scale are baked in to corner axes on CPU.
+	struct instance
+	{
+		std::array<float, 2> position;
+		std::array<float, 2> axis_x;
+		std::array<float, 2> axis_y;
+		std::array<uint16_t, 4> uv; // unorm16
+		uint32_t color;
+	};
+	static_assert(sizeof(instance) == 36);
+	static_assert(offsetof(instance, axis_x) == 8 and offsetof(instance, axis_y) == 16); // pack_sse2 stores position and axis_x as one
+
+	struct texture_binding
+	{
+		SDL_GPUTexture *texture;
+		SDL_GPUSampler *sampler;
+	};
+
+	// Consecutive sorted instances that share layer and texture, one draw each
+	struct run
+	{
+		uint16_t texture;
+		uint32_t first_instance;
+		uint32_t instance_count;
+	};
+
+	struct batch
+	{
+		sdl3::gfx_pipeline_ptr pipeline;
+		sdl3::gpu_buffer_ptr instance_buffer;
+
+		std::vector<texture_binding> textures;
+		std::vector<sprite> sprites; // cleared by prepare
+		std::vector<run> runs;
+	};
+
+	auto init_batch(const sdl3::context &ctx) -> batch
+	{
+		msg::info("Create Sprite Batch.");
+
+		using VA                                  = SDL_GPUVertexAttribute;
+		constexpr static auto INSTANCE_ATTRIBUTES = std::array{
+			VA{
+			  .location    = 0,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+			  .offset      = 0,
+			},
+			VA{
+			  .location    = 1,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+			  .offset      = sizeof(float) * 2,
+			},
+			VA{
+			  .location    = 2,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+			  .offset      = sizeof(float) * 4,
+			},
+			VA{
+			  .location    = 3,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM,
+			  .offset      = sizeof(float) * 6,
+			},
+			VA{
+			  .location    = 4,
+			  .buffer_slot = 0,
+			  .format      = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+			  .offset      = sizeof(float) * 6 + sizeof(uint16_t) * 4,
+			},
+		};
+
+		using VBD                                   = SDL_GPUVertexBufferDescription;
+		constexpr static auto INSTANCE_BUFFER_DESCS = std::array{
+			VBD{
+			  .slot               = 0,
+			  .pitch              = sizeof(instance),
+			  .input_rate         = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+			  .instance_step_rate = 1,
+			},
+		};
+
+		auto desc = sdl3::pipeline_desc{
+			.vertex = sdl3::shader_desc{
+			  .shader_binary        = io::read_file("shaders/sprite.vs_6_4.cso"),
+			  .stage                = SDL_GPU_SHADERSTAGE_VERTEX,
+			  .uniform_buffer_count = 1,
+			},
+			.fragment = sdl3::shader_desc{
+			  .shader_binary = io::read_file(sdl3::shader_file(ctx, "textured_quad_tinted"sv, "ps_6_4"sv)),
+			  .stage         = SDL_GPU_SHADERSTAGE_FRAGMENT,
+			  .sampler_count = 1,
+			},
+			.vertex_attributes          = INSTANCE_ATTRIBUTES,
+			.vertex_buffer_descriptions = INSTANCE_BUFFER_DESCS,
+			.depth_test                 = false,
+			.cull_mode                  = sdl3::cull_mode_t::none,
+			.blend_mode                 = sdl3::blend_mode_t::alpha,
+			.queue                      = sdl3::render_queue_t::transparent,
+			.color_format               = sdl3::SWAPCHAIN_FORMAT, // drawn after post processing
+		};
+
+		auto btch     = batch{};
+		btch.pipeline = sdl3::make_gfx_pipeline(ctx, desc);
+
+		btch.instance_buffer = sdl3::make_buffer(ctx.gpu.get(), SDL_GPU_BUFFERUSAGE_VERTEX, MAX_SPRITES * sizeof(instance), "Sprite Instance Buffer"sv);
+		btch.sprites.reserve(MAX_SPRITES);
+
+		return btch;
+	}
+
+	void destroy_batch(batch &btch)
+	{
+		msg::info("Destroy Sprite Batch.");
+
+		btch = {};
+	}
+
+	// Register texture atlas sprites can use, returns id for sprite::texture
+	auto add_texture(batch &btch, SDL_GPUTexture *texture, SDL_GPUSampler *sampler) -> uint16_t
+	{
+		btch.textures.push_back({ texture, sampler });
+		return static_cast<uint16_t>(btch.textures.size() - 1);
+	}
+
+	void add(batch &btch, const sprite &spr)
+	{
+		btch.sprites.push_back(spr);
+	}
+
+	// Draw order, layer first then texture
+	constexpr auto sort_key(const sprite &spr) -> uint32_t
+	{
+		return (uint32_t{ spr.layer } << 16) | spr.texture;
+	}
+
+	constexpr auto to_unorm16(float value) -> uint16_t
+	{
+		return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+	}
+
+	// One sprite at a time
+	void pack_scalar(std::span<const sprite> src, std::span<const uint32_t> order, instance *dst)
+	{
+		for (auto idx : order)
+		{
+			auto &spr = src[idx];
+			auto c    = std::cos(spr.rotation);
+			auto s    = std::sin(spr.rotation);
+
+			*dst++ = instance{
+				.position = spr.position,
+				.axis_x   = { c * spr.scale[0], s * spr.scale[0] },
+				.axis_y   = { -s * spr.scale[1], c * spr.scale[1] },
+				.uv       = { to_unorm16(spr.uv[0]), to_unorm16(spr.uv[1]), to_unorm16(spr.uv[2]), to_unorm16(spr.uv[3]) },
+				.color    = spr.color,
+			};
+		}
+	}
+
+#if SPRITE_SSE2
+	// 4 wide sine, range reduced to [-pi/2, pi/2], then Taylor series to x^11
+	auto sin_ps(__m128 x) -> __m128
+	{
+		const auto PI         = _mm_set1_ps(std::numbers::pi_v<float>);
+		const auto INV_TWO_PI = _mm_set1_ps(0.5f / std::numbers::pi_v<float>);
+		const auto TWO_PI     = _mm_set1_ps(2.0f * std::numbers::pi_v<float>);
+		const auto SIGN_MASK  = _mm_set1_ps(-0.0f);
+
+		// Wrap to [-pi, pi]
+		auto turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, INV_TWO_PI)));
+		x          = _mm_sub_ps(x, _mm_mul_ps(turns, TWO_PI));
+
+		// sin(x) = sin(pi - x), folds [pi/2, pi] on to [0, pi/2], sign is kept
+		auto sign = _mm_and_ps(x, SIGN_MASK);
+		auto ax   = _mm_andnot_ps(SIGN_MASK, x);
+		x         = _mm_or_ps(_mm_min_ps(ax, _mm_sub_ps(PI, ax)), sign);
+
+		auto x2 = _mm_mul_ps(x, x);
+		auto p  = _mm_set1_ps(-2.5052108e-8f); // -1/11!
+		p       = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319e-6f));
+		p       = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841270e-4f));
+		p       = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333e-3f));
+		p       = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666667e-1f));
+		p       = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+		return _mm_mul_ps(x, p);
+	}
+
+	// u0, v0, u1, v1 to unorm16, SSE2 only has signed saturation so values are biased around zero
+	auto pack_uv(const std::array<float, 4> &uv) -> __m128i
+	{
+		auto v = _mm_loadu_ps(uv.data());
+		v      = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+		auto i = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(65535.0f)));
+		i      = _mm_sub_epi32(i, _mm_set1_epi32(32768));
+		i      = _mm_packs_epi32(i, i);
+		return _mm_xor_si128(i, _mm_set1_epi16(static_cast<short>(0x8000)));
+	}
+
+	// Four sprites at a time, rotation axes computed as SoA then transposed in to instances
+	void pack_sse2(std::span<const sprite> src, std::span<const uint32_t> order, instance *dst)
+	{
+		const auto HALF_PI = _mm_set1_ps(0.5f * std::numbers::pi_v<float>);
+
+		auto count  = order.size();
+		auto blocks = count / 4;
+
+		for (auto b : std::views::iota(size_t{ 0 }, blocks))
+		{
+			auto &s0 = src[order[b * 4 + 0]];
+			auto &s1 = src[order[b * 4 + 1]];
+			auto &s2 = src[order[b * 4 + 2]];
+			auto &s3 = src[order[b * 4 + 3]];
+
+			auto px  = _mm_setr_ps(s0.position[0], s1.position[0], s2.position[0], s3.position[0]);
+			auto py  = _mm_setr_ps(s0.position[1], s1.position[1], s2.position[1], s3.position[1]);
+			auto rot = _mm_setr_ps(s0.rotation, s1.rotation, s2.rotation, s3.rotation);
+			auto sx  = _mm_setr_ps(s0.scale[0], s1.scale[0], s2.scale[0], s3.scale[0]);
+			auto sy  = _mm_setr_ps(s0.scale[1], s1.scale[1], s2.scale[1], s3.scale[1]);
+
+			auto s = sin_ps(rot);
+			auto c = sin_ps(_mm_add_ps(rot, HALF_PI));
+
+			auto axx = _mm_mul_ps(c, sx);
+			auto axy = _mm_mul_ps(s, sx);
+			auto ayx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(s, sy));
+			auto ayy = _mm_mul_ps(c, sy);
+
+			// Interleave pairs, lo holds sprites 0 and 1, hi holds sprites 2 and 3
+			auto p_lo  = _mm_unpacklo_ps(px, py);
+			auto p_hi  = _mm_unpackhi_ps(px, py);
+			auto ax_lo = _mm_unpacklo_ps(axx, axy);
+			auto ax_hi = _mm_unpackhi_ps(axx, axy);
+			auto ay_lo = _mm_unpacklo_ps(ayx, ayy);
+			auto ay_hi = _mm_unpackhi_ps(ayx, ayy);
+
+			// Position and axis_x are stored together, through whole instance so store doesn't overrun a member
+			auto out = dst + b * 4;
+
+			_mm_storeu_ps(reinterpret_cast<float *>(&out[0]), _mm_movelh_ps(p_lo, ax_lo));
+			_mm_storel_pi(reinterpret_cast<__m64 *>(out[0].axis_y.data()), ay_lo);
+			_mm_storeu_ps(reinterpret_cast<float *>(&out[1]), _mm_movehl_ps(ax_lo, p_lo));
+			_mm_storeh_pi(reinterpret_cast<__m64 *>(out[1].axis_y.data()), ay_lo);
+			_mm_storeu_ps(reinterpret_cast<float *>(&out[2]), _mm_movelh_ps(p_hi, ax_hi));
+			_mm_storel_pi(reinterpret_cast<__m64 *>(out[2].axis_y.data()), ay_hi);
+			_mm_storeu_ps(reinterpret_cast<float *>(&out[3]), _mm_movehl_ps(ax_hi, p_hi));
+			_mm_storeh_pi(reinterpret_cast<__m64 *>(out[3].axis_y.data()), ay_hi);
+
+			auto block = std::array{ &s0, &s1, &s2, &s3 };
+			for (auto i : std::views::iota(0, 4))
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(out[i].uv.data()), pack_uv(block[i]->uv));
+				out[i].color = block[i]->color;
+			}
+		}
+
+		// Remainder
+		pack_scalar(src, order.subspan(blocks * 4), dst + blocks * 4);
+	}
+#endif
+
+	// Sort this frame's sprites, pack them in to upload ring, and build draw runs.
+	// Must be called before sdl3::begin_frame.
+	void prepare(const sdl3::context &ctx, batch &btch, sdl3::scene &scn)
+	{
+		btch.runs.clear();
+
+		auto &queued = btch.sprites;
+		if (queued.empty())
+			return;
+
+		if (queued.size() > MAX_SPRITES)
+		{
+			msg::error(false, "Too many sprites this frame, extra sprites are dropped.");
+			queued.resize(MAX_SPRITES);
+		}
+
+		auto keys = queued
+		          | std::views::transform(sort_key)
+		          | std::ranges::to<std::vector>();
+
+		// Common case of one layer and texture needs no sort
+		auto order = std::vector<uint32_t>{};
+		if (std::ranges::is_sorted(keys))
+		{
+			order.resize(keys.size());
+			std::iota(order.begin(), order.end(), 0u);
+		}
+		else
+		{
+			order = sort::radix_sort(keys);
+		}
+
+		auto count = static_cast<uint32_t>(queued.size());
+		auto dst   = sdl3::reserve_upload(ctx.gpu.get(), scn.uploads, count * sizeof(instance), btch.instance_buffer.get(), 0, true);
+		if (dst.empty())
+		{
+			queued.clear();
+			return;
+		}
+
+		auto instances = reinterpret_cast<instance *>(dst.data());
+#if SPRITE_SSE2
+		pack_sse2(queued, order, instances);
+#else
+		pack_scalar(queued, order, instances);
+#endif
+
+		for (auto &&[i, idx] : order | std::views::enumerate)
+		{
+			auto first = static_cast<uint32_t>(i);
+			if (btch.runs.empty() or keys[order[first - 1]] != keys[idx])
+			{
+				btch.runs.push_back({
+				  .texture        = queued[idx].texture,
+				  .first_instance = first,
+				  .instance_count = 0,
+				});
+			}
+			++btch.runs.back().instance_count;
+		}
+
+		queued.clear();
+	}
+
+	// Draw this frame's sprites on top of swapchain image
+	void draw(sdl3::frame_context &frm, const batch &btch)
+	{
+		if (btch.runs.empty())
+			return;
+
+		auto screen_size = std::array{
+			static_cast<float>(frm.width),
+			static_cast<float>(frm.height),
+			0.0f,
+			0.0f,
+		};
+		SDL_PushGPUVertexUniformData(frm.cmd_buf, 0, screen_size.data(), static_cast<uint32_t>(sizeof(screen_size)));
+
+		auto color_target = SDL_GPUColorTargetInfo{
+			.texture  = frm.swapchain,
+			.load_op  = SDL_GPU_LOADOP_LOAD,
+			.store_op = SDL_GPU_STOREOP_STORE,
+		};
+
+		auto render_pass = SDL_BeginGPURenderPass(frm.cmd_buf, &color_target, 1, nullptr);
+		{
+			auto instance_binding = SDL_GPUBufferBinding{
+				.buffer = btch.instance_buffer.get(),
+				.offset = 0,
+			};
+			SDL_BindGPUVertexBuffers(render_pass, 0, &instance_binding, 1);
+			SDL_BindGPUGraphicsPipeline(render_pass, btch.pipeline.get());
+
+			auto bound_texture = std::numeric_limits<uint32_t>::max();
+			for (auto &&r : btch.runs)
+			{
+				if (r.texture != bound_texture)
+				{
+					auto &tex            = btch.textures.at(r.texture);
+					auto sampler_binding = SDL_GPUTextureSamplerBinding{
+						.texture = tex.texture,
+						.sampler = tex.sampler,
+					};
+					SDL_BindGPUFragmentSamplers(render_pass, 0, &sampler_binding, 1);
+					bound_texture = r.texture;
+				}
+
+				// 6 vertices per sprite, made in vertex shader
+				SDL_DrawGPUPrimitives(render_pass, 6, r.instance_count, 0, r.first_instance);
+				++frm.draw_calls;
+			}
+		}
+		SDL_EndGPURenderPass(render_pass);
+	}
+}
@@ -0,0 +1,162 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module tiled_export;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import sdl3_postfx;
+import scenario;
+import batch;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * Export of images larger than a render target can be, rendered as grid of off-center tiles.
+ * Tiles are written in to their place in output file as they arrive,
+ * so memory holds only tiles in flight, whatever size the image is.
+ */
+export namespace tiled
+{
+	// Tiles read back, but not yet written, before render loop waits for writer
+	constexpr auto MAX_QUEUED_TILES = 2u;
+
+	struct export_desc
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t tile_size; // context must render at this size
+		std::filesystem::path output;
+	};
+
+	// Uncompressed PAM (P7) RGBA file, rows are at fixed offsets so tiles can be written in any order.
+	// PNG and QOI only stream top to bottom, and would need a whole row of tiles in memory.
+	struct pam_file
+	{
+		std::ofstream stream;
+		uint64_t header_size;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	auto open_pam(const std::filesystem::path &filename, uint32_t width, uint32_t height) -> pam_file
+	{
+		auto header = std::format("P7\nWIDTH {}\nHEIGHT {}\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", width, height);
+
+		auto file = pam_file{
+			.stream      = std::ofstream(filename, std::ios::out | std::ios::binary | std::ios::trunc),
+			.header_size = header.size(),
+			.width       = width,
+			.height      = height,
+		};
+		msg::error(file.stream.good(), "Failed to create export file.");
+
+		file.stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+		return file;
+	}
+
+	// Copy tile's rows that fall inside image in to file
+	auto write_tile(pam_file &file, const scenario::tile_view &tile, io::byte_span rgba) -> bool
+	{
+		constexpr auto PIXEL_SIZE = uint64_t{ 4 };
+
+		auto columns = std::min(tile.width, file.width - tile.x);
+		auto rows    = std::min(tile.height, file.height - tile.y);
+
+		for (auto row : std::views::iota(0u, rows))
+		{
+			auto offset = file.header_size + ((uint64_t{ tile.y } + row) * file.width + tile.x) * PIXEL_SIZE;
+			auto src    = rgba.subspan(uint64_t{ row } * tile.width * PIXEL_SIZE, columns * PIXEL_SIZE);
+
+			file.stream.seekp(static_cast<std::streamoff>(offset));
+			file.stream.write(reinterpret_cast<const char *>(src.data()), static_cast<std::streamsize>(src.size()));
+		}
+
+		return file.stream.good();
+	}
+
+	// Tiles in row major order, covering whole image
+	auto make_tiles(const export_desc &desc) -> std::vector<scenario::tile_view>
+	{
+		auto columns = (desc.width + desc.tile_size - 1) / desc.tile_size;
+		auto rows    = (desc.height + desc.tile_size - 1) / desc.tile_size;
+
+		return std::views::cartesian_product(std::views::iota(0u, rows), std::views::iota(0u, columns))
+		     | std::views::transform([&](auto row_column) {
+				   auto [row, column] = row_column;
+				   return scenario::tile_view{
+					   .image_width  = desc.width,
+					   .image_height = desc.height,
+					   .x            = column * desc.tile_size,
+					   .y            = row * desc.tile_size,
+					   .width        = desc.tile_size,
+					   .height       = desc.tile_size,
+				   };
+			   })
+		     | std::ranges::to<std::vector>();
+	}
+
+	// Render running scenario's view as one large image, scenario has to implement set_tile
+	auto render(const sdl3::context &ctx, scenario::running &run, postfx::chain &fx, const export_desc &desc) -> bool
+	{
+		auto [width, height] = sdl3::render_size(ctx);
+		msg::error(width == desc.tile_size and height == desc.tile_size, "Context render size must match tile size.");
+
+		if (not run.fn.set_tile)
+		{
+			msg::info("Scenario doesn't support tiled export.");
+			return false;
+		}
+
+		auto tiles = make_tiles(desc);
+		msg::info(std::format("Export: {}x{}, {} tiles of {}x{}, to {}.",
+		                      desc.width, desc.height, tiles.size(), desc.tile_size, desc.tile_size, desc.output.string()));
+
+		// Bloom spreads light across tile edges, each tile would blur only it's own pixels and show seams.
+		// FXAA and SMAA read neighbours as well, MSAA stays on as it works within each pixel.
+		auto bloom        = std::exchange(fx.config.bloom, false);
+		auto antialiasing = std::exchange(fx.config.antialiasing, postfx::antialiasing_t::none);
+		auto file         = open_pam(desc.output, desc.width, desc.height);
+		auto write_ok     = std::atomic<bool>{ true };
+		auto tiles_saved  = std::atomic<uint32_t>{ 0 };
+
+		// One writer, so file is only touched by one thread
+		auto writer = batch::worker_pool{};
+		batch::start_workers(writer, 1);
+
+		auto setup = [&](size_t i) {
+			run.fn.set_tile(tiles[i]);
+		};
+
+		auto deliver = [&](size_t i, sdl3::readback &&image) {
+			auto write_task = [&, i, image = std::move(image)] {
+				if (write_tile(file, tiles[i], image.data))
+					++tiles_saved;
+				else
+					write_ok = false;
+			};
+			batch::submit(writer, std::move(write_task), MAX_QUEUED_TILES);
+		};
+
+		auto start_ns = SDL_GetTicksNS();
+		auto failed   = batch::render_offscreen(ctx, run, fx, tiles.size(), setup, deliver);
+
+		batch::wait_idle(writer);
+		batch::stop_workers(writer);
+		file.stream.close();
+
+		fx.config.bloom        = bloom;
+		fx.config.antialiasing = antialiasing;
+
+		auto seconds = static_cast<double>(SDL_GetTicksNS() - start_ns) / 1'000'000'000.0;
+		msg::info(std::format("Export: {} tiles written in {:.2f} s, {} failed.", tiles_saved.load(), seconds, failed));
+
+		return write_ok and failed == 0;
+	}
+}
@@ -0,0 +1,628 @@
+module;
+
+// SDL 3 header
+#include <SDL3/SDL.h>
+
+export module world_partition;
+
+import std;
+import logs;
+import io;
+import sdl3_init;
+import sdl3_scene;
+import batch;
+import buffer_pool;
+
+// literal suffixes for strings, string_view, etc
+using namespace std::literals;
+
+/*
+ * World divided in to square cells on XZ plane, each with it's own bundle file of instances.
+ * Cells near camera are read on worker threads, and copied in to a shared instance pool a few per frame.
+ * Cells left behind give their range back. Unload radius is larger than load radius,
+ * so a camera moving along a cell border doesn't load and unload same cells over and over.
+ */
+export namespace world
+{
+	// "CELL", little endian
+	constexpr auto BUNDLE_MAGIC   = uint32_t{ 0x4C4C4543 };
+	constexpr auto BUNDLE_VERSION = uint32_t{ 1 };
+
+	// Column major, as instanced_mesh.vs reads it
+	using transform = std::array<float, 16>;
+
+	// Start of every cell bundle file, instance_count transforms follow it
+	struct bundle_header
+	{
+		uint32_t magic;
+		uint32_t version;
+		int32_t cell_x;
+		int32_t cell_z;
+		uint32_t instance_count;
+		std::array<uint32_t, 3> reserved;
+	};
+	static_assert(sizeof(bundle_header) == 32);
+
+	struct cell_coord
+	{
+		int32_t x;
+		int32_t z;
+
+		auto operator<=>(const cell_coord &) const = default;
+	};
+
+	struct partition_desc
+	{
+		std::filesystem::path directory; // bundle files, cell_<x>_<z>.bin
+		int32_t cells_per_side         = 64;    // square world centred on origin
+		float cell_size                = 16.0f;
+		float load_radius              = 56.0f; // cells with centre this close to camera start loading
+		float unload_radius            = 80.0f; // and are dropped once it's further than this
+		uint32_t loader_threads        = 2;
+		uint32_t max_loads_in_flight   = 8;
+		uint32_t max_prefetch_in_flight = 4;    // prefetches never take more than this of max_loads_in_flight
+		float prefetch_seconds          = 0.5f; // how far ahead camera path is predicted
+		uint32_t prefetch_steps         = 5;    // points along predicted path cells are gathered around
+		uint32_t max_uploads_per_frame = 2; // bounds staging memory and copy time cell arrivals add to a frame
+		uint32_t pool_capacity         = 16 * 1024 * 1024;
+	};
+
+	enum class cell_state : uint8_t
+	{
+		loading,  // bundle being read on a worker
+		loaded,   // read, waiting for it's turn to upload
+		resident, // in instance pool, drawn
+		missing,  // bundle couldn't be read, not retried until cell unloads
+	};
+
+	struct cell
+	{
+		cell_state state;
+		bool cancelled  = false;          // no longer wanted while loading, dropped when read finishes
+		bool prefetched = false;          // loaded for predicted path, camera hasn't come near yet
+		std::stop_source stop;            // read not yet started is skipped once stop is requested
+		std::vector<transform> instances; // only held between load and upload
+		std::optional<pool::range> range;
+	};
+
+	struct stats
+	{
+		uint32_t loads;
+		uint32_t unloads;
+		uint32_t cancelled; // reads that finished after cell was no longer wanted
+		uint32_t failed;
+		uint32_t pool_full; // frames an upload waited for pool space
+
+		uint32_t demand_misses;      // cells camera came near that nothing had asked for
+		uint32_t prefetch_issued;
+		uint32_t prefetch_hits;      // prefetched cells already read when camera came near
+		uint32_t prefetch_late;      // prefetched cells still being read when camera came near
+		uint32_t prefetch_cancelled; // prefetches dropped because prediction moved away from them
+	};
+
+	// Camera as given to projection, sampled once per frame
+	struct camera_sample
+	{
+		std::array<float, 3> position;
+		float heading; // radians around y, 0 looks along +z
+		float seconds; // time sample was taken
+	};
+
+	// Camera samples velocity and turn rate are measured over
+	constexpr auto MOTION_HISTORY = 8u;
+
+	struct motion_predictor
+	{
+		std::deque<camera_sample> samples;
+	};
+
+	struct partition
+	{
+		struct loaded_bundle
+		{
+			cell_coord coord;
+			std::optional<std::vector<transform>> instances;
+			bool skipped; // stop was requested before read started
+		};
+
+		partition_desc desc;
+		pool::buffer_pool instances;
+		std::map<cell_coord, cell> cells;
+		uint32_t loads_in_flight = 0;
+		motion_predictor motion;
+		stats counters = {};
+
+		// Workers push finished reads here, update takes them every frame
+		batch::worker_pool loaders;
+		std::mutex finished_lock;
+		std::vector<loaded_bundle> finished;
+	};
+
+	auto bundle_path(const partition_desc &desc, cell_coord coord) -> std::filesystem::path
+	{
+		return desc.directory / std::format("cell_{}_{}.bin", coord.x, coord.z);
+	}
+
+	// Centre of cell on XZ plane
+	auto cell_center(const partition_desc &desc, cell_coord coord) -> std::array<float, 2>
+	{
+		return {
+			(static_cast<float>(coord.x) + 0.5f) * desc.cell_size,
+			(static_cast<float>(coord.z) + 0.5f) * desc.cell_size,
+		};
+	}
+
+	auto cell_distance(const partition_desc &desc, cell_coord coord, std::array<float, 3> position) -> float
+	{
+		auto [cx, cz] = cell_center(desc, coord);
+		return std::hypot(cx - position[0], cz - position[2]);
+	}
+
+	// Bundle file's instances, nothing if file is missing or isn't a bundle for this cell.
+	// Doesn't log, it's called from worker threads.
+	auto read_bundle(const std::filesystem::path &filename, cell_coord coord) -> std::optional<std::vector<transform>>
+	{
+		auto file = std::ifstream(filename, std::ios::in | std::ios::binary);
+		if (not file.good())
+			return std::nullopt;
+
+		auto header = bundle_header{};
+		file.read(reinterpret_cast<char *>(&header), sizeof(header));
+		if (not file.good() or header.magic != BUNDLE_MAGIC or header.version != BUNDLE_VERSION
+		    or header.cell_x != coord.x or header.cell_z != coord.z)
+			return std::nullopt;
+
+		auto instances = std::vector<transform>(header.instance_count);
+		file.read(reinterpret_cast<char *>(instances.data()), static_cast<std::streamsize>(instances.size() * sizeof(transform)));
+		if (not file.good())
+			return std::nullopt;
+
+		return instances;
+	}
+
+	auto write_bundle(const std::filesystem::path &filename, cell_coord coord, std::span<const transform> instances) -> bool
+	{
+		auto header = bundle_header{
+			.magic          = BUNDLE_MAGIC,
+			.version        = BUNDLE_VERSION,
+			.cell_x         = coord.x,
+			.cell_z         = coord.z,
+			.instance_count = static_cast<uint32_t>(instances.size()),
+			.reserved       = {},
+		};
+
+		auto bytes = io::byte_array{};
+		bytes.reserve(sizeof(header) + instances.size_bytes());
+		std::ranges::copy(io::as_byte_span(header), std::back_inserter(bytes));
+		std::ranges::copy(std::as_bytes(instances), std::back_inserter(bytes));
+
+		return io::write_file(filename, bytes);
+	}
+
+	// City block of boxes on an 8x8 lot grid, some lots left empty. Same cell and seed always give same boxes.
+	auto generate_cell(const partition_desc &desc, cell_coord coord, uint32_t seed) -> std::vector<transform>
+	{
+		constexpr auto LOTS = 8;
+
+		auto rng       = std::mt19937{ seed ^ (static_cast<uint32_t>(coord.x) * 73856093u) ^ (static_cast<uint32_t>(coord.z) * 19349663u) };
+		auto unit      = std::uniform_real_distribution<float>{ 0.0f, 1.0f };
+		auto lot_size  = desc.cell_size / LOTS;
+		auto cell_x0   = static_cast<float>(coord.x) * desc.cell_size;
+		auto cell_z0   = static_cast<float>(coord.z) * desc.cell_size;
+		auto instances = std::vector<transform>{};
+
+		for (auto [row, column] : std::views::cartesian_product(std::views::iota(0, LOTS), std::views::iota(0, LOTS)))
+		{
+			if (unit(rng) < 0.25f)
+				continue;
+
+			auto width  = lot_size * (0.5f + 0.4f * unit(rng));
+			auto depth  = lot_size * (0.5f + 0.4f * unit(rng));
+			auto height = 0.5f + 6.0f * unit(rng) * unit(rng);
+			auto x      = cell_x0 + (static_cast<float>(column) + 0.5f) * lot_size;
+			auto z      = cell_z0 + (static_cast<float>(row) + 0.5f) * lot_size;
+
+			// Unit cube scaled, then moved so it stands on y = 0
+			instances.push_back(transform{
+			  width, 0.0f, 0.0f, 0.0f,
+			  0.0f, height, 0.0f, 0.0f,
+			  0.0f, 0.0f, depth, 0.0f,
+			  x, 0.5f * height, z, 1.0f,
+			});
+		}
+
+		return instances;
+	}
+
+	// Write bundles for every cell that doesn't have one yet, stands in for an offline asset build.
+	// Returns number of bundles written.
+	auto bake_world(const partition_desc &desc, uint32_t seed) -> uint32_t
+	{
+		std::filesystem::create_directories(desc.directory);
+
+		auto half    = desc.cells_per_side / 2;
+		auto written = std::atomic<uint32_t>{ 0 };
+		auto failed  = std::atomic<uint32_t>{ 0 };
+
+		auto bakers = batch::worker_pool{};
+		batch::start_workers(bakers, std::max(std::thread::hardware_concurrency(), 1u));
+
+		for (auto [z, x] : std::views::cartesian_product(std::views::iota(-half, half), std::views::iota(-half, half)))
+		{
+			auto coord    = cell_coord{ x, z };
+			auto filename = bundle_path(desc, coord);
+			if (std::filesystem::exists(filename))
+				continue;
+
+			batch::submit(bakers, [&, coord, filename] {
+				if (write_bundle(filename, coord, generate_cell(desc, coord, seed)))
+					++written;
+				else
+					++failed;
+			}, 64);
+		}
+
+		batch::wait_idle(bakers);
+		batch::stop_workers(bakers);
+
+		msg::error(failed == 0, "Failed to write world cell bundles.");
+		if (written > 0)
+			msg::info(std::format("World: baked {} cell bundles in to {}.", written.load(), desc.directory.string()));
+		return written;
+	}
+
+	// Partition holds a mutex and threads, so it stays where it's made
+	auto make_partition(const sdl3::context &ctx, const partition_desc &desc) -> std::unique_ptr<partition>
+	{
+		msg::error(desc.unload_radius > desc.load_radius, "Unload radius must be larger than load radius.");
+
+		auto prt       = std::make_unique<partition>();
+		prt->desc      = desc;
+		prt->instances = pool::make_buffer_pool(ctx.gpu.get(), SDL_GPU_BUFFERUSAGE_VERTEX, desc.pool_capacity, "World Instance Pool"sv);
+		batch::start_workers(prt->loaders, desc.loader_threads);
+
+		return prt;
+	}
+
+	void add_sample(motion_predictor &pred, const camera_sample &sample)
+	{
+		pred.samples.push_back(sample);
+		if (pred.samples.size() > MOTION_HISTORY)
+			pred.samples.pop_front();
+	}
+
+	// Camera path over next seconds, in steps evenly spaced points.
+	// Extrapolated at constant speed and turn rate, so a turning camera is followed along it's arc.
+	// Empty while camera isn't moving.
+	auto predict_path(const motion_predictor &pred, float seconds, uint32_t steps) -> std::vector<std::array<float, 3>>
+	{
+		if (pred.samples.size() < 2)
+			return {};
+
+		auto &first   = pred.samples.front();
+		auto &last    = pred.samples.back();
+		auto duration = last.seconds - first.seconds;
+		if (duration <= 0.0f)
+			return {};
+
+		auto vx    = (last.position[0] - first.position[0]) / duration;
+		auto vz    = (last.position[2] - first.position[2]) / duration;
+		auto speed = std::hypot(vx, vz);
+		if (speed == 0.0f)
+			return {};
+
+		// Travel direction comes from velocity, camera may look elsewhere, only it's turning is taken from heading.
+		// Average velocity points along middle of sample window, so it's turned on to last sample.
+		auto turn_rate = std::remainder(last.heading - first.heading, 2.0f * std::numbers::pi_v<float>) / duration;
+		auto direction = std::atan2(vx, vz) + 0.5f * turn_rate * duration;
+
+		return std::views::iota(1u, steps + 1)
+		     | std::views::transform([&](uint32_t i) {
+				   auto t = seconds * static_cast<float>(i) / static_cast<float>(steps);
+
+				   // Straight line when barely turning, arc of radius speed / turn_rate otherwise
+				   auto dx = speed * t * std::sinf(direction);
+				   auto dz = speed * t * std::cosf(direction);
+				   if (std::abs(turn_rate * t) > 1e-3f)
+				   {
+					   auto radius = speed / turn_rate;
+					   dx          = radius * (std::cosf(direction) - std::cosf(direction + turn_rate * t));
+					   dz          = radius * (std::sinf(direction + turn_rate * t) - std::sinf(direction));
+				   }
+
+				   return std::array{ last.position[0] + dx, last.position[1], last.position[2] + dz };
+			   })
+		     | std::ranges::to<std::vector>();
+	}
+
+	// Cells with centre inside load radius of position, nearest first
+	auto cells_around(const partition_desc &desc, std::array<float, 3> position) -> std::vector<std::pair<float, cell_coord>>
+	{
+		auto half  = desc.cells_per_side / 2;
+		auto reach = static_cast<int32_t>(std::ceil(desc.load_radius / desc.cell_size));
+		auto cx    = static_cast<int32_t>(std::floor(position[0] / desc.cell_size));
+		auto cz    = static_cast<int32_t>(std::floor(position[2] / desc.cell_size));
+
+		auto found = std::vector<std::pair<float, cell_coord>>{};
+		for (auto z : std::views::iota(std::max(cz - reach, -half), std::min(cz + reach + 1, half)))
+		{
+			for (auto x : std::views::iota(std::max(cx - reach, -half), std::min(cx + reach + 1, half)))
+			{
+				auto coord    = cell_coord{ x, z };
+				auto distance = cell_distance(desc, coord, position);
+				if (distance <= desc.load_radius)
+					found.emplace_back(distance, coord);
+			}
+		}
+		std::ranges::sort(found);
+
+		return found;
+	}
+
+	// Cells around predicted path, in order camera is expected to reach them
+	auto predicted_cells(const partition &prt, std::span<const std::array<float, 3>> path) -> std::vector<cell_coord>
+	{
+		auto result = std::vector<cell_coord>{};
+		for (auto &&point : path)
+		{
+			for (auto &&[distance, coord] : cells_around(prt.desc, point))
+			{
+				if (std::ranges::find(result, coord) == result.end())
+					result.push_back(coord);
+			}
+		}
+		return result;
+	}
+
+	// Demand loads go ahead of queued prefetches, camera is already waiting for them
+	void start_load(partition &prt, cell_coord coord, bool prefetch)
+	{
+		auto &c      = prt.cells[coord];
+		c            = cell{ .state = cell_state::loading };
+		c.prefetched = prefetch;
+		++prt.loads_in_flight;
+
+		auto load_task = [&prt, coord, filename = bundle_path(prt.desc, coord), stop = c.stop.get_token()] {
+			auto bundle = partition::loaded_bundle{
+				.coord   = coord,
+				.skipped = stop.stop_requested(),
+			};
+			if (not bundle.skipped)
+				bundle.instances = read_bundle(filename, coord);
+
+			auto lk = std::scoped_lock{ prt.finished_lock };
+			prt.finished.push_back(std::move(bundle));
+		};
+
+		if (prefetch)
+			batch::submit(prt.loaders, std::move(load_task), prt.desc.max_loads_in_flight);
+		else
+			batch::submit_first(prt.loaders, std::move(load_task));
+	}
+
+	// Stop read of a cell that's no longer wanted, it's erased when worker hands it back
+	void cancel_load(partition &prt, cell &c)
+	{
+		// No longer a prefetch, so camera coming near it later isn't also counted as a late prefetch
+		if (c.prefetched)
+			++prt.counters.prefetch_cancelled;
+		c.prefetched = false;
+
+		c.cancelled = true;
+		c.stop.request_stop();
+	}
+
+	// Take reads workers have finished since last frame
+	void collect_loads(partition &prt)
+	{
+		auto finished = std::vector<partition::loaded_bundle>{};
+		{
+			auto lk = std::scoped_lock{ prt.finished_lock };
+			std::swap(finished, prt.finished);
+		}
+
+		for (auto &&bundle : finished)
+		{
+			--prt.loads_in_flight;
+
+			// Skipped read of a cell that was wanted again in the meantime is erased as well, and started over
+			auto it = prt.cells.find(bundle.coord);
+			if (it->second.cancelled or bundle.skipped)
+			{
+				prt.cells.erase(it);
+				++prt.counters.cancelled;
+				continue;
+			}
+
+			if (not bundle.instances)
+			{
+				it->second.state = cell_state::missing;
+				++prt.counters.failed;
+				continue;
+			}
+
+			it->second.state     = cell_state::loaded;
+			it->second.instances = std::move(*bundle.instances);
+			++prt.counters.loads;
+		}
+	}
+
+	// Drop cells beyond unload radius that aren't on predicted path, and prefetches prediction has moved away from.
+	// Pool range is given back once frames drawing it have finished.
+	void unload_far_cells(partition &prt, std::array<float, 3> position, std::span<const cell_coord> predicted, uint64_t frame_index)
+	{
+		for (auto it = prt.cells.begin(); it != prt.cells.end();)
+		{
+			auto &[coord, c] = *it;
+			auto distance    = cell_distance(prt.desc, coord, position);
+			auto on_path     = std::ranges::find(predicted, coord) != predicted.end();
+
+			if (c.state == cell_state::loading)
+			{
+				auto stale_prefetch = c.prefetched and not on_path and distance > prt.desc.load_radius;
+				auto too_far        = not on_path and distance > prt.desc.unload_radius;
+				if (not c.cancelled and (stale_prefetch or too_far))
+					cancel_load(prt, c);
+
+				++it;
+				continue;
+			}
+
+			if (on_path or distance <= prt.desc.unload_radius)
+			{
+				++it;
+				continue;
+			}
+
+			if (c.range)
+			{
+				pool::retire(prt.instances, *c.range, frame_index);
+				++prt.counters.unloads;
+			}
+			it = prt.cells.erase(it);
+		}
+	}
+
+	// Start reads for cells inside load radius, nearest first
+	void load_near_cells(partition &prt, std::array<float, 3> position)
+	{
+		for (auto &&[distance, coord] : cells_around(prt.desc, position))
+		{
+			auto it = prt.cells.find(coord);
+			if (it == prt.cells.end())
+			{
+				if (prt.loads_in_flight >= prt.desc.max_loads_in_flight)
+					continue;
+
+				start_load(prt, coord, false);
+				++prt.counters.demand_misses;
+				continue;
+			}
+
+			auto &c = it->second;
+			if (c.prefetched)
+			{
+				if (c.state == cell_state::loading)
+					++prt.counters.prefetch_late;
+				else
+					++prt.counters.prefetch_hits;
+				c.prefetched = false;
+			}
+
+			// Came back in to range before it's read finished, read goes ahead unless it was already skipped
+			c.cancelled = false;
+		}
+	}
+
+	// Low priority reads for cells on predicted path, only with load slots demand hasn't taken
+	void prefetch_path_cells(partition &prt, std::span<const cell_coord> predicted)
+	{
+		auto prefetching = static_cast<uint32_t>(std::ranges::count_if(prt.cells | std::views::values, [](const cell &c) {
+			return c.prefetched and c.state == cell_state::loading and not c.cancelled;
+		}));
+
+		for (auto &&coord : predicted)
+		{
+			if (prefetching >= prt.desc.max_prefetch_in_flight or prt.loads_in_flight >= prt.desc.max_loads_in_flight)
+				break;
+
+			if (prt.cells.contains(coord))
+				continue;
+
+			start_load(prt, coord, true);
+			++prt.counters.prefetch_issued;
+			++prefetching;
+		}
+	}
+
+	// Copy up to max_uploads_per_frame loaded cells in to instance pool, nearest first
+	void upload_loaded_cells(const sdl3::context &ctx, sdl3::scene &scn, partition &prt, std::array<float, 3> position)
+	{
+		auto ready = prt.cells
+		           | std::views::filter([](auto &&entry) { return entry.second.state == cell_state::loaded; })
+		           | std::views::transform([&](auto &&entry) { return std::pair{ cell_distance(prt.desc, entry.first, position), entry.first }; })
+		           | std::ranges::to<std::vector>();
+		std::ranges::sort(ready);
+
+		for (auto &&[distance, coord] : ready | std::views::take(prt.desc.max_uploads_per_frame))
+		{
+			auto &c   = prt.cells.at(coord);
+			auto size = static_cast<uint32_t>(c.instances.size() * sizeof(transform));
+
+			// Empty cell has nothing to draw
+			if (size == 0)
+			{
+				c.state = cell_state::resident;
+				continue;
+			}
+
+			auto rng = pool::allocate(prt.instances.allocator, size, sizeof(transform));
+			if (not rng)
+			{
+				// Frames in flight may still hold ranges of cells that left, try again next frame
+				++prt.counters.pool_full;
+				break;
+			}
+
+			if (not pool::upload(ctx.gpu.get(), scn.uploads, prt.instances, *rng, io::as_byte_span(c.instances)))
+			{
+				pool::release(prt.instances.allocator, *rng);
+				break;
+			}
+
+			c.range = rng;
+			c.state = cell_state::resident;
+			c.instances.clear();
+			c.instances.shrink_to_fit();
+		}
+	}
+
+	// Stream cells around camera position, and give scene this frame's resident ranges to draw.
+	// Call once per frame, before begin_frame.
+	void update(const sdl3::context &ctx, sdl3::scene &scn, partition &prt, const camera_sample &camera)
+	{
+		auto position = camera.position;
+
+		add_sample(prt.motion, camera);
+		auto path      = predict_path(prt.motion, prt.desc.prefetch_seconds, prt.desc.prefetch_steps);
+		auto predicted = predicted_cells(prt, path);
+
+		pool::reclaim(prt.instances, scn.timeline.completed_count);
+
+		collect_loads(prt);
+		unload_far_cells(prt, position, predicted, scn.timeline.frame_index);
+		load_near_cells(prt, position);
+		prefetch_path_cells(prt, predicted);
+		upload_loaded_cells(ctx, scn, prt, position);
+
+		scn.streamed_instance_buffer = prt.instances.buffer.get();
+		scn.streamed_instances       = prt.cells
+		                       | std::views::values
+		                       | std::views::filter([](const cell &c) { return c.range.has_value(); })
+		                       | std::views::transform([](const cell &c) {
+				                     return sdl3::instance_range{
+					                     .first = c.range->offset / static_cast<uint32_t>(sizeof(transform)),
+					                     .count = c.range->size / static_cast<uint32_t>(sizeof(transform)),
+				                     };
+			                     })
+		                       | std::ranges::to<std::vector>();
+	}
+
+	// Wait for reads in flight, scene must no longer reference pool
+	void destroy_partition(partition &prt)
+	{
+		batch::wait_idle(prt.loaders);
+		batch::stop_workers(prt.loaders);
+
+		auto &cnt = prt.counters;
+		msg::info(std::format("World: {} cells loaded, {} unloaded, {} cancelled, {} failed, pool full {} times.",
+		                      cnt.loads, cnt.unloads, cnt.cancelled, cnt.failed, cnt.pool_full));
+
+		// Hit rate is over every cell camera came near, cells nothing prefetched count as misses
+		auto wanted = cnt.prefetch_hits + cnt.prefetch_late + cnt.demand_misses;
+		auto rate   = [&](uint32_t count) { return wanted > 0 ? 100.0 * count / wanted : 0.0; };
+		msg::info(std::format("Prefetch: {} issued, {} cancelled. Hit {:.1f}%, late {:.1f}%, miss {:.1f}%.",
+		                      cnt.prefetch_issued, cnt.prefetch_cancelled,
+		                      rate(cnt.prefetch_hits), rate(cnt.prefetch_late), rate(cnt.demand_misses)));
+	}
+}